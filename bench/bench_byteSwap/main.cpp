@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <vector>
+#include "cppsl/byteSwap.hpp"
+
+using namespace cppsl;
+
+namespace {
+
+/// swaps a buffer of state.range(0) values in place, bytes_per_second counts the buffer
+template <typename T>
+void BM_SwapBuffer(benchmark::State& state) {
+  std::vector<T> data(static_cast<size_t>(state.range(0)));
+  std::iota(data.begin(), data.end(), T{1});
+  for (auto _ : state) {
+    ByteSwapper::SwapBuffer<ByteSwapper::SwapType::AX>(std::span<T>(data));
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size() * sizeof(T)));
+}
+BENCHMARK_TEMPLATE(BM_SwapBuffer, uint16_t)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_SwapBuffer, uint32_t)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_SwapBuffer, uint64_t)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_SwapBuffer, float)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_SwapBuffer, double)->Range(64, 64 << 10);
+
+/// copies a received frame into host order, the swap type known at run time only
+template <typename T>
+void BM_CopySwap(benchmark::State& state) {
+  std::vector<T> src(static_cast<size_t>(state.range(0)));
+  std::vector<T> dst(src.size());
+  std::iota(src.begin(), src.end(), T{1});
+  auto swapType = ByteSwapper::SwapType::AX;
+  benchmark::DoNotOptimize(swapType);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ByteSwapper::CopySwap(std::span<const T>(src), std::span<T>(dst), swapType));
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * src.size() * sizeof(T)));
+}
+BENCHMARK_TEMPLATE(BM_CopySwap, uint16_t)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_CopySwap, uint32_t)->Range(64, 64 << 10);
+BENCHMARK_TEMPLATE(BM_CopySwap, uint64_t)->Range(64, 64 << 10);
+
+/// one value at a time, the baseline of the bulk functions
+void BM_SwapScalar(benchmark::State& state) {
+  std::vector<uint32_t> data(static_cast<size_t>(state.range(0)));
+  std::iota(data.begin(), data.end(), 1u);
+  for (auto _ : state) {
+    for (auto& v : data) {
+      v = ByteSwapper::Swap(v, ByteSwapper::SwapType::AX);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * data.size() * sizeof(uint32_t)));
+}
+BENCHMARK(BM_SwapScalar)->Range(64, 64 << 10);
+
+}   // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,158 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include "cppsl/container/circularBuffer.hpp"
+#include "cppsl/container/dequeSafe.hpp"
+#include "cppsl/container/listSafe.hpp"
+#include "cppsl/container/queueLockFree.hpp"
+#include "cppsl/container/queueSafe.hpp"
+#include "cppsl/thread/details/eventCount.hpp"
+#include "cppsl/time/latency.hpp"
+
+using namespace cppsl::container;
+using cppsl::time::CycleClockSource;
+using cppsl::time::LatencyRecorder;
+
+namespace {
+
+constexpr size_t capacity = 1024;
+
+/// busy waits, gives the CPU away after a while for boards with few cores
+void relax(unsigned& spins) {
+  if (++spins < cppsl::thread::details::spinCount) {
+    cppsl::thread::details::cpuRelax();
+  } else {
+    std::this_thread::yield();
+  }
+}
+
+/// adapters to one push and pop interface, the items carry the cycle counter of the push
+struct CircularBufferOps {
+  using Container = CircularBuffer<uint64_t>;
+  static std::unique_ptr<Container> create() { return std::make_unique<Container>(capacity); }
+  static void push(Container& c, uint64_t v) {
+    for (unsigned spins = 0; !c.push(v);) {
+      relax(spins);
+    }
+  }
+  static uint64_t pop(Container& c) {
+    uint64_t v;
+    for (unsigned spins = 0; !c.pop(v);) {
+      relax(spins);
+    }
+    return v;
+  }
+};
+
+struct QueueLockFreeOps {
+  using Container = QueueLockFree<uint64_t>;
+  static std::unique_ptr<Container> create() { return std::make_unique<Container>(); }
+  static void push(Container& c, uint64_t v) { c.push(v); }
+  static uint64_t pop(Container& c) {
+    std::shared_ptr<uint64_t> v;
+    for (unsigned spins = 0; !(v = c.try_pop());) {
+      relax(spins);
+    }
+    return *v;
+  }
+};
+
+struct QueueSafeOps {
+  using Container = QueueSafe<uint64_t>;
+  static std::unique_ptr<Container> create() { return std::make_unique<Container>(capacity); }
+  static void push(Container& c, uint64_t v) { c.push(v); }
+  static uint64_t pop(Container& c) {
+    uint64_t v;
+    c.wait_and_pop(v);
+    return v;
+  }
+};
+
+struct DequeSafeOps {
+  using Container = DequeSafe<uint64_t>;
+  static std::unique_ptr<Container> create() { return std::make_unique<Container>(capacity); }
+  static void push(Container& c, uint64_t v) { c.push_back(v); }
+  static uint64_t pop(Container& c) {
+    uint64_t v;
+    c.wait_and_pop_front(v);
+    return v;
+  }
+};
+
+/// exports the percentiles of the push to pop latency
+void reportLatency(benchmark::State& state, const LatencyRecorder& recorder) {
+  const auto summary = recorder.Summary();
+  state.counters["p50_ns"] = static_cast<double>(summary.p50);
+  state.counters["p99_ns"] = static_cast<double>(summary.p99);
+  state.counters["p999_ns"] = static_cast<double>(summary.p999);
+  state.counters["max_ns"] = static_cast<double>(summary.max);
+}
+
+/**
+ * Even threads produce, odd threads consume; every thread runs the same number of
+ * iterations, so the pops match the pushes and nothing blocks at the end.
+ * items_per_second counts handed over items.
+ */
+template <class Ops>
+void BM_handoff(benchmark::State& state) {
+  static std::unique_ptr<typename Ops::Container> container;
+  static LatencyRecorder latency;
+  if (state.thread_index() == 0) {
+    container = Ops::create();
+    latency.Reset();
+    CycleClockSource::Calibrate();
+  }
+
+  const bool producer = (state.thread_index() & 1) == 0;
+  for (auto _ : state) {
+    if (producer) {
+      Ops::push(*container, CycleClockSource::Now());
+    } else {
+      const auto stamp = Ops::pop(*container);
+      latency.Record(CycleClockSource::ToNanoseconds(CycleClockSource::Now() - stamp));
+    }
+  }
+
+  if (producer) {
+    state.SetItemsProcessed(state.iterations());
+  }
+  if (state.thread_index() == 0) {
+    reportLatency(state, latency);
+  }
+}
+
+// the ring buffer and the unbounded lock-free queue take one producer and one consumer
+BENCHMARK_TEMPLATE(BM_handoff, CircularBufferOps)->Threads(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_handoff, QueueLockFreeOps)->Threads(2)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_handoff, QueueSafeOps)->ThreadRange(2, 16)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_handoff, DequeSafeOps)->ThreadRange(2, 16)->UseRealTime();
+
+/// every thread inserts its own value and removes it again, the list stays short
+void BM_ListSafe(benchmark::State& state) {
+  static std::unique_ptr<ListSafe<uint64_t>> list;
+  static LatencyRecorder latency;
+  if (state.thread_index() == 0) {
+    list = std::make_unique<ListSafe<uint64_t>>();
+    latency.Reset();
+    CycleClockSource::Calibrate();
+  }
+
+  const auto mine = static_cast<uint64_t>(state.thread_index());
+  for (auto _ : state) {
+    const auto start = CycleClockSource::Now();
+    list->push_front(mine);
+    list->remove_if([mine](const uint64_t& v) { return v == mine; });
+    latency.Record(CycleClockSource::ToNanoseconds(CycleClockSource::Now() - start));
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    reportLatency(state, latency);
+  }
+}
+BENCHMARK(BM_ListSafe)->ThreadRange(1, 16)->UseRealTime();
+
+}   // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <syslog.h>
+#include <unistd.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include "cppsl/file/fileAsyncAppender.hpp"
+#include "cppsl/file/fileMappedAppender.hpp"
+#include "cppsl/file/fileRollAppender.hpp"
+#include "cppsl/log/details/rsyslog_sink.hpp"
+#include "spdlog/spdlog.h"
+
+using namespace cppsl::file;
+
+namespace {
+
+constexpr size_t rollSize = 16 * 1024 * 1024;
+
+/// a line of a typical length
+const std::string message = "2024-Jun-10 12:00:00.000000 [info] decoder: frame 123456 accepted, 96 samples\n";
+
+/// temporary directory, removed at the end of the benchmark
+class TempDir {
+ public:
+  explicit TempDir(const std::string& name)
+      : m_path(std::filesystem::temp_directory_path() / ("cppsl_bench_" + name + "_" + std::to_string(getpid()))) {
+    std::filesystem::remove_all(m_path);
+    std::filesystem::create_directories(m_path);
+  }
+  ~TempDir() { std::filesystem::remove_all(m_path); }
+
+  [[nodiscard]] std::filesystem::path file(const std::string& name) const { return m_path / name; }
+
+ private:
+  std::filesystem::path m_path;
+};
+
+/// UDP socket on the loopback interface standing in for rsyslog, it never reads
+class UdpReceiver {
+ public:
+  UdpReceiver() {
+    m_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(m_fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    m_port = ntohs(addr.sin_port);
+  }
+  ~UdpReceiver() { close(m_fd); }
+
+  [[nodiscard]] uint16_t port() const { return m_port; }
+
+ private:
+  int m_fd{-1};
+  uint16_t m_port{0};
+};
+
+/// writes messages, items_per_second counts messages
+template <class Appender>
+void write(benchmark::State& state, Appender& appender) {
+  size_t failed = 0;
+  for (auto _ : state) {
+    failed += appender.writeMessage(message) ? 0 : 1;
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * message.size()));
+  state.counters["failed"] = static_cast<double>(failed);
+}
+
+void BM_FileRollAppender(benchmark::State& state) {
+  TempDir dir("roll");
+  FileRollAppender appender(dir.file("roll.log"), rollSize, 2, false);
+  write(state, appender);
+}
+BENCHMARK(BM_FileRollAppender);
+
+void BM_FileMappedAppender(benchmark::State& state) {
+  // shared by the threads and the runs, destroyed before the directory
+  static TempDir dir("mapped");
+  static FileMappedAppender appender(dir.file("mapped.log"), rollSize, 2, false);
+  write(state, appender);
+}
+BENCHMARK(BM_FileMappedAppender)->ThreadRange(1, 8)->UseRealTime();
+
+void BM_FileAsyncAppender(benchmark::State& state) {
+  TempDir dir("async");
+  FileAsyncAppender appender(std::make_shared<FileRollAppender>(dir.file("async.log"), rollSize, 2, false));
+  // measures the producer side, the writer thread drains the queue in the background
+  write(state, appender);
+}
+BENCHMARK(BM_FileAsyncAppender);
+
+/// logs through spdlog into rsyslog_sink, state.range(0) messages per datagram batch
+void BM_rsyslog_sink(benchmark::State& state) {
+  UdpReceiver server;
+  spdlog::sinks::rsyslog_batch_config batch;
+  batch.max_messages = static_cast<size_t>(state.range(0));
+  auto sink = std::make_shared<spdlog::sinks::rsyslog_sink_st>("bench", "127.0.0.1", LOG_USER, 1024, server.port(),
+                                                               false, batch);
+  spdlog::logger logger("bench", sink);
+
+  for (auto _ : state) {
+    logger.info("decoder: frame {} accepted, {} samples", 123456, 96);
+  }
+  logger.flush();
+  state.SetItemsProcessed(state.iterations());
+  state.counters["sent"] = static_cast<double>(sink->counters().sent);
+  state.counters["eagain"] = static_cast<double>(sink->counters().eagain);
+}
+BENCHMARK(BM_rsyslog_sink)->Arg(1)->Arg(16)->Arg(64);
+
+}   // namespace
+
+BENCHMARK_MAIN();
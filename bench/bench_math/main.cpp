@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "cppsl/math/samplRateConvFIR.hpp"
+#include "cppsl/math/samplRateConvLagrange.hpp"
+#include "cppsl/math/samplRateConvLinear.hpp"
+
+using namespace cppsl::math;
+
+namespace {
+
+constexpr size_t blockSize = 4800;
+
+template <typename T>
+std::vector<T> sine() {
+  std::vector<T> samples(blockSize);
+  for (size_t i = 0; i < samples.size(); ++i) {
+    samples[i] = static_cast<T>(20000.0 * std::sin(2.0 * M_PI * 50.0 * static_cast<double>(i) / 4800.0));
+  }
+  return samples;
+}
+
+/// converts blocks of 4800 input samples, items_per_second counts input samples
+template <class Converter>
+void convert(benchmark::State& state, Converter& conv) {
+  using T = typename Converter::sample_type;
+  const auto in = sine<T>();
+  std::vector<T> out(conv.maxOutputFor(in.size()) * 2 + 16);
+  for (auto _ : state) {
+    const auto res = conv.Convert(std::span<const T>(in), std::span<T>(out));
+    benchmark::DoNotOptimize(out.data());
+    benchmark::DoNotOptimize(res);
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * in.size()));
+}
+
+// 4800 Hz to 10000 Hz and 4000 Hz, the rates of the math tests
+template <typename T>
+void BM_SmpRateConvLinear(benchmark::State& state) {
+  SmpRateConvLinear<T> conv(4800, static_cast<int>(state.range(0)));
+  convert(state, conv);
+}
+BENCHMARK_TEMPLATE(BM_SmpRateConvLinear, int)->Arg(10000)->Arg(4000);
+BENCHMARK_TEMPLATE(BM_SmpRateConvLinear, double)->Arg(10000)->Arg(4000);
+
+template <typename T>
+void BM_SmpRateConvLagrange(benchmark::State& state) {
+  SmpRateConvLagrange<T> conv(4800, static_cast<int>(state.range(0)), static_cast<unsigned char>(state.range(1)));
+  convert(state, conv);
+}
+BENCHMARK_TEMPLATE(BM_SmpRateConvLagrange, int)->Args({10000, 3})->Args({10000, 7});
+BENCHMARK_TEMPLATE(BM_SmpRateConvLagrange, double)->Args({10000, 3})->Args({10000, 7});
+
+template <typename T>
+void BM_SmpRateConvFIR(benchmark::State& state) {
+  SmpRateConvFIR<T> conv(4800, static_cast<int>(state.range(0)), 64, static_cast<unsigned char>(state.range(1)));
+  convert(state, conv);
+}
+BENCHMARK_TEMPLATE(BM_SmpRateConvFIR, int)->Args({10000, 16})->Args({4000, 7});
+BENCHMARK_TEMPLATE(BM_SmpRateConvFIR, double)->Args({10000, 16})->Args({4000, 7});
+
+}   // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "cppsl/time/functions.hpp"
+
+using namespace cppsl::time;
+using std::chrono::system_clock;
+
+namespace {
+
+/// consecutive time points 1 ms apart, like the samples of a record
+std::vector<system_clock::time_point> timePoints() {
+  std::vector<system_clock::time_point> points;
+  const auto start = system_clock::now();
+  for (int i = 0; i < 4096; ++i) {
+    points.push_back(start + std::chrono::milliseconds(i));
+  }
+  return points;
+}
+
+std::vector<std::string> texts() {
+  std::vector<std::string> result;
+  char buffer[timestampBufferSize];
+  for (const auto& tp : timePoints()) {
+    result.emplace_back(buffer, formatTimestamp<6>(buffer, tp));
+  }
+  return result;
+}
+
+void BM_toString(benchmark::State& state) {
+  const auto points = timePoints();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(toString<double, 6>(points[i++ & 4095]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_toString);
+
+void BM_formatTimestamp(benchmark::State& state) {
+  const auto points = timePoints();
+  char buffer[timestampBufferSize];
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(formatTimestamp<6>(buffer, points[i++ & 4095]));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_formatTimestamp);
+
+void BM_fromString(benchmark::State& state) {
+  const auto input = texts();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fromString<system_clock::time_point>(input[i++ & 4095]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_fromString);
+
+void BM_parseTimestamp(benchmark::State& state) {
+  const auto input = texts();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(parseTimestamp<system_clock::time_point>(input[i++ & 4095]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_parseTimestamp);
+
+}   // namespace
+
+BENCHMARK_MAIN();
@@ -17,9 +17,20 @@
 //-----------------------------------------------------------------------------
 // includes <...>
 //-----------------------------------------------------------------------------
+#include <algorithm>
 #include <bit>
 #include <cstdint>
 #include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 //----------------------------------------------------------------------------
 // Public Function Prototypes
@@ -33,6 +44,10 @@ namespace cppsl {
  *
  * This class provides a static method for swapping bytes in a value based on the endianness of the machine,
  * as well as an enum class for specifying the swap type.
+ *
+ * SwapBuffer and CopySwap convert whole arrays, e.g. the int32 values and quality words of an SV frame,
+ * with SSSE3 pshufb or NEON vrev kernels and bswap builtins for the tail. The overloads taking SwapType
+ * as template argument decide at compile time whether anything is swapped.
  */
 class ByteSwapper {
  public:
@@ -70,6 +85,124 @@ class ByteSwapper {
     return ret;
   }
 
+  /**
+   * @brief Checks at compile time whether a swap type swaps on this machine
+   * @tparam S The swap type.
+   * @return true if the bytes are reversed.
+   */
+  template <SwapType S>
+  static constexpr bool Swaps() {
+    if constexpr (S == SwapType::AX) {
+      return true;
+    } else if constexpr (S == SwapType::BE) {
+      return std::endian::native == std::endian::big;
+    } else if constexpr (S == SwapType::LE) {
+      return std::endian::native == std::endian::little;
+    } else {
+      return false;
+    }
+  }
+
+  /**
+   * @brief Swaps the bytes of a value, the swap type is resolved at compile time
+   * @tparam S The swap type.
+   * @param val The value.
+   * @return The swapped value.
+   */
+  template <SwapType S, typename T>
+  static T Swap(T val) {
+    if constexpr (Swaps<S>()) {
+      return Reverse(val);
+    } else {
+      return val;
+    }
+  }
+
+  /**
+   * @brief Reverses the bytes of a value with the bswap builtins
+   * @param val The value, 1, 2, 4 or 8 bytes use the builtins, other sizes SwapBytes.
+   * @return The value with reversed bytes.
+   */
+  template <typename T>
+  static T Reverse(T val) {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    if constexpr (sizeof(T) == 1) {
+      return val;
+    } else if constexpr (sizeof(T) == 2) {
+      return std::bit_cast<T>(__builtin_bswap16(std::bit_cast<uint16_t>(val)));
+    } else if constexpr (sizeof(T) == 4) {
+      return std::bit_cast<T>(__builtin_bswap32(std::bit_cast<uint32_t>(val)));
+    } else if constexpr (sizeof(T) == 8) {
+      return std::bit_cast<T>(__builtin_bswap64(std::bit_cast<uint64_t>(val)));
+    } else {
+      T ret = val;
+      SwapBytes(reinterpret_cast<uint8_t*>(&ret), sizeof(T));
+      return ret;
+    }
+  }
+
+  /**
+   * @brief Swaps all values of a buffer in place
+   * @param data The values.
+   * @param swapType The swap type.
+   */
+  template <typename T>
+  static void SwapBuffer(std::span<T> data, SwapType swapType) {
+    if (IsSwapping(swapType)) {
+      ReverseArray(data.data(), data.data(), data.size());
+    }
+  }
+
+  /**
+   * @brief Swaps all values of a buffer in place, the swap type is resolved at compile time
+   * @tparam S The swap type.
+   * @param data The values.
+   */
+  template <SwapType S, typename T>
+  static void SwapBuffer(std::span<T> data) {
+    if constexpr (Swaps<S>()) {
+      ReverseArray(data.data(), data.data(), data.size());
+    }
+  }
+
+  /**
+   * @brief Copies values and swaps them on the way, e.g. out of a received frame
+   * @param src The source values.
+   * @param dst The destination, may overlap src.
+   * @param swapType The swap type.
+   * @return The number of copied values, the smaller size.
+   */
+  template <typename T>
+  static size_t CopySwap(std::span<const T> src, std::span<T> dst, SwapType swapType) {
+    const size_t count = std::min(src.size(), dst.size());
+    if (IsSwapping(swapType)) {
+      CopyReverse(src.data(), dst.data(), count);
+    } else if (count > 0 && src.data() != dst.data()) {
+      std::memmove(dst.data(), src.data(), count * sizeof(T));
+    }
+    return count;
+  }
+
+  /**
+   * @brief Copies values and swaps them on the way, the swap type is resolved at compile time
+   * @tparam S The swap type.
+   * @param src The source values.
+   * @param dst The destination, may overlap src.
+   * @return The number of copied values, the smaller size.
+   */
+  template <SwapType S, typename T>
+  static size_t CopySwap(std::span<const T> src, std::span<T> dst) {
+    const size_t count = std::min(src.size(), dst.size());
+    if constexpr (Swaps<S>()) {
+      CopyReverse(src.data(), dst.data(), count);
+    } else {
+      if (count > 0 && src.data() != dst.data()) {
+        std::memmove(dst.data(), src.data(), count * sizeof(T));
+      }
+    }
+    return count;
+  }
+
   /**
    * @fn swapBytes
    * @brief A helper method to swap bytes
@@ -86,6 +219,93 @@ class ByteSwapper {
       std::swap(ptr[i], ptr[size - i - 1]);
     }
   }
+
+ private:
+  /**
+   * @brief Resolves a swap type at run time
+   * @param swapType The swap type.
+   * @return true if the bytes are reversed on this machine.
+   */
+  static bool IsSwapping(SwapType swapType) {
+    switch (swapType) {
+      case SwapType::BE:
+        return Swaps<SwapType::BE>();
+      case SwapType::LE:
+        return Swaps<SwapType::LE>();
+      case SwapType::AX:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  /**
+   * @brief Copies and reverses the bytes of every value, for any overlap of the buffers
+   * @param src The source values.
+   * @param dst The destination.
+   * @param count The number of values.
+   */
+  template <typename T>
+  static void CopyReverse(const T* src, T* dst, size_t count) {
+    const auto from = reinterpret_cast<uintptr_t>(src);
+    const auto to = reinterpret_cast<uintptr_t>(dst);
+    const auto bytes = count * sizeof(T);
+    if (from != to && from < to + bytes && to < from + bytes) {
+      // the kernel needs identical or disjoint buffers, a partial overlap is moved first
+      std::memmove(dst, src, bytes);
+      ReverseArray(dst, dst, count);
+    } else {
+      ReverseArray(src, dst, count);
+    }
+  }
+
+  /**
+   * @brief Reverses the bytes of every value, 16 bytes per vector step
+   * @param src The source values.
+   * @param dst The destination, equal to src or not overlapping.
+   * @param count The number of values.
+   */
+  template <typename T>
+  static void ReverseArray(const T* src, T* dst, size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+    size_t i = 0;
+    if constexpr (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8) {
+      constexpr size_t perVector = 16 / sizeof(T);
+      const auto* in = reinterpret_cast<const uint8_t*>(src);
+      auto* out = reinterpret_cast<uint8_t*>(dst);
+#if defined(__SSSE3__)
+      constexpr size_t s = sizeof(T);
+      // byte j of the result is byte (j / s) * s + s - 1 - j % s of the source
+      alignas(16) uint8_t order[16];
+      for (size_t j = 0; j < 16; ++j) {
+        order[j] = static_cast<uint8_t>((j / s) * s + s - 1 - j % s);
+      }
+      const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(order));
+      for (; i + perVector <= count; i += perVector) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * sizeof(T)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * sizeof(T)), _mm_shuffle_epi8(v, shuffle));
+      }
+#elif defined(__ARM_NEON)
+      for (; i + perVector <= count; i += perVector) {
+        const uint8x16_t v = vld1q_u8(in + i * sizeof(T));
+        if constexpr (sizeof(T) == 2) {
+          vst1q_u8(out + i * sizeof(T), vrev16q_u8(v));
+        } else if constexpr (sizeof(T) == 4) {
+          vst1q_u8(out + i * sizeof(T), vrev32q_u8(v));
+        } else {
+          vst1q_u8(out + i * sizeof(T), vrev64q_u8(v));
+        }
+      }
+#else
+      (void)perVector;
+      (void)in;
+      (void)out;
+#endif
+    }
+    for (; i < count; ++i) {
+      dst[i] = Reverse(src[i]);
+    }
+  }
 };
 
 }   // namespace cppsl
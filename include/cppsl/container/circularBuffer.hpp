@@ -9,11 +9,28 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace cppsl::container {
 
+/// Capacity argument of CircularBuffer selecting the size given at runtime.
+inline constexpr size_t dynamicCapacity = 0;
+
+/**
+ * @brief Circular buffer with the capacity N given at compile time and inline storage.
+ * @tparam T The type of items stored in the buffer.
+ * @tparam N The capacity, a power of 2, or dynamicCapacity for a runtime sized buffer.
+ */
+template <typename T, size_t N = dynamicCapacity>
+class CircularBuffer;
+
 template <typename T>
 /**
  * @brief A thread-safe circular buffer implementation.
@@ -29,7 +46,7 @@ template <typename T>
  * @param size The size of the circular buffer. Must be a power of 2.
  * @throws std::invalid_argument if the size is not a power of 2.
  */
-class CircularBuffer {
+class CircularBuffer<T, dynamicCapacity> {
   const size_t m_capacity;            ///< The size of the circular buffer.
   std::vector<T> m_buffer;            ///< The buffer storing the items.
   std::atomic<size_t> m_readIndex;    ///< The read index for the circular buffer.
@@ -160,4 +177,164 @@ class CircularBuffer {
   [[nodiscard]] size_t increment(size_t index) const { return (index + 1) & (m_capacity - 1); }
 };
 
+template <typename T, size_t N>
+/**
+ * @brief A thread-safe circular buffer with compile-time capacity and inline storage.
+ *
+ * Same single producer / single consumer protocol as the runtime sized CircularBuffer, but
+ * the items live in an inline array and the index mask is a constant. The object does not
+ * allocate and can be placed in shared memory or a static arena. The slots are raw storage,
+ * items are constructed on push and destroyed on pop, so T need not be default-constructible.
+ *
+ * As for the runtime sized buffer one slot stays free, the buffer holds up to N - 1 items.
+ *
+ * @tparam T The type of items stored in the buffer.
+ * @tparam N The capacity of the buffer, a power of 2.
+ */
+class CircularBuffer {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "Capacity must be a power of 2");
+
+  static constexpr size_t m_mask = N - 1;   ///< index mask
+
+  /// raw storage of one item
+  struct slot {
+    alignas(T) std::byte m_data[sizeof(T)];
+  };
+
+  std::array<slot, N> m_buffer;          ///< The buffer storing the items.
+  std::atomic<size_t> m_readIndex{0};    ///< The read index for the circular buffer.
+  std::atomic<size_t> m_writeIndex{0};   ///< The write index for the circular buffer.
+
+ public:
+  /**
+   * @brief Constructor: the buffer is empty, no item is constructed.
+   */
+  CircularBuffer() = default;
+
+  /**
+   * @brief Destructor: destroys the items still in the buffer.
+   */
+  ~CircularBuffer() { clear(); }
+
+  CircularBuffer(const CircularBuffer&) = delete;
+  CircularBuffer& operator=(const CircularBuffer&) = delete;
+
+  /**
+   * @brief Adds a copy of an item to the buffer.
+   * @param item The item to be added to the circular buffer.
+   * @return true if the item was successfully added to the buffer, false if the buffer is full.
+   */
+  [[nodiscard]] bool push(const T& item) { return emplace(item); }
+
+  /**
+   * @brief Moves an item into the buffer.
+   * @param item The item to be added to the circular buffer.
+   * @return true if the item was successfully added to the buffer, false if the buffer is full.
+   */
+  [[nodiscard]] bool push(T&& item) { return emplace(std::move(item)); }
+
+  /**
+   * @brief Constructs an item in place at the end of the buffer.
+   * @param args Arguments forwarded to the constructor of T.
+   * @return true if the item was successfully added to the buffer, false if the buffer is full.
+   */
+  template <typename... Args>
+  [[nodiscard]] bool emplace(Args&&... args) {
+    auto currentWrite = m_writeIndex.load(std::memory_order_relaxed);
+    auto nextWrite = increment(currentWrite);
+
+    if (nextWrite == m_readIndex.load(std::memory_order_acquire)) {
+      // Buffer is full
+      return false;
+    }
+
+    ::new (static_cast<void*>(m_buffer[currentWrite].m_data)) T(std::forward<Args>(args)...);
+    m_writeIndex.store(nextWrite, std::memory_order_release);
+
+    return true;
+  }
+
+  /**
+   * @brief Moves the next item out of the circular buffer.
+   * @param item A reference to the variable where the popped item will be stored.
+   * @return true if an item was successfully popped from the buffer, false if the buffer is empty.
+   */
+  [[nodiscard]] bool pop(T& item) {
+    auto currentRead = m_readIndex.load(std::memory_order_relaxed);
+
+    if (currentRead == m_writeIndex.load(std::memory_order_acquire)) {
+      // Buffer is empty
+      return false;
+    }
+
+    T* stored = at(currentRead);
+    item = std::move(*stored);
+    stored->~T();
+    m_readIndex.store(increment(currentRead), std::memory_order_release);
+
+    return true;
+  }
+
+  /**
+   * @brief Destroys the items in the buffer. Must not run concurrently with push or pop.
+   */
+  void clear() {
+    auto currentRead = m_readIndex.load(std::memory_order_relaxed);
+    const auto currentWrite = m_writeIndex.load(std::memory_order_acquire);
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (; currentRead != currentWrite; currentRead = increment(currentRead)) {
+        at(currentRead)->~T();
+      }
+    }
+    m_readIndex.store(currentWrite, std::memory_order_release);
+  }
+
+  /**
+   * @brief Checks if the circular buffer is empty.
+   * @return true if the circular buffer is empty, false otherwise.
+   */
+  [[nodiscard]] bool empty() const {
+    return m_readIndex.load(std::memory_order_acquire) == m_writeIndex.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Checks if the circular buffer is full.
+   * @return true if the circular buffer is full, false otherwise.
+   */
+  [[nodiscard]] bool full() const {
+    return increment(m_writeIndex.load(std::memory_order_acquire)) == m_readIndex.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Returns the capacity of the circular buffer.
+   * @return The capacity of the circular buffer.
+   */
+  [[nodiscard]] static constexpr size_t capacity() { return N; }
+
+  /**
+   * @brief Returns the number of items currently in the circular buffer.
+   * @return The number of items currently in the circular buffer.
+   */
+  [[nodiscard]] size_t size() const {
+    auto currentWrite = m_writeIndex.load(std::memory_order_acquire);
+    auto currentRead = m_readIndex.load(std::memory_order_acquire);
+    return (currentWrite - currentRead + N) & m_mask;
+  }
+
+ private:
+  /**
+   * @brief Returns the item stored in the slot.
+   * @param index The index of the slot.
+   * @return A pointer to the item.
+   */
+  T* at(size_t index) { return std::launder(reinterpret_cast<T*>(m_buffer[index].m_data)); }
+
+  /**
+   * @brief Increments the given index by 1 and applies the constant mask.
+   * @param index The index to be incremented.
+   * @return The incremented index within the circular buffer.
+   */
+  [[nodiscard]] static constexpr size_t increment(size_t index) { return (index + 1) & m_mask; }
+};
+
 }   // namespace cppsl::container
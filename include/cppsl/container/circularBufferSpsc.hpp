@@ -0,0 +1,277 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <cppsl/container/details/cacheLine.hpp>
+
+namespace cppsl::container {
+
+template <typename T>
+/**
+ * @brief A single producer / single consumer circular buffer with batch operations.
+ *
+ * Variant of CircularBuffer for high rate streams. The producer and the consumer index
+ * are placed in separate cache lines, and each side keeps a local copy of the index of
+ * the other side, so the shared line is only read when the cached value says the buffer
+ * is full (producer) or empty (consumer). Blocks of items are published with a single
+ * release store, either by copying (push_n/pop_n) or in place (write_prepare/write_commit
+ * and read_peek/read_release).
+ *
+ * The indices run freely and are masked on access, so all slots of the buffer are usable.
+ *
+ * @tparam T The type of items stored in the buffer.
+ */
+class CircularBufferSpsc {
+  // producer side
+  alignas(details::cacheLineSize) std::atomic<size_t> m_writeIndex{0};   ///< The write index, written by the producer.
+  size_t m_readIndexCache{0};                                            ///< The producer's copy of the read index.
+
+  // consumer side
+  alignas(details::cacheLineSize) std::atomic<size_t> m_readIndex{0};   ///< The read index, written by the consumer.
+  size_t m_writeIndexCache{0};                                          ///< The consumer's copy of the write index.
+
+  // shared read-only
+  alignas(details::cacheLineSize) const size_t m_capacity;   ///< The size of the circular buffer.
+  const size_t m_mask;                                       ///< m_capacity - 1
+  std::vector<T> m_buffer;                                   ///< The buffer storing the items.
+
+ public:
+  /**
+   * @brief Constructor: Rounds the size up to a power of 2 and initializes the buffer.
+   * @param size The size of the circular buffer.
+   * @throws std::invalid_argument if the size is 0.
+   */
+  explicit CircularBufferSpsc(size_t size = 16)
+      : m_capacity(nextPowerOf2(size)), m_mask(m_capacity - 1), m_buffer(m_capacity) {
+    if (size == 0) {
+      throw std::invalid_argument("Size must not be 0");
+    }
+  }
+
+  CircularBufferSpsc(const CircularBufferSpsc&) = delete;
+  CircularBufferSpsc& operator=(const CircularBufferSpsc&) = delete;
+
+  /**
+   * @brief Adds an item to the buffer. Producer only.
+   * @param item The item to be added to the circular buffer.
+   * @return true if the item was successfully added to the buffer, false if the buffer is full.
+   */
+  [[nodiscard]] bool push(const T& item) { return emplace(item); }
+
+  /**
+   * @brief Moves an item into the buffer. Producer only.
+   * @param item The item to be added to the circular buffer.
+   * @return true if the item was successfully added to the buffer, false if the buffer is full.
+   */
+  [[nodiscard]] bool push(T&& item) { return emplace(std::move(item)); }
+
+  /**
+   * @brief Removes the next item from the circular buffer. Consumer only.
+   * @param item A reference to the variable where the popped item will be moved.
+   * @return true if an item was successfully popped from the buffer, false if the buffer is empty.
+   */
+  [[nodiscard]] bool pop(T& item) {
+    const auto currentRead = m_readIndex.load(std::memory_order_relaxed);
+    if (readAvailable(currentRead, 1) == 0) {
+      // Buffer is empty
+      return false;
+    }
+    item = std::move(m_buffer[currentRead & m_mask]);
+    m_readIndex.store(currentRead + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Copies as many items of the block as fit into the buffer and publishes them at once. Producer only.
+   * @param items The items to be added.
+   * @return The number of items added, less than items.size() if the buffer became full.
+   */
+  size_t push_n(std::span<const T> items) {
+    const auto currentWrite = m_writeIndex.load(std::memory_order_relaxed);
+    const auto count = std::min(items.size(), writeAvailable(currentWrite, items.size()));
+    const auto offset = currentWrite & m_mask;
+    const auto first = std::min(count, m_capacity - offset);
+    std::copy_n(items.begin(), first, m_buffer.begin() + offset);
+    std::copy_n(items.begin() + first, count - first, m_buffer.begin());
+    m_writeIndex.store(currentWrite + count, std::memory_order_release);
+    return count;
+  }
+
+  /**
+   * @brief Moves up to items.size() items out of the buffer and releases their slots at once. Consumer only.
+   * @param items The destination of the popped items.
+   * @return The number of items popped.
+   */
+  size_t pop_n(std::span<T> items) {
+    const auto currentRead = m_readIndex.load(std::memory_order_relaxed);
+    const auto count = std::min(items.size(), readAvailable(currentRead, items.size()));
+    const auto offset = currentRead & m_mask;
+    const auto first = std::min(count, m_capacity - offset);
+    std::move(m_buffer.begin() + offset, m_buffer.begin() + offset + first, items.begin());
+    std::move(m_buffer.begin(), m_buffer.begin() + (count - first), items.begin() + first);
+    m_readIndex.store(currentRead + count, std::memory_order_release);
+    return count;
+  }
+
+  /**
+   * @brief Returns the contiguous free region that follows the write index. Producer only.
+   *
+   * The region may be shorter than requested when the buffer is nearly full or the region
+   * reaches the end of the storage. The items become visible to the consumer with write_commit().
+   *
+   * @param count The number of items the producer wants to write.
+   * @return The writable region, empty if the buffer is full.
+   */
+  [[nodiscard]] std::span<T> write_prepare(size_t count) {
+    const auto currentWrite = m_writeIndex.load(std::memory_order_relaxed);
+    const auto offset = currentWrite & m_mask;
+    const auto length = std::min({count, writeAvailable(currentWrite, count), m_capacity - offset});
+    return {m_buffer.data() + offset, length};
+  }
+
+  /**
+   * @brief Publishes items written into the region returned by write_prepare(). Producer only.
+   * @param count The number of items written, at most the size of the prepared region.
+   */
+  void write_commit(size_t count) {
+    m_writeIndex.store(m_writeIndex.load(std::memory_order_relaxed) + count, std::memory_order_release);
+  }
+
+  /**
+   * @brief Returns the contiguous readable region that follows the read index. Consumer only.
+   *
+   * The region may be shorter than requested when fewer items are available or the region
+   * reaches the end of the storage. The slots are handed back to the producer with read_release().
+   *
+   * @param count The maximal number of items the consumer wants to read.
+   * @return The readable region, empty if the buffer is empty.
+   */
+  [[nodiscard]] std::span<T> read_peek(size_t count = static_cast<size_t>(-1)) {
+    const auto currentRead = m_readIndex.load(std::memory_order_relaxed);
+    const auto offset = currentRead & m_mask;
+    const auto length = std::min({count, readAvailable(currentRead, count), m_capacity - offset});
+    return {m_buffer.data() + offset, length};
+  }
+
+  /**
+   * @brief Releases items of the region returned by read_peek(). Consumer only.
+   * @param count The number of items consumed, at most the size of the peeked region.
+   */
+  void read_release(size_t count) {
+    m_readIndex.store(m_readIndex.load(std::memory_order_relaxed) + count, std::memory_order_release);
+  }
+
+  /**
+   * @brief Clears the circular buffer. Must not run concurrently with the producer or the consumer.
+   */
+  void clear() {
+    m_readIndex.store(0, std::memory_order_release);
+    m_writeIndex.store(0, std::memory_order_release);
+    m_readIndexCache = m_writeIndexCache = 0;
+  }
+
+  /**
+   * @brief Checks if the circular buffer is empty.
+   * @return true if the circular buffer is empty, false otherwise.
+   */
+  [[nodiscard]] bool empty() const { return size() == 0; }
+
+  /**
+   * @brief Checks if the circular buffer is full.
+   * @return true if the circular buffer is full, false otherwise.
+   */
+  [[nodiscard]] bool full() const { return size() == m_capacity; }
+
+  /**
+   * @brief Returns the capacity of the circular buffer.
+   * @return The capacity of the circular buffer.
+   */
+  [[nodiscard]] size_t capacity() const { return m_capacity; }
+
+  /**
+   * @brief Returns the number of items currently in the circular buffer.
+   * @return The number of items currently in the circular buffer.
+   */
+  [[nodiscard]] size_t size() const {
+    const auto currentRead = m_readIndex.load(std::memory_order_acquire);
+    const auto currentWrite = m_writeIndex.load(std::memory_order_acquire);
+    return currentWrite - currentRead;
+  }
+
+ private:
+  /**
+   * @brief Constructs an item in the next free slot and publishes it. Producer only.
+   * @param item The value to be assigned to the slot.
+   * @return true if the item was added, false if the buffer is full.
+   */
+  template <typename U>
+  bool emplace(U&& item) {
+    const auto currentWrite = m_writeIndex.load(std::memory_order_relaxed);
+    if (writeAvailable(currentWrite, 1) == 0) {
+      // Buffer is full
+      return false;
+    }
+    m_buffer[currentWrite & m_mask] = std::forward<U>(item);
+    m_writeIndex.store(currentWrite + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Free slots seen by the producer. Reloads the read index only if the cached one is not enough.
+   * @param currentWrite The current write index.
+   * @param wanted The number of slots the producer wants.
+   * @return The number of free slots.
+   */
+  size_t writeAvailable(size_t currentWrite, size_t wanted) {
+    auto available = m_capacity - (currentWrite - m_readIndexCache);
+    if (available < wanted) {
+      m_readIndexCache = m_readIndex.load(std::memory_order_acquire);
+      available = m_capacity - (currentWrite - m_readIndexCache);
+    }
+    return available;
+  }
+
+  /**
+   * @brief Items seen by the consumer. Reloads the write index only if the cached one is not enough.
+   * @param currentRead The current read index.
+   * @param wanted The number of items the consumer wants.
+   * @return The number of readable items.
+   */
+  size_t readAvailable(size_t currentRead, size_t wanted) {
+    auto available = m_writeIndexCache - currentRead;
+    if (available < wanted) {
+      m_writeIndexCache = m_writeIndex.load(std::memory_order_acquire);
+      available = m_writeIndexCache - currentRead;
+    }
+    return available;
+  }
+
+  /**
+   * @brief Determines the next power of 2 for a given number.
+   * @param num The number to find the next power of 2 for.
+   * @return The next power of 2 for the given number.
+   */
+  static size_t nextPowerOf2(size_t num) {
+    size_t res = 1;
+    while (res < num) {
+      res <<= 1;
+    }
+    return res;
+  }
+};
+
+}   // namespace cppsl::container
@@ -21,10 +21,18 @@
 // includes
 //-----------------------------------------------------------------------------
 
+#include <algorithm>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <stop_token>
+#include <utility>
+
+#include <cppsl/container/details/consumerWaiters.hpp>
+#include <cppsl/container/overflowPolicy.hpp>
 
 //----------------------------------------------------------------------------
 // Public Prototypes
@@ -41,22 +49,61 @@ namespace cppsl::container {
  * without causing any data race. It uses a mutex and condition variable to ensure
  * synchronized access to the underlying deque.
  *
+ * Blocking pops can be bounded by a timeout and interrupted by a std::stop_token.
+ * Batch pops wait until a minimum number of elements is queued, producers wake
+ * such a consumer only once the batch is complete.
+ *
+ * The deque may be bounded. A push into a full deque then follows the OverflowPolicy,
+ * dropOldest discards the element at the end opposite to the insertion. Blocked
+ * producers wait on a second condition variable that consumers signal only while a
+ * producer is blocked.
+ *
  * @tparam T The type of elements stored in the deque.
- * @tparam TAlloc The allocator type for element construction, defaults to std::allocator<T>.
+ * @tparam TAlloc The allocator of the underlying std::deque, defaults to std::allocator<T>.
+ * cppsl::memory::PoolAllocator keeps its block allocations off the global heap.
  */
 template <typename T, class TAlloc = std::allocator<T>>
 class DequeSafe {
 
   mutable std::mutex m_semaphore;
-  std::condition_variable m_condition;
-  std::deque<T> m_container;
+  std::condition_variable_any m_condition;
+  std::condition_variable_any m_notFull;
+  details::ConsumerWaiters m_waiters;
+  std::deque<T, TAlloc> m_container;
+  size_t m_capacity{unboundedCapacity};
+  OverflowPolicy m_policy{OverflowPolicy::block};
+  size_t m_blockedProducers{0};
+  OverflowCounters m_counters;
 
  public:
   /**
-    * @brief Default constructor for the DequeSafe class.
+    * @brief Default constructor for the DequeSafe class. The deque is unbounded.
     */
   DequeSafe() = default;
 
+  /**
+   * @brief Constructs a bounded deque.
+   * @param capacity The maximal number of elements, or unboundedCapacity.
+   * @param policy What a push does when the deque is full.
+   */
+  explicit DequeSafe(size_t capacity, OverflowPolicy policy = OverflowPolicy::block)
+      : m_capacity(capacity), m_policy(policy) {}
+
+  /**
+   * @brief Constructs an unbounded deque using the given allocator.
+   * @param alloc The allocator of the underlying deque.
+   */
+  explicit DequeSafe(const TAlloc& alloc) : m_container(alloc) {}
+
+  /**
+   * @brief Constructs a bounded deque using the given allocator.
+   * @param capacity The maximal number of elements, or unboundedCapacity.
+   * @param policy What a push does when the deque is full.
+   * @param alloc The allocator of the underlying deque.
+   */
+  DequeSafe(size_t capacity, OverflowPolicy policy, const TAlloc& alloc)
+      : m_container(alloc), m_capacity(capacity), m_policy(policy) {}
+
   /**
    * @brief Constructs a DequeSafe object by copying the contents of another DequeSafe object.
    * @param other The DequeSafe object to copy from.
@@ -64,6 +111,8 @@ class DequeSafe {
   DequeSafe(DequeSafe const& other) {
     std::lock_guard lk(other.m_semaphore);
     m_container = other.m_container;
+    m_capacity = other.m_capacity;
+    m_policy = other.m_policy;
   }
 
   /**
@@ -71,29 +120,78 @@ class DequeSafe {
     */
   void clear() {
     std::lock_guard lk(m_semaphore);
+    released(m_container.size());
     m_container.clear();
   }
 
   /**
-    * @brief Adds a new element to the front of the deque container.
+    * @brief Adds a copy of a new element to the front of the deque container.
     * @tparam T The type of elements stored in the deque.
     * @param new_value The value to be added to the deque.
+    * @return True if the value was inserted, false if it was dropped or rejected by the overflow policy.
     */
-  void push_front(T new_value) {
-    std::lock_guard lk(m_semaphore);
-    m_container.push_front(new_value);
-    m_condition.notify_one();
-  }
+  bool push_front(const T& new_value) { return insert<true>({}, new_value); }
 
   /**
-   * @brief Adds a new element to the end of the deque container.
+    * @brief Moves a new element to the front of the deque container.
+    * @tparam T The type of elements stored in the deque.
+    * @param new_value The value to be added to the deque.
+    * @return True if the value was inserted, false if it was dropped or rejected by the overflow policy.
+    */
+  bool push_front(T&& new_value) { return insert<true>({}, std::move(new_value)); }
+
+  /**
+   * @brief Adds a copy of a new element to the end of the deque container.
    * @tparam T The type of elements stored in the deque.
    * @param new_value The value to be added to the deque.
+   * @return True if the value was inserted, false if it was dropped or rejected by the overflow policy.
    */
-  void push_back(T new_value) {
-    std::lock_guard lk(m_semaphore);
-    m_container.push_back(new_value);
-    m_condition.notify_one();
+  bool push_back(const T& new_value) { return insert<false>({}, new_value); }
+
+  /**
+   * @brief Moves a new element to the end of the deque container.
+   * @tparam T The type of elements stored in the deque.
+   * @param new_value The value to be added to the deque.
+   * @return True if the value was inserted, false if it was dropped or rejected by the overflow policy.
+   */
+  bool push_back(T&& new_value) { return insert<false>({}, std::move(new_value)); }
+
+  /**
+   * @brief Adds a copy of a new element to the end, a producer blocked on a full deque gives up on stop.
+   * @param new_value The value to be added to the deque.
+   * @param stoken The stop token interrupting a blocked push.
+   * @return True if the value was inserted, false if it was dropped, rejected or the wait was stopped.
+   */
+  bool push_back(const T& new_value, std::stop_token stoken) { return insert<false>(std::move(stoken), new_value); }
+
+  /**
+   * @brief Moves a new element to the end, a producer blocked on a full deque gives up on stop.
+   * @param new_value The value to be added to the deque.
+   * @param stoken The stop token interrupting a blocked push.
+   * @return True if the value was inserted, false if it was dropped, rejected or the wait was stopped.
+   */
+  bool push_back(T&& new_value, std::stop_token stoken) {
+    return insert<false>(std::move(stoken), std::move(new_value));
+  }
+
+  /**
+   * @brief Constructs a new element in place at the front of the deque container.
+   * @param args Arguments forwarded to the constructor of T.
+   * @return True if the element was inserted, false if it was dropped or rejected by the overflow policy.
+   */
+  template <typename... Args>
+  bool emplace_front(Args&&... args) {
+    return insert<true>({}, std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Constructs a new element in place at the end of the deque container.
+   * @param args Arguments forwarded to the constructor of T.
+   * @return True if the element was inserted, false if it was dropped or rejected by the overflow policy.
+   */
+  template <typename... Args>
+  bool emplace_back(Args&&... args) {
+    return insert<false>({}, std::forward<Args>(args)...);
   }
 
   /**
@@ -103,9 +201,10 @@ class DequeSafe {
    */
   void wait_and_pop_front(T& value) {
     std::unique_lock<std::mutex> lk(m_semaphore);
-    m_condition.wait(lk, [this] { return !m_container.empty(); });
-    value = m_container.front();
+    wait_items(lk, 1);
+    value = std::move(m_container.front());
     m_container.pop_front();
+    released(1);
   }
 
   /**
@@ -115,9 +214,10 @@ class DequeSafe {
    */
   void wait_and_pop_back(T& value) {
     std::unique_lock lk(m_semaphore);
-    m_condition.wait(lk, [this] { return !m_container.empty(); });
-    value = m_container.back();
+    wait_items(lk, 1);
+    value = std::move(m_container.back());
     m_container.pop_back();
+    released(1);
   }
 
   /**
@@ -127,9 +227,10 @@ class DequeSafe {
    */
   std::shared_ptr<T> wait_and_pop_front() {
     std::unique_lock lk(m_semaphore);
-    m_condition.wait(lk, [this] { return !m_container.empty(); });
-    std::shared_ptr<T> res(std::make_shared<T>(m_container.front()));
+    wait_items(lk, 1);
+    std::shared_ptr<T> res(std::make_shared<T>(std::move(m_container.front())));
     m_container.pop_front();
+    released(1);
     return res;
   }
 
@@ -140,12 +241,151 @@ class DequeSafe {
     */
   std::shared_ptr<T> wait_and_pop_back() {
     std::unique_lock lk(m_semaphore);
-    m_condition.wait(lk, [this] { return !m_container.empty(); });
-    std::shared_ptr<T> res(std::make_shared<T>(m_container.back()));
+    wait_items(lk, 1);
+    std::shared_ptr<T> res(std::make_shared<T>(std::move(m_container.back())));
     m_container.pop_back();
+    released(1);
     return res;
   }
 
+  /**
+   * @brief Waits until the deque is not empty or a stop is requested, then pops the first element.
+   * @param value A reference to store the popped element.
+   * @param stoken The stop token interrupting the wait.
+   * @return True if an element was popped, false if the wait was stopped.
+   */
+  bool wait_and_pop_front(T& value, std::stop_token stoken) {
+    std::unique_lock lk(m_semaphore);
+    if (!wait_items(lk, 1, std::move(stoken))) {
+      return false;
+    }
+    value = std::move(m_container.front());
+    m_container.pop_front();
+    released(1);
+    return true;
+  }
+
+  /**
+   * @brief Waits at most timeout until the deque is not empty, then pops the first element.
+   * @param value A reference to store the popped element.
+   * @param timeout The maximal time to wait.
+   * @param stoken The stop token interrupting the wait.
+   * @return True if an element was popped, false on timeout or stop.
+   */
+  template <typename Rep, typename Period>
+  bool wait_for_and_pop_front(T& value, const std::chrono::duration<Rep, Period>& timeout,
+                              std::stop_token stoken = {}) {
+    return wait_until_and_pop_front(value, std::chrono::steady_clock::now() + timeout, std::move(stoken));
+  }
+
+  /**
+   * @brief Waits until the deadline for the deque to be not empty, then pops the first element.
+   * @param value A reference to store the popped element.
+   * @param deadline The time point at which the wait gives up.
+   * @param stoken The stop token interrupting the wait.
+   * @return True if an element was popped, false on timeout or stop.
+   */
+  template <typename Clock, typename Duration>
+  bool wait_until_and_pop_front(T& value, const std::chrono::time_point<Clock, Duration>& deadline,
+                                std::stop_token stoken = {}) {
+    std::unique_lock lk(m_semaphore);
+    if (!wait_items_until(lk, 1, deadline, std::move(stoken))) {
+      return false;
+    }
+    value = std::move(m_container.front());
+    m_container.pop_front();
+    released(1);
+    return true;
+  }
+
+  /**
+   * @brief Waits until the deque is not empty or a stop is requested, then pops the last element.
+   * @param value A reference to store the popped element.
+   * @param stoken The stop token interrupting the wait.
+   * @return True if an element was popped, false if the wait was stopped.
+   */
+  bool wait_and_pop_back(T& value, std::stop_token stoken) {
+    std::unique_lock lk(m_semaphore);
+    if (!wait_items(lk, 1, std::move(stoken))) {
+      return false;
+    }
+    value = std::move(m_container.back());
+    m_container.pop_back();
+    released(1);
+    return true;
+  }
+
+  /**
+   * @brief Waits at most timeout until the deque is not empty, then pops the last element.
+   * @param value A reference to store the popped element.
+   * @param timeout The maximal time to wait.
+   * @param stoken The stop token interrupting the wait.
+   * @return True if an element was popped, false on timeout or stop.
+   */
+  template <typename Rep, typename Period>
+  bool wait_for_and_pop_back(T& value, const std::chrono::duration<Rep, Period>& timeout, std::stop_token stoken = {}) {
+    return wait_until_and_pop_back(value, std::chrono::steady_clock::now() + timeout, std::move(stoken));
+  }
+
+  /**
+   * @brief Waits until the deadline for the deque to be not empty, then pops the last element.
+   * @param value A reference to store the popped element.
+   * @param deadline The time point at which the wait gives up.
+   * @param stoken The stop token interrupting the wait.
+   * @return True if an element was popped, false on timeout or stop.
+   */
+  template <typename Clock, typename Duration>
+  bool wait_until_and_pop_back(T& value, const std::chrono::time_point<Clock, Duration>& deadline,
+                               std::stop_token stoken = {}) {
+    std::unique_lock lk(m_semaphore);
+    if (!wait_items_until(lk, 1, deadline, std::move(stoken))) {
+      return false;
+    }
+    value = std::move(m_container.back());
+    m_container.pop_back();
+    released(1);
+    return true;
+  }
+
+  /**
+   * @brief Waits at most timeout until min_count elements are queued, then pops up to max_count from the front.
+   * @param out The destination of the popped elements.
+   * @param min_count The number of elements the wait is satisfied with.
+   * @param max_count The maximal number of elements to pop.
+   * @param timeout The maximal time to wait.
+   * @param stoken The stop token interrupting the wait.
+   * @return The number of elements popped, less than min_count on timeout or stop.
+   */
+  template <typename OutputIt, typename Rep, typename Period>
+  size_t wait_for_and_pop_front_batch(OutputIt out, size_t min_count, size_t max_count,
+                                      const std::chrono::duration<Rep, Period>& timeout, std::stop_token stoken = {}) {
+    return wait_until_and_pop_front_batch(out, min_count, max_count, std::chrono::steady_clock::now() + timeout,
+                                          std::move(stoken));
+  }
+
+  /**
+   * @brief Waits until the deadline for min_count elements, then pops up to max_count from the front.
+   * @param out The destination of the popped elements.
+   * @param min_count The number of elements the wait is satisfied with.
+   * @param max_count The maximal number of elements to pop.
+   * @param deadline The time point at which the wait gives up.
+   * @param stoken The stop token interrupting the wait.
+   * @return The number of elements popped, less than min_count on timeout or stop.
+   */
+  template <typename OutputIt, typename Clock, typename Duration>
+  size_t wait_until_and_pop_front_batch(OutputIt out, size_t min_count, size_t max_count,
+                                        const std::chrono::time_point<Clock, Duration>& deadline,
+                                        std::stop_token stoken = {}) {
+    std::unique_lock lk(m_semaphore);
+    wait_items_until(lk, std::min(min_count, max_count), deadline, std::move(stoken));
+    const auto last = m_container.begin() + std::min(m_container.size(), max_count);
+    const size_t count = last - m_container.begin();
+    std::move(m_container.begin(), last, out);
+    m_container.erase(m_container.begin(), last);
+    released(count);
+    return count;
+  }
+
   /**
   * @brief Attempts to pop the last element from the deque if it is not empty.
   * @tparam T The type of elements stored in the deque.
@@ -157,8 +397,9 @@ class DequeSafe {
     if (m_container.empty()) {
       return false;
     }
-    value = m_container.back();
+    value = std::move(m_container.back());
     m_container.pop_back();
+    released(1);
     return (true);
   }
 
@@ -171,8 +412,9 @@ class DequeSafe {
     if (m_container.empty()) {
       return std::shared_ptr<T>();
     }
-    std::shared_ptr<T> res(std::make_shared<T>(m_container.back()));
+    std::shared_ptr<T> res(std::make_shared<T>(std::move(m_container.back())));
     m_container.pop_back();
+    released(1);
     return res;
   }
 
@@ -186,8 +428,9 @@ class DequeSafe {
     if (m_container.empty()) {
       return false;
     }
-    value = m_container.front();
+    value = std::move(m_container.front());
     m_container.pop_front();
+    released(1);
     return true;
   }
 
@@ -200,8 +443,95 @@ class DequeSafe {
     if (m_container.empty()) {
       return std::shared_ptr<T>();
     }
-    std::shared_ptr<T> res(std::make_shared<T>(m_container.front()));
+    std::shared_ptr<T> res(std::make_shared<T>(std::move(m_container.front())));
     m_container.pop_front();
+    released(1);
+    return res;
+  }
+
+  /**
+   * @brief Waits until the deque is not empty and moves the first element out of the deque.
+   * @tparam T The type of elements stored in the deque.
+   * @return The popped element.
+   */
+  T wait_and_pop_front_value() {
+    std::unique_lock lk(m_semaphore);
+    wait_items(lk, 1);
+    T res(std::move(m_container.front()));
+    m_container.pop_front();
+    released(1);
+    return res;
+  }
+
+  /**
+   * @brief Waits until the deque is not empty and moves the last element out of the deque.
+   * @tparam T The type of elements stored in the deque.
+   * @return The popped element.
+   */
+  T wait_and_pop_back_value() {
+    std::unique_lock lk(m_semaphore);
+    wait_items(lk, 1);
+    T res(std::move(m_container.back()));
+    m_container.pop_back();
+    released(1);
+    return res;
+  }
+
+  /**
+   * @brief Moves the first element out of the deque if it is not empty.
+   * @return The popped element, or std::nullopt if the deque is empty.
+   */
+  std::optional<T> try_pop_front_value() {
+    std::lock_guard lk(m_semaphore);
+    if (m_container.empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> res(std::move(m_container.front()));
+    m_container.pop_front();
+    released(1);
+    return res;
+  }
+
+  /**
+   * @brief Moves the last element out of the deque if it is not empty.
+   * @return The popped element, or std::nullopt if the deque is empty.
+   */
+  std::optional<T> try_pop_back_value() {
+    std::lock_guard lk(m_semaphore);
+    if (m_container.empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> res(std::move(m_container.back()));
+    m_container.pop_back();
+    released(1);
+    return res;
+  }
+
+  /**
+   * @brief Moves all elements out of the deque, front to back, under one lock acquisition.
+   * @tparam OutputIt The output iterator type.
+   * @param out The destination of the elements.
+   * @return The number of elements popped.
+   */
+  template <typename OutputIt>
+  size_t pop_all(OutputIt out) {
+    std::lock_guard lk(m_semaphore);
+    const size_t count = m_container.size();
+    std::move(m_container.begin(), m_container.end(), out);
+    m_container.clear();
+    released(count);
+    return count;
+  }
+
+  /**
+   * @brief Takes the whole content of the deque by swapping it with an empty one.
+   * @return The former content of the deque.
+   */
+  std::deque<T, TAlloc> swap_out() {
+    std::deque<T, TAlloc> res(m_container.get_allocator());
+    std::lock_guard lk(m_semaphore);
+    res.swap(m_container);
+    released(res.size());
     return res;
   }
 
@@ -214,6 +544,27 @@ class DequeSafe {
     return m_container.empty();
   }
 
+  /**
+   * @brief Returns the capacity of the container.
+   * @return The maximal number of elements, or unboundedCapacity.
+   */
+  size_t capacity() const noexcept { return m_capacity; }
+
+  /**
+   * @brief Returns the overflow policy of the container.
+   * @return The policy applied when the container is full.
+   */
+  OverflowPolicy policy() const noexcept { return m_policy; }
+
+  /**
+   * @brief Returns the backpressure counters.
+   * @return A snapshot of the dropped, blocked and rejected counters.
+   */
+  OverflowCounters overflow_counters() const {
+    std::lock_guard lk(m_semaphore);
+    return m_counters;
+  }
+
   /**
    * @brief Returns the size of the container.
    * @return The size of the container.
@@ -222,6 +573,100 @@ class DequeSafe {
     std::lock_guard lk(m_semaphore);
     return m_container.size();
   }
+
+ private:
+  /**
+   * @brief Inserts a new element at one end, applying the overflow policy if the deque is full.
+   * @tparam AtFront true to insert at the front, false to insert at the end.
+   * @param stoken The stop token interrupting a blocked push.
+   * @param args Arguments forwarded to the constructor of T.
+   * @return True if the element was inserted.
+   */
+  template <bool AtFront, typename... Args>
+  bool insert(std::stop_token stoken, Args&&... args) {
+    std::unique_lock lk(m_semaphore);
+    if (m_capacity != unboundedCapacity && m_container.size() >= m_capacity) {
+      switch (m_policy) {
+        case OverflowPolicy::block: {
+          ++m_counters.blocked;
+          ++m_blockedProducers;
+          const bool room =
+             m_notFull.wait(lk, std::move(stoken), [this] { return m_container.size() < m_capacity; });
+          --m_blockedProducers;
+          if (!room) {
+            ++m_counters.rejected;
+            return false;
+          }
+          break;
+        }
+        case OverflowPolicy::dropNewest:
+          ++m_counters.dropped;
+          return false;
+        case OverflowPolicy::dropOldest:
+          if constexpr (AtFront) {
+            m_container.pop_back();
+          } else {
+            m_container.pop_front();
+          }
+          ++m_counters.dropped;
+          break;
+        case OverflowPolicy::fail:
+          ++m_counters.rejected;
+          return false;
+      }
+    }
+    if constexpr (AtFront) {
+      m_container.emplace_front(std::forward<Args>(args)...);
+    } else {
+      m_container.emplace_back(std::forward<Args>(args)...);
+    }
+    m_waiters.notify(m_condition, m_container.size());
+    return true;
+  }
+
+  /**
+   * @brief Wakes producers blocked on the full deque after elements were removed.
+   * @param count The number of removed elements.
+   */
+  void released(size_t count) {
+    if (m_blockedProducers == 0 || count == 0) {
+      return;
+    }
+    if (count == 1) {
+      m_notFull.notify_one();
+    } else {
+      m_notFull.notify_all();
+    }
+  }
+
+  /**
+   * @brief Waits with the lock held until the deque contains wanted elements or a stop is requested.
+   * @param lk The lock of m_semaphore.
+   * @param wanted The number of elements to wait for.
+   * @param stoken The stop token interrupting the wait.
+   * @return True if the deque contains wanted elements.
+   */
+  bool wait_items(std::unique_lock<std::mutex>& lk, size_t wanted, std::stop_token stoken = {}) {
+    details::ConsumerWaiters::Registration registration(m_waiters, wanted);
+    return m_condition.wait(lk, std::move(stoken), [this, wanted] { return m_container.size() >= wanted; });
+  }
+
+  /**
+   * @brief Waits with the lock held until the deque contains wanted elements, the deadline passes or a stop
+   * is requested.
+   * @param lk The lock of m_semaphore.
+   * @param wanted The number of elements to wait for.
+   * @param deadline The time point at which the wait gives up.
+   * @param stoken The stop token interrupting the wait.
+   * @return True if the deque contains wanted elements.
+   */
+  template <typename Clock, typename Duration>
+  bool wait_items_until(std::unique_lock<std::mutex>& lk, size_t wanted,
+                        const std::chrono::time_point<Clock, Duration>& deadline, std::stop_token stoken) {
+    details::ConsumerWaiters::Registration registration(m_waiters, wanted);
+    return m_condition.wait_until(lk, std::move(stoken), deadline,
+                                  [this, wanted] { return m_container.size() >= wanted; });
+  }
 };
 
 }   // namespace cppsl::container
@@ -0,0 +1,195 @@
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * \brief   contains lock free work-stealing deque.
+ * \details Chase-Lev deque in the C11 memory model formulation of
+ * N.M. Le, A. Pop, A. Cohen, F. Zappa Nardelli, "Correct and Efficient
+ * Work-Stealing for Weak Memory Models", PPoPP 2013.
+ * \author  Alexander Sacharov
+ * \date    2024-05-20
+ * \ingroup Container
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include <cppsl/container/details/cacheLine.hpp>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::container {
+
+/**
+ * @class DequeWorkStealing
+ * @brief A lock-free deque owned by one thread and stolen from by others.
+ *
+ * The owner thread pushes and pops at the bottom with plain loads and stores, only
+ * the race for the last element uses a compare-exchange. Any other thread may steal()
+ * from the top. The storage grows on demand; retired arrays are kept until the deque
+ * is destroyed because a thief may still read from them.
+ *
+ * Thieves may read a slot that the owner overwrites concurrently and discard the value,
+ * therefore T must be trivially copyable, typically a pointer to a task.
+ *
+ * @tparam T The type of elements stored in the deque.
+ */
+template <typename T>
+class DequeWorkStealing {
+  static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+  /**
+   * @brief A circular array of atomic slots with power of 2 size.
+   */
+  struct array {
+    const int64_t m_size;
+    const int64_t m_mask;
+    std::unique_ptr<std::atomic<T>[]> m_slots;
+
+    explicit array(int64_t size) : m_size(size), m_mask(size - 1), m_slots(new std::atomic<T>[size]) {}
+
+    T get(int64_t index) const noexcept { return m_slots[index & m_mask].load(std::memory_order_relaxed); }
+    void put(int64_t index, T value) noexcept { m_slots[index & m_mask].store(value, std::memory_order_relaxed); }
+
+    std::unique_ptr<array> grow(int64_t bottom, int64_t top) const {
+      auto res = std::make_unique<array>(m_size * 2);
+      for (auto i = top; i < bottom; ++i) {
+        res->put(i, get(i));
+      }
+      return res;
+    }
+  };
+
+  alignas(details::cacheLineSize) std::atomic<int64_t> m_top{0};      ///< steal end, shared by thieves
+  alignas(details::cacheLineSize) std::atomic<int64_t> m_bottom{0};   ///< owner end
+  std::atomic<array*> m_array;                                       ///< current storage
+  std::vector<std::unique_ptr<array>> m_arrays;                      ///< current and retired storage, owner only
+
+ public:
+  /**
+   * @brief Constructor.
+   * @param capacity The initial capacity, rounded up to the next power of 2.
+   */
+  explicit DequeWorkStealing(size_t capacity = 256) {
+    int64_t size = 2;
+    while (size < static_cast<int64_t>(capacity)) {
+      size <<= 1;
+    }
+    m_arrays.push_back(std::make_unique<array>(size));
+    m_array.store(m_arrays.back().get(), std::memory_order_relaxed);
+  }
+
+  DequeWorkStealing(const DequeWorkStealing&) = delete;
+  DequeWorkStealing& operator=(const DequeWorkStealing&) = delete;
+
+  /**
+   * @brief Pushes an element at the bottom. Owner thread only.
+   * @param value The value to be pushed.
+   */
+  void push(T value) {
+    const auto b = m_bottom.load(std::memory_order_relaxed);
+    const auto t = m_top.load(std::memory_order_acquire);
+    auto* a = m_array.load(std::memory_order_relaxed);
+    if (b - t > a->m_size - 1) {
+      m_arrays.push_back(a->grow(b, t));
+      a = m_arrays.back().get();
+      m_array.store(a, std::memory_order_release);
+    }
+    a->put(b, value);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Pops the element pushed last. Owner thread only.
+   * @return The element, or std::nullopt if the deque is empty or a thief took the last element.
+   */
+  std::optional<T> pop() {
+    const auto b = m_bottom.load(std::memory_order_relaxed) - 1;
+    auto* a = m_array.load(std::memory_order_relaxed);
+    m_bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto t = m_top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+      // empty
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+
+    const T value = a->get(b);
+    if (t == b) {
+      // last element, race against thieves
+      const bool won = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      m_bottom.store(b + 1, std::memory_order_relaxed);
+      if (!won) {
+        return std::nullopt;
+      }
+    }
+    return value;
+  }
+
+  /**
+   * @brief Steals the element pushed first. Any thread.
+   * @return The element, or std::nullopt if the deque is empty or another thread won the race.
+   */
+  std::optional<T> steal() {
+    auto t = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const auto b = m_bottom.load(std::memory_order_acquire);
+
+    if (t >= b) {
+      return std::nullopt;
+    }
+
+    const auto* a = m_array.load(std::memory_order_acquire);
+    const T value = a->get(t);
+    if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return std::nullopt;
+    }
+    return value;
+  }
+
+  /**
+   * @brief Returns the approximate number of elements.
+   * @return The number of elements in the deque.
+   */
+  [[nodiscard]] size_t size() const noexcept {
+    const auto b = m_bottom.load(std::memory_order_relaxed);
+    const auto t = m_top.load(std::memory_order_relaxed);
+    return b > t ? static_cast<size_t>(b - t) : 0;
+  }
+
+  /**
+   * @brief Checks whether the deque is approximately empty.
+   * @return true if the deque is empty, false otherwise.
+   */
+  [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+  /**
+   * @brief Returns the capacity of the current storage.
+   * @return The number of slots.
+   */
+  [[nodiscard]] size_t capacity() const noexcept {
+    return static_cast<size_t>(m_array.load(std::memory_order_relaxed)->m_size);
+  }
+};
+
+}   // namespace cppsl::container
@@ -0,0 +1,38 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * @brief   cache line size used to keep independently written atomics apart.
+ * @ingroup Container
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <cstddef>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::container::details {
+
+/**
+ * @brief Destructive interference size of the targets.
+ *
+ * std::hardware_destructive_interference_size is not ABI stable between compiler
+ * flags (gcc warns with -Winterference-size), so a fixed value is used. 64 bytes
+ * matches x86-64 and the Cortex-A15/A53/A72 cores of the supported boards.
+ */
+inline constexpr std::size_t cacheLineSize = 64;
+
+}   // namespace cppsl::container::details
@@ -0,0 +1,106 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * @brief   bookkeeping of the consumers blocked in a locking container.
+ * @ingroup Container
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::container::details {
+
+/**
+ * @class ConsumerWaiters
+ * @brief Counts blocked consumers and how many items they wait for.
+ *
+ * Producers only signal the condition variable when somebody waits and enough items are
+ * available for the least demanding waiter. A batch consumer waiting for N items is thus
+ * woken once per batch and not once per item. All members must be accessed with the
+ * container mutex held.
+ */
+class ConsumerWaiters {
+  size_t m_waiters{0};                                         ///< blocked consumers
+  size_t m_batchWaiters{0};                                    ///< blocked consumers waiting for more than one item
+  size_t m_minWanted{std::numeric_limits<size_t>::max()};      ///< smallest item count one of them waits for
+
+ public:
+  /**
+   * @brief Registers a consumer for the lifetime of the object.
+   */
+  class Registration {
+    ConsumerWaiters& m_owner;
+    const size_t m_wanted;
+
+   public:
+    /**
+     * @brief Registers a consumer.
+     * @param owner The waiter bookkeeping of the container.
+     * @param wanted The number of items the consumer waits for.
+     */
+    Registration(ConsumerWaiters& owner, size_t wanted) : m_owner(owner), m_wanted(std::max<size_t>(wanted, 1)) {
+      ++m_owner.m_waiters;
+      if (m_wanted > 1) {
+        ++m_owner.m_batchWaiters;
+      }
+      m_owner.m_minWanted = std::min(m_owner.m_minWanted, m_wanted);
+    }
+
+    /**
+     * @brief Unregisters the consumer. The minimum is reset only when the last waiter leaves,
+     * a stale lower minimum causes spurious wakeups but no lost ones.
+     */
+    ~Registration() {
+      --m_owner.m_waiters;
+      if (m_wanted > 1) {
+        --m_owner.m_batchWaiters;
+      }
+      if (m_owner.m_waiters == 0) {
+        m_owner.m_minWanted = std::numeric_limits<size_t>::max();
+      }
+    }
+
+    Registration(const Registration&) = delete;
+    Registration& operator=(const Registration&) = delete;
+  };
+
+  /**
+   * @brief Wakes consumers if the available items satisfy at least one of them.
+   * @tparam Condition The condition variable type.
+   * @param condition The condition variable the consumers wait on.
+   * @param available The number of items in the container.
+   */
+  template <typename Condition>
+  void notify(Condition& condition, size_t available) const {
+    if (m_waiters == 0 || available < m_minWanted) {
+      return;
+    }
+    if (m_batchWaiters > 0) {
+      // waiters want different counts, notify_one could pick one that is not yet satisfied
+      condition.notify_all();
+    } else {
+      condition.notify_one();
+    }
+  }
+};
+
+}   // namespace cppsl::container::details
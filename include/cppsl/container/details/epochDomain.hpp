@@ -0,0 +1,123 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * @brief   epoch based grace periods for lock-free readers.
+ * @ingroup Container
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <cppsl/container/details/cacheLine.hpp>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::container::details {
+
+/**
+ * @class EpochDomain
+ * @brief Lets a writer wait until all readers that might still see removed data are gone.
+ *
+ * Readers enter a read-side section with read_lock() and count themselves in the reader
+ * counter of the current epoch parity. synchronize() advances the epoch, so new readers use
+ * the other counter, and waits until the counter of the old parity drains. Counters are
+ * striped over several cache lines to keep concurrent readers from sharing one line.
+ *
+ * Read-side sections may nest. A thread must not call synchronize() inside its own
+ * read-side section, it would wait for itself.
+ */
+class EpochDomain {
+  static constexpr size_t stripeCount = 8;
+
+  struct alignas(cacheLineSize) stripe {
+    std::array<std::atomic<size_t>, 2> m_readers{};   ///< active readers per epoch parity
+  };
+
+  std::atomic<size_t> m_epoch{0};              ///< current epoch, its parity selects the reader counter
+  std::array<stripe, stripeCount> m_stripes;   ///< striped reader counters
+  std::mutex m_syncMutex;                      ///< serializes synchronize()
+
+ public:
+  /**
+   * @brief RAII read-side section.
+   */
+  class Guard {
+    std::atomic<size_t>* m_counter;
+
+   public:
+    explicit Guard(std::atomic<size_t>& counter) noexcept : m_counter(&counter) {}
+    ~Guard() {
+      if (m_counter) {
+        m_counter->fetch_sub(1, std::memory_order_release);
+      }
+    }
+
+    Guard(Guard&& other) noexcept : m_counter(std::exchange(other.m_counter, nullptr)) {}
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+    Guard& operator=(Guard&&) = delete;
+  };
+
+  /**
+   * @brief Enters a read-side section. Data reachable now stays valid until the guard is destroyed.
+   * @return The guard ending the section.
+   */
+  [[nodiscard]] Guard read_lock() noexcept {
+    auto& readers = m_stripes[stripeIndex()].m_readers;
+    for (;;) {
+      const auto epoch = m_epoch.load();
+      auto& counter = readers[epoch & 1];
+      counter.fetch_add(1);
+      if (m_epoch.load() == epoch) {
+        return Guard(counter);
+      }
+      // a writer advanced the epoch meanwhile, register in the new one
+      counter.fetch_sub(1);
+    }
+  }
+
+  /**
+   * @brief Waits until every read-side section that started before the call has ended.
+   */
+  void synchronize() {
+    std::lock_guard<std::mutex> lk(m_syncMutex);
+    const auto epoch = m_epoch.fetch_add(1);
+    for (auto& s : m_stripes) {
+      while (s.m_readers[epoch & 1].load() != 0) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+ private:
+  /**
+   * @brief Returns the counter stripe of the calling thread, assigned round robin on first use.
+   * @return The stripe index.
+   */
+  static size_t stripeIndex() noexcept {
+    static std::atomic<size_t> next{0};
+    thread_local const size_t index = next.fetch_add(1, std::memory_order_relaxed) % stripeCount;
+    return index;
+  }
+};
+
+}   // namespace cppsl::container::details
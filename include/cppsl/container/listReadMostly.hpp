@@ -0,0 +1,172 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * @brief   read optimized concurrent list with lock-free traversal.
+ * @ingroup Container
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <cppsl/container/details/epochDomain.hpp>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::container {
+
+/**
+ * @class ListReadMostly
+ * @brief Concurrent list for data that is read often and changed rarely.
+ *
+ * Drop-in alternative to ListSafe. Readers walk the list without locks, only entering an
+ * epoch read-side section once per traversal. Writers serialize on one mutex; removed nodes
+ * are unlinked at once and freed after a grace period, when no reader can still hold them.
+ * A node holds the value directly, without a per-node mutex or shared_ptr.
+ *
+ * The callbacks of for_each() and find_first_if() run inside the read-side section and must
+ * not call remove_if() or clean() of the same list.
+ *
+ * @tparam T The type of elements in the list.
+ */
+template <typename T>
+class ListReadMostly {
+  struct node {
+    T m_value;
+    std::atomic<node*> m_next{nullptr};
+
+    template <typename... Args>
+    explicit node(Args&&... args) : m_value(std::forward<Args>(args)...) {}
+  };
+
+  std::atomic<node*> m_head{nullptr};      ///< first node, published with release
+  std::mutex m_writeMutex;                 ///< serializes writers
+  mutable details::EpochDomain m_epochs;   ///< grace periods for removed nodes, readers only touch its counters
+
+ public:
+  ListReadMostly() = default;
+
+  /**
+   * @brief Destructor: frees all nodes. No reader may be active.
+   */
+  ~ListReadMostly() {
+    auto* current = m_head.load(std::memory_order_relaxed);
+    while (current) {
+      delete std::exchange(current, current->m_next.load(std::memory_order_relaxed));
+    }
+  }
+
+  ListReadMostly(const ListReadMostly&) = delete;
+  ListReadMostly& operator=(const ListReadMostly&) = delete;
+
+  /**
+   * @brief Removes all elements and frees them after the grace period.
+   */
+  void clean() {
+    remove_if([](T const&) { return true; });
+  }
+
+  /**
+   * @brief Inserts a copy of the value at the front of the list.
+   * @param value The value to be inserted.
+   */
+  void push_front(T const& value) { emplace_front(value); }
+
+  /**
+   * @brief Constructs a new element at the front of the list.
+   * @param args Arguments forwarded to the constructor of T.
+   */
+  template <typename... Args>
+  void emplace_front(Args&&... args) {
+    auto* newNode = new node(std::forward<Args>(args)...);
+    std::lock_guard<std::mutex> lk(m_writeMutex);
+    newNode->m_next.store(m_head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    m_head.store(newNode, std::memory_order_release);
+  }
+
+  /**
+   * @brief Calls a function for every element, without locking.
+   * @param f The function, called with a const reference to each element.
+   */
+  template <typename Function>
+  void for_each(Function f) const {
+    auto guard = m_epochs.read_lock();
+    for (auto* current = m_head.load(std::memory_order_acquire); current;
+         current = current->m_next.load(std::memory_order_acquire)) {
+      f(static_cast<T const&>(current->m_value));
+    }
+  }
+
+  /**
+   * @brief Finds the first element matching a predicate, without locking.
+   * @param p The predicate.
+   * @return A copy of the element, or std::nullopt if none matches.
+   */
+  template <typename Predicate>
+  std::optional<T> find_first_if(Predicate p) const {
+    auto guard = m_epochs.read_lock();
+    for (auto* current = m_head.load(std::memory_order_acquire); current;
+         current = current->m_next.load(std::memory_order_acquire)) {
+      if (p(static_cast<T const&>(current->m_value))) {
+        return current->m_value;
+      }
+    }
+    return std::nullopt;
+  }
+
+  /**
+   * @brief Removes all elements matching a predicate. Waits for the readers that may still
+   * see them before freeing the nodes.
+   * @param p The predicate.
+   * @return The number of removed elements.
+   */
+  template <typename Predicate>
+  size_t remove_if(Predicate p) {
+    std::vector<node*> retired;
+    {
+      std::lock_guard<std::mutex> lk(m_writeMutex);
+      auto* link = &m_head;
+      while (auto* current = link->load(std::memory_order_relaxed)) {
+        if (p(static_cast<T const&>(current->m_value))) {
+          // readers standing on the node still find its successor
+          link->store(current->m_next.load(std::memory_order_relaxed), std::memory_order_release);
+          retired.push_back(current);
+        } else {
+          link = &current->m_next;
+        }
+      }
+    }
+    if (!retired.empty()) {
+      m_epochs.synchronize();
+      for (auto* n : retired) {
+        delete n;
+      }
+    }
+    return retired.size();
+  }
+
+  /**
+   * @brief Checks whether the list is empty.
+   * @return true if the list has no elements, false otherwise.
+   */
+  [[nodiscard]] bool empty() const noexcept { return m_head.load(std::memory_order_acquire) == nullptr; }
+};
+
+}   // namespace cppsl::container
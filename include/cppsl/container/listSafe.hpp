@@ -20,6 +20,7 @@
 //-----------------------------------------------------------------------------
 #include <memory>
 #include <mutex>
+#include <utility>
 
 //----------------------------------------------------------------------------
 // Defines and macros
@@ -41,25 +42,56 @@ namespace cppsl::container {
  *
  * This class is designed to provide a thread-safe linked list that can be accessed concurrently by multiple threads.
  * It uses locks to ensure that only one thread can modify the list at a time, preventing race conditions.
+ * For data that is read often and changed rarely see ListReadMostly.
+ *
+ * Nodes and values are allocated through TAlloc, rebound to the node type and to the
+ * shared_ptr control block; cppsl::memory::PoolAllocator avoids the global heap.
  *
  * @tparam T The type of elements in the list
+ * @tparam TAlloc The allocator for nodes and values, defaults to std::allocator<T>.
  */
-template <typename T>
+template <typename T, class TAlloc = std::allocator<T>>
 class ListSafe {
+  struct node;
+  using node_allocator = typename std::allocator_traits<TAlloc>::template rebind_alloc<node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  /**
+   * @brief Destroys and frees a node through the list allocator.
+   */
+  struct node_deleter {
+    [[no_unique_address]] node_allocator m_alloc;
+
+    void operator()(node* p) const noexcept {
+      node_allocator alloc(m_alloc);
+      node_traits::destroy(alloc, p);
+      node_traits::deallocate(alloc, p, 1);
+    }
+  };
+  using node_ptr = std::unique_ptr<node, node_deleter>;
+
   struct node {
     std::mutex m_mutex;
     std::shared_ptr<T> m_dataSp;
-    std::unique_ptr<node> m_next;
+    node_ptr m_next;
 
     node() : m_next() {}
 
-    node(T const& value) : m_dataSp(std::make_shared<T>(value)) {}
+    explicit node(std::shared_ptr<T> data) : m_dataSp(std::move(data)) {}
   };
 
+  [[no_unique_address]] node_allocator m_alloc;
   node head;
 
  public:
   ListSafe() = default;
+
+  /**
+   * @brief Constructs an empty list using the given allocator.
+   * @param alloc The allocator for nodes and values.
+   */
+  explicit ListSafe(const TAlloc& alloc) : m_alloc(alloc) {}
+
   ~ListSafe() {
     remove_if([](T const&) { return true; });
   }
@@ -79,7 +111,10 @@ class ListSafe {
    * @param T The type of elements in the list
    */
   void push_front(T const& value) {
-    std::unique_ptr<node> new_node(new node(value));
+    auto data = std::allocate_shared<T>(m_alloc, value);
+    node* p = node_traits::allocate(m_alloc, 1);
+    node_traits::construct(m_alloc, p, std::move(data));
+    node_ptr new_node(p, node_deleter{m_alloc});
 
     std::lock_guard<std::mutex> lk(head.m_mutex);
     new_node->m_next = std::move(head.m_next);
@@ -133,7 +168,7 @@ class ListSafe {
     while (node* const m_next = current->m_next.get()) {
       std::unique_lock<std::mutex> next_lk(m_next->m_mutex);
       if (p(*m_next->m_dataSp)) {
-        std::unique_ptr<node> old_next = std::move(current->m_next);
+        node_ptr old_next = std::move(current->m_next);
         current->m_next = std::move(m_next->m_next);
         next_lk.unlock();
       } else {
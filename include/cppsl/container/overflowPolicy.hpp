@@ -0,0 +1,51 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * @brief   overflow policies and backpressure counters of the bounded locking containers.
+ * @ingroup Container
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <cstddef>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::container {
+
+/// Capacity argument of QueueSafe/DequeSafe for a container without limit.
+inline constexpr size_t unboundedCapacity = 0;
+
+/**
+ * @brief What a push does when a bounded container is full.
+ */
+enum class OverflowPolicy : unsigned char {
+  block,        ///< the producer waits until a consumer makes room
+  dropNewest,   ///< the new element is discarded
+  dropOldest,   ///< the element at the opposite end is discarded to make room
+  fail          ///< the push is rejected and returns false
+};
+
+/**
+ * @brief Backpressure counters of a bounded container.
+ */
+struct OverflowCounters {
+  size_t dropped{0};    ///< elements discarded by dropNewest or dropOldest
+  size_t blocked{0};    ///< pushes that had to wait for room
+  size_t rejected{0};   ///< pushes refused by fail or stopped while blocked
+};
+
+}   // namespace cppsl::container
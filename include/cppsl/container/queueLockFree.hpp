@@ -21,6 +21,7 @@
 //-----------------------------------------------------------------------------
 #include <atomic>
 #include <memory>
+#include <utility>
 
 //----------------------------------------------------------------------------
 // Public Prototypes
@@ -31,12 +32,17 @@ namespace cppsl::container {
  * @class QueueLockFree
  * @brief A lock-free queue data structure implementation.
  *
- * This class provides a lock-free queue data structure, where multiple threads can
- * simultaneously push and pop elements without encountering any races or deadlocks.
+ * This class provides an unbounded lock-free queue for exactly one producer thread
+ * and one consumer thread. Every push allocates a node and the value. For several
+ * producers or consumers use QueueLockFreeBounded.
+ *
+ * Nodes and values are allocated through TAlloc, rebound to the node type and to the
+ * shared_ptr control block; cppsl::memory::PoolAllocator avoids the global heap.
  *
  * @tparam T The type of the elements stored in the queue.
+ * @tparam TAlloc The allocator for nodes and values, defaults to std::allocator<T>.
  */
-template <typename T>
+template <typename T, class TAlloc = std::allocator<T>>
 class QueueLockFree {
   /**
    * @brief A node used in the QueueLockFree class.
@@ -47,10 +53,35 @@ class QueueLockFree {
     node* m_next{nullptr};
   };
 
+  using node_allocator = typename std::allocator_traits<TAlloc>::template rebind_alloc<node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  /** allocator of nodes and values */
+  [[no_unique_address]] node_allocator m_alloc;
+
   /** atomic head and tail of queue */
   std::atomic<node*> m_head;
   std::atomic<node*> m_tail;
 
+  /**
+   * @brief Allocates and constructs an empty node.
+   * @return The new node.
+   */
+  node* create_node() {
+    node* p = node_traits::allocate(m_alloc, 1);
+    node_traits::construct(m_alloc, p);
+    return p;
+  }
+
+  /**
+   * @brief Destroys and frees a node.
+   * @param p The node.
+   */
+  void destroy_node(node* p) noexcept {
+    node_traits::destroy(m_alloc, p);
+    node_traits::deallocate(m_alloc, p, 1);
+  }
+
   /** copy constructor */
   QueueLockFree(const QueueLockFree& other);
 
@@ -76,7 +107,13 @@ class QueueLockFree {
    * @brief A lock-free queue data structure implementation.
    * @tparam T The type of the elements stored in the queue.
    */
-  QueueLockFree() : m_head(new node), m_tail(m_head.load()) {}
+  QueueLockFree() : QueueLockFree(TAlloc()) {}
+
+  /**
+   * @brief Constructs an empty queue using the given allocator.
+   * @param alloc The allocator for nodes and values.
+   */
+  explicit QueueLockFree(const TAlloc& alloc) : m_alloc(alloc), m_head(create_node()), m_tail(m_head.load()) {}
 
   /**
    * @class QueueLockFree
@@ -86,7 +123,7 @@ class QueueLockFree {
   ~QueueLockFree() {
     while (node* const old_head = m_head.load()) {
       m_head.store(old_head->m_next);
-      delete old_head;
+      destroy_node(old_head);
     }
   }
 
@@ -97,8 +134,13 @@ class QueueLockFree {
    * or an empty shared pointer if the queue is empty.
    */
   std::shared_ptr<T> try_pop() {
-    std::unique_ptr<node> old_head{pop_head()};
-    return old_head ? old_head->m_dataSp : std::shared_ptr<T>();
+    node* old_head = pop_head();
+    if (!old_head) {
+      return std::shared_ptr<T>();
+    }
+    std::shared_ptr<T> res(std::move(old_head->m_dataSp));
+    destroy_node(old_head);
+    return res;
   }
 
   /**
@@ -111,8 +153,8 @@ class QueueLockFree {
     if (!old_head) {
       return std::shared_ptr<T>();
     }
-    std::shared_ptr<T> const res(old_head->m_dataSp);
-    delete old_head;
+    std::shared_ptr<T> res(std::move(old_head->m_dataSp));
+    destroy_node(old_head);
     return res;
   }
 
@@ -122,8 +164,8 @@ class QueueLockFree {
    * @param new_value The new value to be pushed into the queue.
    */
   void push(T new_value) {
-    std::shared_ptr<T> new_data(std::make_shared<T>(new_value));
-    node* p = new node;
+    std::shared_ptr<T> new_data(std::allocate_shared<T>(m_alloc, std::move(new_value)));
+    node* p = create_node();
     node* const old_tail = m_tail.load();
     old_tail->m_dataSp.swap(new_data);
     old_tail->m_next = p;
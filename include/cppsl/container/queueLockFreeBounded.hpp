@@ -0,0 +1,278 @@
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * \brief   contains bounded multi-producer/multi-consumer lock free queue.
+ * \details The algorithm is the bounded MPMC queue of Dmitry Vyukov: every
+ * slot carries a sequence number which tells producers and consumers whether
+ * the slot is free for the current lap. Slots are allocated once in the
+ * constructor, push and pop never allocate.
+ * \author  Alexander Sacharov
+ * \date    2024-05-02
+ * \ingroup Container
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// Includes
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include <cppsl/container/details/cacheLine.hpp>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::container {
+
+/**
+ * @class QueueLockFreeBounded
+ * @brief A bounded lock-free queue for multiple producers and multiple consumers.
+ *
+ * The capacity is rounded up to the next power of 2. All slots are preallocated,
+ * values are moved into and out of the slots in place. Head and tail counters live
+ * in separate cache lines, so producers and consumers do not share a line.
+ *
+ * @tparam T The type of the elements stored in the queue.
+ */
+template <typename T>
+class QueueLockFreeBounded {
+  /**
+   * @brief A slot of the ring. The sequence says for which lap the slot is ready.
+   */
+  struct alignas(details::cacheLineSize) slot {
+    std::atomic<size_t> m_sequence{0};
+    alignas(T) std::byte m_storage[sizeof(T)];
+
+    T* data() noexcept { return std::launder(reinterpret_cast<T*>(m_storage)); }
+  };
+
+  const size_t m_capacity;                                   ///< number of slots, power of 2
+  const size_t m_mask;                                       ///< m_capacity - 1
+  std::unique_ptr<slot[]> m_slots;                           ///< preallocated slots
+  alignas(details::cacheLineSize) std::atomic<size_t> m_tail{0};   ///< next position to push
+  alignas(details::cacheLineSize) std::atomic<size_t> m_head{0};   ///< next position to pop
+
+ public:
+  /**
+   * @brief Constructor: allocates the slots once.
+   * @param capacity The capacity of the queue, rounded up to the next power of 2.
+   * @throws std::invalid_argument if capacity is less than 2.
+   */
+  explicit QueueLockFreeBounded(size_t capacity = 1024)
+      : m_capacity(nextPowerOf2(capacity)), m_mask(m_capacity - 1), m_slots(new slot[m_capacity]) {
+    if (capacity < 2) {
+      throw std::invalid_argument("Capacity must be at least 2");
+    }
+    for (size_t i = 0; i < m_capacity; ++i) {
+      m_slots[i].m_sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Destructor: destroys the elements still in the queue.
+   */
+  ~QueueLockFreeBounded() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      while (try_pop()) {
+      }
+    }
+  }
+
+  QueueLockFreeBounded(const QueueLockFreeBounded&) = delete;
+  QueueLockFreeBounded& operator=(const QueueLockFreeBounded&) = delete;
+
+  /**
+   * @brief Constructs a new element in place at the tail of the queue.
+   * @details A constructor that may throw runs before a slot is claimed and the
+   * value is moved into the slot, so a failure never leaves a claimed slot
+   * unpublished.
+   * @param args Arguments forwarded to the constructor of T.
+   * @return true if the element was added, false if the queue is full.
+   */
+  template <typename... Args>
+  [[nodiscard]] bool try_emplace(Args&&... args) {
+    if constexpr (std::is_nothrow_constructible_v<T, Args&&...>) {
+      slot* cell = acquire_tail();
+      if (!cell) {
+        return false;
+      }
+      ::new (static_cast<void*>(cell->m_storage)) T(std::forward<Args>(args)...);
+      release_tail(cell);
+      return true;
+    } else {
+      static_assert(std::is_nothrow_move_constructible_v<T>,
+                    "T must be nothrow move constructible or nothrow constructible from the arguments");
+      T value(std::forward<Args>(args)...);
+      return try_emplace(std::move(value));
+    }
+  }
+
+  /**
+   * @brief Pushes a copy of the value into the queue.
+   * @param value The value to be pushed.
+   * @return true if the value was added, false if the queue is full.
+   */
+  [[nodiscard]] bool try_push(const T& value) { return try_emplace(value); }
+
+  /**
+   * @brief Moves the value into the queue.
+   * @param value The value to be pushed.
+   * @return true if the value was added, false if the queue is full.
+   */
+  [[nodiscard]] bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+  /**
+   * @brief Moves the element at the head of the queue into value.
+   * @details The move runs while the slot is claimed, so it must not throw or the
+   * slot would never be released.
+   * @param value A reference to the variable where the popped element will be moved.
+   * @return true if an element was popped, false if the queue is empty.
+   */
+  [[nodiscard]] bool try_pop(T& value) {
+    static_assert(std::is_nothrow_move_assignable_v<T>, "T must be nothrow move assignable");
+    slot* cell = acquire_head();
+    if (!cell) {
+      return false;
+    }
+    value = std::move(*cell->data());
+    release_head(cell);
+    return true;
+  }
+
+  /**
+   * @brief Moves the element at the head of the queue out.
+   * @details The move runs while the slot is claimed, so it must not throw or the
+   * slot would never be released.
+   * @return The popped element, or std::nullopt if the queue is empty.
+   */
+  [[nodiscard]] std::optional<T> try_pop() {
+    static_assert(std::is_nothrow_move_constructible_v<T>, "T must be nothrow move constructible");
+    slot* cell = acquire_head();
+    if (!cell) {
+      return std::nullopt;
+    }
+    std::optional<T> res(std::move(*cell->data()));
+    release_head(cell);
+    return res;
+  }
+
+  /**
+   * @brief Returns the capacity of the queue.
+   * @return The number of slots.
+   */
+  [[nodiscard]] size_t capacity() const noexcept { return m_capacity; }
+
+  /**
+   * @brief Returns the approximate number of elements. Exact only when the queue is quiescent.
+   * @return The number of elements in the queue.
+   */
+  [[nodiscard]] size_t size() const noexcept {
+    const size_t head = m_head.load(std::memory_order_acquire);
+    const size_t tail = m_tail.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+
+  /**
+   * @brief Checks whether the queue is empty. Exact only when the queue is quiescent.
+   * @return true if the queue is empty, false otherwise.
+   */
+  [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+ private:
+  /**
+   * @brief Claims the slot at the tail of the queue.
+   * @return The claimed slot, or nullptr if the queue is full.
+   */
+  slot* acquire_tail() noexcept {
+    size_t pos = m_tail.load(std::memory_order_relaxed);
+    for (;;) {
+      slot* cell = &m_slots[pos & m_mask];
+      const size_t seq = cell->m_sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+      if (diff == 0) {
+        if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          return cell;
+        }
+      } else if (diff < 0) {
+        // slot still holds the value of the previous lap, queue is full
+        return nullptr;
+      } else {
+        pos = m_tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Publishes the value of a claimed slot to the consumers.
+   * @param cell The slot returned by acquire_tail().
+   */
+  void release_tail(slot* cell) noexcept {
+    const size_t seq = cell->m_sequence.load(std::memory_order_relaxed);
+    cell->m_sequence.store(seq + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Claims the slot at the head of the queue.
+   * @return The claimed slot, or nullptr if the queue is empty.
+   */
+  slot* acquire_head() noexcept {
+    size_t pos = m_head.load(std::memory_order_relaxed);
+    for (;;) {
+      slot* cell = &m_slots[pos & m_mask];
+      const size_t seq = cell->m_sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          return cell;
+        }
+      } else if (diff < 0) {
+        // slot not yet written in this lap, queue is empty
+        return nullptr;
+      } else {
+        pos = m_head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Destroys the value of a claimed slot and hands the slot to the producers of the next lap.
+   * @param cell The slot returned by acquire_head().
+   */
+  void release_head(slot* cell) noexcept {
+    const size_t seq = cell->m_sequence.load(std::memory_order_relaxed);
+    cell->data()->~T();
+    cell->m_sequence.store(seq + m_mask, std::memory_order_release);
+  }
+
+  /**
+   * @brief Determines the next power of 2 for a given number.
+   * @param num The number to find the next power of 2 for.
+   * @return The next power of 2 for the given number.
+   */
+  static size_t nextPowerOf2(size_t num) {
+    size_t res = 1;
+    while (res < num) {
+      res <<= 1;
+    }
+    return res;
+  }
+};
+
+}   //namespace cppsl::container
@@ -18,10 +18,18 @@
 //-----------------------------------------------------------------------------
 // includes
 //-----------------------------------------------------------------------------
+#include <algorithm>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <stop_token>
+#include <utility>
+
+#include <cppsl/container/details/consumerWaiters.hpp>
+#include <cppsl/container/overflowPolicy.hpp>
 
 //----------------------------------------------------------------------------
 // Public Prototypes
@@ -32,6 +40,15 @@ namespace cppsl::container {
 /**
  * @class QueueSafe
  * @brief A thread-safe implementation of a queue with a mutex and condition variable.
+ *
+ * Blocking pops can be bounded by a timeout and interrupted by a std::stop_token.
+ * Batch pops wait until a minimum number of elements is queued, producers wake
+ * such a consumer only once the batch is complete.
+ *
+ * The queue may be bounded. A push into a full queue then follows the OverflowPolicy,
+ * blocked producers wait on a second condition variable that consumers signal only
+ * while a producer is blocked.
+ *
  * @tparam T The type of elements to be stored in the queue.
  */
 template <typename T>
@@ -40,31 +57,78 @@ class QueueSafe {
   /// private variables
   mutable std::mutex mut;
   std::queue<T> data_queue;
-  std::condition_variable data_cond;
+  std::condition_variable_any data_cond;
+  std::condition_variable_any not_full_cond;
+  details::ConsumerWaiters waiters;
+  size_t capacity_limit{unboundedCapacity};
+  OverflowPolicy overflow_policy{OverflowPolicy::block};
+  size_t blocked_producers{0};
+  OverflowCounters counters;
 
  public:
   /**
-   * @brief Default constructor.
+   * @brief Default constructor. The queue is unbounded.
    */
   QueueSafe() {}
 
+  /**
+   * @brief Constructs a bounded queue.
+   * @param capacity The maximal number of elements, or unboundedCapacity.
+   * @param policy What a push does when the queue is full.
+   */
+  explicit QueueSafe(size_t capacity, OverflowPolicy policy = OverflowPolicy::block)
+      : capacity_limit(capacity), overflow_policy(policy) {}
+
   /**
    * @brief copy constructor
    */
   QueueSafe(QueueSafe const& other) {
     std::lock_guard lk(other.mut);
     data_queue = other.data_queue;
+    capacity_limit = other.capacity_limit;
+    overflow_policy = other.overflow_policy;
   }
 
   /**
-   * @brief Inserts a new value into the queue.
+   * @brief Inserts a copy of a new value into the queue.
    * @tparam T The type of elements in the queue.
    * @param new_value The new value to insert.
+   * @return true if the value was inserted, false if it was dropped or rejected by the overflow policy.
    */
-  void push(T new_value) {
-    std::lock_guard lk(mut);
-    data_queue.push(new_value);
-    data_cond.notify_one();
+  bool push(const T& new_value) { return insert({}, new_value); }
+
+  /**
+   * @brief Moves a new value into the queue.
+   * @tparam T The type of elements in the queue.
+   * @param new_value The new value to insert.
+   * @return true if the value was inserted, false if it was dropped or rejected by the overflow policy.
+   */
+  bool push(T&& new_value) { return insert({}, std::move(new_value)); }
+
+  /**
+   * @brief Inserts a copy of a new value, a producer blocked on a full queue gives up on stop.
+   * @param new_value The new value to insert.
+   * @param stoken The stop token interrupting a blocked push.
+   * @return true if the value was inserted, false if it was dropped, rejected or the wait was stopped.
+   */
+  bool push(const T& new_value, std::stop_token stoken) { return insert(std::move(stoken), new_value); }
+
+  /**
+   * @brief Moves a new value into the queue, a producer blocked on a full queue gives up on stop.
+   * @param new_value The new value to insert.
+   * @param stoken The stop token interrupting a blocked push.
+   * @return true if the value was inserted, false if it was dropped, rejected or the wait was stopped.
+   */
+  bool push(T&& new_value, std::stop_token stoken) { return insert(std::move(stoken), std::move(new_value)); }
+
+  /**
+   * @brief Constructs a new element in place at the end of the queue.
+   * @param args Arguments forwarded to the constructor of T.
+   * @return true if the element was inserted, false if it was dropped or rejected by the overflow policy.
+   */
+  template <typename... Args>
+  bool emplace(Args&&... args) {
+    return insert({}, std::forward<Args>(args)...);
   }
 
   /**
@@ -74,9 +138,10 @@ class QueueSafe {
    */
   void wait_and_pop(T& value) {
     std::unique_lock lk(mut);
-    data_cond.wait(lk, [this] { return !data_queue.empty(); });
-    value = data_queue.front();
+    wait_items(lk, 1);
+    value = std::move(data_queue.front());
     data_queue.pop();
+    released(1);
   }
 
   /**
@@ -86,12 +151,115 @@ class QueueSafe {
    */
   std::shared_ptr<T> wait_and_pop() {
     std::unique_lock lk(mut);
-    data_cond.wait(lk, [this] { return !data_queue.empty(); });
-    std::shared_ptr<T> res(std::make_shared<T>(data_queue.front()));
+    wait_items(lk, 1);
+    std::shared_ptr<T> res(std::make_shared<T>(std::move(data_queue.front())));
+    data_queue.pop();
+    released(1);
+    return res;
+  }
+
+  /**
+   * @brief Waits until the queue is not empty and moves the front element out of the queue.
+   * @tparam T The type of elements in the queue.
+   * @return The popped element.
+   */
+  T wait_and_pop_value() {
+    std::unique_lock lk(mut);
+    wait_items(lk, 1);
+    T res(std::move(data_queue.front()));
     data_queue.pop();
+    released(1);
     return res;
   }
 
+  /**
+   * @brief Waits until the queue is not empty or a stop is requested, then pops the front element.
+   * @tparam T The type of elements in the queue.
+   * @param value A reference to a variable where the popped element will be moved.
+   * @param stoken The stop token interrupting the wait.
+   * @return true if an element was popped, false if the wait was stopped.
+   */
+  bool wait_and_pop(T& value, std::stop_token stoken) {
+    std::unique_lock lk(mut);
+    if (!wait_items(lk, 1, std::move(stoken))) {
+      return false;
+    }
+    value = std::move(data_queue.front());
+    data_queue.pop();
+    released(1);
+    return true;
+  }
+
+  /**
+   * @brief Waits at most timeout until the queue is not empty, then pops the front element.
+   * @param value A reference to a variable where the popped element will be moved.
+   * @param timeout The maximal time to wait.
+   * @param stoken The stop token interrupting the wait.
+   * @return true if an element was popped, false on timeout or stop.
+   */
+  template <typename Rep, typename Period>
+  bool wait_for_and_pop(T& value, const std::chrono::duration<Rep, Period>& timeout, std::stop_token stoken = {}) {
+    return wait_until_and_pop(value, std::chrono::steady_clock::now() + timeout, std::move(stoken));
+  }
+
+  /**
+   * @brief Waits until the deadline for the queue to be not empty, then pops the front element.
+   * @param value A reference to a variable where the popped element will be moved.
+   * @param deadline The time point at which the wait gives up.
+   * @param stoken The stop token interrupting the wait.
+   * @return true if an element was popped, false on timeout or stop.
+   */
+  template <typename Clock, typename Duration>
+  bool wait_until_and_pop(T& value, const std::chrono::time_point<Clock, Duration>& deadline,
+                          std::stop_token stoken = {}) {
+    std::unique_lock lk(mut);
+    if (!wait_items_until(lk, 1, deadline, std::move(stoken))) {
+      return false;
+    }
+    value = std::move(data_queue.front());
+    data_queue.pop();
+    released(1);
+    return true;
+  }
+
+  /**
+   * @brief Waits at most timeout until min_count elements are queued, then pops up to max_count elements.
+   * @param out The destination of the popped elements.
+   * @param min_count The number of elements the wait is satisfied with.
+   * @param max_count The maximal number of elements to pop.
+   * @param timeout The maximal time to wait.
+   * @param stoken The stop token interrupting the wait.
+   * @return The number of elements popped, less than min_count on timeout or stop.
+   */
+  template <typename OutputIt, typename Rep, typename Period>
+  size_t wait_for_and_pop_batch(OutputIt out, size_t min_count, size_t max_count,
+                                const std::chrono::duration<Rep, Period>& timeout, std::stop_token stoken = {}) {
+    return wait_until_and_pop_batch(out, min_count, max_count, std::chrono::steady_clock::now() + timeout,
+                                    std::move(stoken));
+  }
+
+  /**
+   * @brief Waits until the deadline for min_count elements, then pops up to max_count elements.
+   * @param out The destination of the popped elements.
+   * @param min_count The number of elements the wait is satisfied with.
+   * @param max_count The maximal number of elements to pop.
+   * @param deadline The time point at which the wait gives up.
+   * @param stoken The stop token interrupting the wait.
+   * @return The number of elements popped, less than min_count on timeout or stop.
+   */
+  template <typename OutputIt, typename Clock, typename Duration>
+  size_t wait_until_and_pop_batch(OutputIt out, size_t min_count, size_t max_count,
+                                  const std::chrono::time_point<Clock, Duration>& deadline, std::stop_token stoken = {}) {
+    std::unique_lock lk(mut);
+    wait_items_until(lk, std::min(min_count, max_count), deadline, std::move(stoken));
+    const size_t count = std::min(data_queue.size(), max_count);
+    for (size_t i = 0; i < count; ++i, data_queue.pop()) {
+      *out++ = std::move(data_queue.front());
+    }
+    released(count);
+    return count;
+  }
+
   /**
    * @brief immediately return false if no data, or pop first
    * @tparam T The type of elements to be stored in the queue.
@@ -101,8 +269,9 @@ class QueueSafe {
     if (data_queue.empty()) {
       return false;
     }
-    value = data_queue.front();
+    value = std::move(data_queue.front());
     data_queue.pop();
+    released(1);
     return (true);
   }
 
@@ -116,8 +285,55 @@ class QueueSafe {
     if (data_queue.empty()) {
       return std::shared_ptr<T>();
     }
-    std::shared_ptr<T> res(std::make_shared<T>(data_queue.front()));
+    std::shared_ptr<T> res(std::make_shared<T>(std::move(data_queue.front())));
     data_queue.pop();
+    released(1);
+    return res;
+  }
+
+  /**
+   * @brief Immediately returns std::nullopt or moves the front element out of the queue.
+   * @tparam T The type of elements in the queue.
+   * @return The popped element, or std::nullopt if the queue is empty.
+   */
+  std::optional<T> try_pop_value() {
+    std::lock_guard lk(mut);
+    if (data_queue.empty()) {
+      return std::nullopt;
+    }
+    std::optional<T> res(std::move(data_queue.front()));
+    data_queue.pop();
+    released(1);
+    return res;
+  }
+
+  /**
+   * @brief Moves all elements out of the queue in FIFO order under one lock acquisition.
+   * @tparam OutputIt The output iterator type.
+   * @param out The destination of the elements.
+   * @return The number of elements popped.
+   */
+  template <typename OutputIt>
+  size_t pop_all(OutputIt out) {
+    std::lock_guard lk(mut);
+    const size_t count = data_queue.size();
+    for (; !data_queue.empty(); data_queue.pop()) {
+      *out++ = std::move(data_queue.front());
+    }
+    released(count);
+    return count;
+  }
+
+  /**
+   * @brief Takes the whole content of the queue by swapping it with an empty one.
+   * @tparam T The type of elements in the queue.
+   * @return The former content of the queue.
+   */
+  std::queue<T> swap_out() {
+    std::queue<T> res;
+    std::lock_guard lk(mut);
+    res.swap(data_queue);
+    released(res.size());
     return res;
   }
 
@@ -131,6 +347,27 @@ class QueueSafe {
     return data_queue.empty();
   }
 
+  /**
+   * @brief Returns the capacity of the queue.
+   * @return The maximal number of elements, or unboundedCapacity.
+   */
+  size_t capacity() const noexcept { return capacity_limit; }
+
+  /**
+   * @brief Returns the overflow policy of the queue.
+   * @return The policy applied when the queue is full.
+   */
+  OverflowPolicy policy() const noexcept { return overflow_policy; }
+
+  /**
+   * @brief Returns the backpressure counters.
+   * @return A snapshot of the dropped, blocked and rejected counters.
+   */
+  OverflowCounters overflow_counters() const {
+    std::lock_guard lk(mut);
+    return counters;
+  }
+
   /**
    * @brief Returns the size of the queue.
    * @tparam T The type of elements in the queue.
@@ -140,6 +377,90 @@ class QueueSafe {
     std::lock_guard lk(mut);
     return data_queue.size();
   }
+
+ private:
+  /**
+   * @brief Inserts a new element, applying the overflow policy if the queue is full.
+   * @param stoken The stop token interrupting a blocked push.
+   * @param args Arguments forwarded to the constructor of T.
+   * @return true if the element was inserted.
+   */
+  template <typename... Args>
+  bool insert(std::stop_token stoken, Args&&... args) {
+    std::unique_lock lk(mut);
+    if (capacity_limit != unboundedCapacity && data_queue.size() >= capacity_limit) {
+      switch (overflow_policy) {
+        case OverflowPolicy::block: {
+          ++counters.blocked;
+          ++blocked_producers;
+          const bool room = not_full_cond.wait(lk, std::move(stoken),
+                                               [this] { return data_queue.size() < capacity_limit; });
+          --blocked_producers;
+          if (!room) {
+            ++counters.rejected;
+            return false;
+          }
+          break;
+        }
+        case OverflowPolicy::dropNewest:
+          ++counters.dropped;
+          return false;
+        case OverflowPolicy::dropOldest:
+          data_queue.pop();
+          ++counters.dropped;
+          break;
+        case OverflowPolicy::fail:
+          ++counters.rejected;
+          return false;
+      }
+    }
+    data_queue.emplace(std::forward<Args>(args)...);
+    waiters.notify(data_cond, data_queue.size());
+    return true;
+  }
+
+  /**
+   * @brief Wakes producers blocked on the full queue after elements were removed.
+   * @param count The number of removed elements.
+   */
+  void released(size_t count) {
+    if (blocked_producers == 0 || count == 0) {
+      return;
+    }
+    if (count == 1) {
+      not_full_cond.notify_one();
+    } else {
+      not_full_cond.notify_all();
+    }
+  }
+
+  /**
+   * @brief Waits with the lock held until the queue contains wanted elements or a stop is requested.
+   * @param lk The lock of mut.
+   * @param wanted The number of elements to wait for.
+   * @param stoken The stop token interrupting the wait.
+   * @return true if the queue contains wanted elements.
+   */
+  bool wait_items(std::unique_lock<std::mutex>& lk, size_t wanted, std::stop_token stoken = {}) {
+    details::ConsumerWaiters::Registration registration(waiters, wanted);
+    return data_cond.wait(lk, std::move(stoken), [this, wanted] { return data_queue.size() >= wanted; });
+  }
+
+  /**
+   * @brief Waits with the lock held until the queue contains wanted elements, the deadline passes or a stop is requested.
+   * @param lk The lock of mut.
+   * @param wanted The number of elements to wait for.
+   * @param deadline The time point at which the wait gives up.
+   * @param stoken The stop token interrupting the wait.
+   * @return true if the queue contains wanted elements.
+   */
+  template <typename Clock, typename Duration>
+  bool wait_items_until(std::unique_lock<std::mutex>& lk, size_t wanted,
+                        const std::chrono::time_point<Clock, Duration>& deadline, std::stop_token stoken) {
+    details::ConsumerWaiters::Registration registration(waiters, wanted);
+    return data_cond.wait_until(lk, std::move(stoken), deadline,
+                                [this, wanted] { return data_queue.size() >= wanted; });
+  }
 };
 
 }   // namespace cppsl::container
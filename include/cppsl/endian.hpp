@@ -0,0 +1,266 @@
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * @brief  contains endian storage wrappers and a packed view of wire formats.
+ * @ingroup CPPSL
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <cppsl/byteSwap.hpp>
+#include <cppsl/result.hpp>
+
+// the library definitions of src/CMakeLists.txt must match the compiler
+#if defined(_BENDIAN)
+static_assert(std::endian::native == std::endian::big, "_BENDIAN is defined for a little endian target");
+#elif defined(_LENDIAN)
+static_assert(std::endian::native == std::endian::little, "_LENDIAN is defined for a big endian target");
+#endif
+
+//----------------------------------------------------------------------------
+// Public Function Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl {
+
+/**
+ * @class EndianValue
+ * @brief A value stored in a fixed byte order.
+ *
+ * The wrapper holds the bytes of T as they are on the wire, without padding and with alignment 1,
+ * so structs of wrappers describe a frame layout exactly. The byte order is converted on access,
+ * the decision is made at compile time from std::endian.
+ *
+ * @tparam T The arithmetic or enum type of the value.
+ * @tparam E The byte order of the storage.
+ */
+template <typename T, std::endian E>
+class EndianValue {
+  static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "T must be arithmetic or an enum");
+
+ public:
+  using value_type = T;
+
+  /// swap type of ByteSwapper that converts between the storage and the machine
+  static constexpr ByteSwapper::SwapType swapType =
+     E == std::endian::big ? ByteSwapper::SwapType::LE : ByteSwapper::SwapType::BE;
+
+  /**
+   * @brief Constructs a zero value.
+   */
+  constexpr EndianValue() noexcept = default;
+
+  /**
+   * @brief Constructs the storage of a value.
+   * @param val The value in machine byte order.
+   */
+  EndianValue(T val) noexcept { set(val); }   // NOLINT(google-explicit-constructor)
+
+  /**
+   * @brief Returns the value in machine byte order.
+   * @return The value.
+   */
+  [[nodiscard]] T get() const noexcept {
+    T val;
+    std::memcpy(&val, m_bytes.data(), sizeof(T));
+    return ByteSwapper::Swap<swapType>(val);
+  }
+
+  /**
+   * @brief Stores a value.
+   * @param val The value in machine byte order.
+   */
+  void set(T val) noexcept {
+    val = ByteSwapper::Swap<swapType>(val);
+    std::memcpy(m_bytes.data(), &val, sizeof(T));
+  }
+
+  /**
+   * @brief Returns the value in machine byte order.
+   */
+  operator T() const noexcept { return get(); }   // NOLINT(google-explicit-constructor)
+
+  /**
+   * @brief Stores a value.
+   * @param val The value in machine byte order.
+   * @return This wrapper.
+   */
+  EndianValue& operator=(T val) noexcept {
+    set(val);
+    return *this;
+  }
+
+ private:
+  std::array<std::byte, sizeof(T)> m_bytes{};   ///< the value in storage byte order
+};
+
+static_assert(sizeof(EndianValue<uint32_t, std::endian::big>) == 4 && alignof(EndianValue<uint32_t, std::endian::big>) == 1);
+
+/// A value stored in network byte order.
+template <typename T>
+using BigEndian = EndianValue<T, std::endian::big>;
+
+/// A value stored in little endian byte order.
+template <typename T>
+using LittleEndian = EndianValue<T, std::endian::little>;
+
+/**
+ * @class PackedView
+ * @brief A read-only view of a received packet.
+ *
+ * Fields are read straight from the packet buffer at byte offsets, without alignment requirements
+ * and without a copy of the whole frame. Get() reads one arithmetic field in the given byte order,
+ * Read() copies a struct of EndianValue fields whose values are converted when they are accessed.
+ */
+class PackedView {
+ public:
+  /**
+   * @brief Constructs an empty view.
+   */
+  constexpr PackedView() noexcept = default;
+
+  /**
+   * @brief Constructs a view of a buffer.
+   * @param data The packet bytes.
+   */
+  explicit constexpr PackedView(std::span<const std::byte> data) noexcept : m_data(data) {}
+
+  /**
+   * @brief Reads a field, checking the bounds.
+   * @tparam T The arithmetic or enum type of the field.
+   * @tparam E The byte order of the field, network byte order by default.
+   * @param offset The byte offset of the field.
+   * @return The value in machine byte order.
+   * @exception out_of_range if the field exceeds the view.
+   */
+  template <typename T, std::endian E = std::endian::big>
+  [[nodiscard]] T Get(size_t offset) const {
+    Check(offset, sizeof(T));
+    return Load<T, E>(offset);
+  }
+
+  /**
+   * @brief Reads a field if it lies within the view.
+   * @tparam T The arithmetic or enum type of the field.
+   * @tparam E The byte order of the field, network byte order by default.
+   * @param offset The byte offset of the field.
+   * @return The value, invalid if the field exceeds the view.
+   */
+  template <typename T, std::endian E = std::endian::big>
+  [[nodiscard]] ResultOptVal<T> TryGet(size_t offset) const noexcept {
+    if (!Contains(offset, sizeof(T))) {
+      return ResultOptVal<T>();
+    }
+    return ResultOptVal<T>(Load<T, E>(offset));
+  }
+
+  /**
+   * @brief Copies a wire struct, e.g. a header made of BigEndian fields.
+   * @tparam S The struct, trivially copyable with alignment 1.
+   * @param offset The byte offset of the struct.
+   * @return The struct.
+   * @exception out_of_range if the struct exceeds the view.
+   */
+  template <typename S>
+  [[nodiscard]] S Read(size_t offset) const {
+    static_assert(std::is_trivially_copyable_v<S>, "S must be trivially copyable");
+    static_assert(alignof(S) == 1, "S must consist of EndianValue or byte fields");
+    Check(offset, sizeof(S));
+    S res;
+    std::memcpy(&res, m_data.data() + offset, sizeof(S));
+    return res;
+  }
+
+  /**
+   * @brief Returns a part of the view, e.g. the value of a TLV element.
+   * @param offset The first byte.
+   * @param count The number of bytes, up to the end by default.
+   * @return The partial view.
+   * @exception out_of_range if the part exceeds the view.
+   */
+  [[nodiscard]] PackedView Sub(size_t offset, size_t count = std::dynamic_extent) const {
+    if (count == std::dynamic_extent) {
+      Check(offset, 0);
+      count = m_data.size() - offset;
+    }
+    Check(offset, count);
+    return PackedView(m_data.subspan(offset, count));
+  }
+
+  /**
+   * @brief Returns the bytes of the view.
+   * @return The bytes.
+   */
+  [[nodiscard]] constexpr std::span<const std::byte> Data() const noexcept { return m_data; }
+
+  /**
+   * @brief Returns the size of the view.
+   * @return The number of bytes.
+   */
+  [[nodiscard]] constexpr size_t Size() const noexcept { return m_data.size(); }
+
+  /**
+   * @brief Checks whether the view is empty.
+   * @return true if the view has no bytes.
+   */
+  [[nodiscard]] constexpr bool Empty() const noexcept { return m_data.empty(); }
+
+ private:
+  /**
+   * @brief Checks whether a field lies within the view.
+   * @param offset The byte offset.
+   * @param size The field size.
+   * @return true if the field fits.
+   */
+  [[nodiscard]] bool Contains(size_t offset, size_t size) const noexcept {
+    return offset <= m_data.size() && size <= m_data.size() - offset;
+  }
+
+  /**
+   * @brief Throws if a field does not lie within the view.
+   * @param offset The byte offset.
+   * @param size The field size.
+   */
+  void Check(size_t offset, size_t size) const {
+    if (!Contains(offset, size)) {
+      throw std::out_of_range("packed field at " + std::to_string(offset) + " of " + std::to_string(size) +
+                              " bytes exceeds the " + std::to_string(m_data.size()) + " bytes");
+    }
+  }
+
+  /**
+   * @brief Reads a field without bounds check.
+   * @param offset The byte offset.
+   * @return The value in machine byte order.
+   */
+  template <typename T, std::endian E>
+  [[nodiscard]] T Load(size_t offset) const noexcept {
+    EndianValue<T, E> val;
+    std::memcpy(&val, m_data.data() + offset, sizeof(T));
+    return val.get();
+  }
+
+  std::span<const std::byte> m_data;   ///< the packet bytes
+};
+
+}   // namespace cppsl
@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * \brief   contains asynchronous file appender.
+ * \details Producers move their messages into a bounded lock-free queue and
+ * return; one background thread coalesces the messages into blocks and hands
+ * every block to the wrapped FileBaseAppender or FileRollAppender with a single
+ * write, so the producers never wait for the disk.
+ * \author  Alexander Sacharov
+ * \date    2024-06-03
+ * \ingroup
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <cppsl/container/overflowPolicy.hpp>
+#include <cppsl/container/queueLockFreeBounded.hpp>
+#include <cppsl/file/fileBaseAppender.hpp>
+#include <cppsl/memory/poolAllocator.hpp>
+
+//----------------------------------------------------------------------------
+// Public typedefs, structs, enums, unions and variables
+//----------------------------------------------------------------------------
+
+namespace cppsl::file {
+
+/// @brief Settings of the FileAsyncAppender
+struct FileAsyncConfig {
+  size_t queueCapacity{8192};                           ///< messages in the queue, rounded up to a power of 2
+  size_t blockSize{64 * 1024};                          ///< bytes coalesced into one write
+  std::chrono::milliseconds flushInterval{200};         ///< longest time a message waits in the block
+  container::OverflowPolicy policy{container::OverflowPolicy::block};   ///< behaviour on a full queue
+};
+
+//----------------------------------------------------------------------------
+// Public Function Prototypes
+//----------------------------------------------------------------------------
+
+/// @brief Asynchronous decorator of a file appender.
+///
+/// Any number of threads may call writeMessage(). The writer thread drains the
+/// queue into a block and writes it once the next message would exceed blockSize,
+/// once flushInterval has elapsed, on flush() and on destruction. Messages are never
+/// split, so a FileRollAppender target rolls over between whole messages.
+///
+/// The destructor stops accepting messages, writes everything still queued and
+/// flushes the target before it returns.
+class FileAsyncAppender {
+ public:
+  /// message storage, served by the memory pools
+  using Record = std::basic_string<char, std::char_traits<char>, memory::PoolAllocator<char>>;
+
+  /// Starts the writer thread.
+  /// \param target appender that receives the coalesced blocks
+  /// \param config queue, block and flush settings
+  explicit FileAsyncAppender(std::shared_ptr<FileBaseAppender> target, const FileAsyncConfig& config = {});
+
+  /// Drains the queue, flushes the target and joins the writer thread.
+  ~FileAsyncAppender();
+
+  FileAsyncAppender(const FileAsyncAppender&) = delete;
+  FileAsyncAppender& operator=(const FileAsyncAppender&) = delete;
+
+  /// Queues a message for the writer thread.
+  /// \param message message
+  /// \return true if queued, false if dropped or rejected by the overflow policy
+  [[nodiscard]] bool writeMessage(std::string_view message);
+
+  /// Waits until all messages queued before the call are written and the target is flushed.
+  void flush();
+
+  /// get the wrapped appender, only safe to use after flush() while no producer is active
+  [[nodiscard]] const std::shared_ptr<FileBaseAppender>& getTarget() const { return m_target; }
+
+  /// get the backpressure counters
+  [[nodiscard]] container::OverflowCounters counters() const;
+
+  /// get the number of write calls issued to the target
+  [[nodiscard]] size_t writes() const { return m_writes.load(std::memory_order_relaxed); }
+
+ private:
+  /// writer thread main loop
+  void run();
+
+  /// hands the block to the target and completes its messages
+  void writeBlock();
+
+  /// counts messages as written or dropped and wakes flush()
+  void complete(size_t messages);
+
+  /// gives back the ticket of a message that was not queued and wakes flush()
+  void returnTicket();
+
+  /// number of messages flush() waits for: its target, less the tickets given back meanwhile
+  [[nodiscard]] size_t flushTarget(size_t target) const;
+
+  /// checks whether a flush() waits for messages not yet written
+  [[nodiscard]] bool flushPending() const;
+
+  /// wakes the writer thread if it sleeps
+  void wakeWriter();
+
+  std::shared_ptr<FileBaseAppender> m_target;            ///< the appender doing the I/O
+  const FileAsyncConfig m_config;                        ///< settings
+  container::QueueLockFreeBounded<Record> m_queue;       ///< messages from the producers
+
+  std::string m_block;                                   ///< coalescing buffer, writer thread only
+  size_t m_blockRecords{0};                              ///< messages in m_block, writer thread only
+
+  std::atomic<size_t> m_queued{0};                       ///< tickets taken before a push, returned if not queued
+  std::atomic<size_t> m_completed{0};                    ///< messages written or dropped from the queue
+  std::atomic<uint32_t> m_progress{0};                   ///< changes on every completion and returned ticket
+  std::atomic<size_t> m_writes{0};                       ///< write calls issued to the target
+  std::atomic<size_t> m_dropped{0};                      ///< see OverflowCounters
+  std::atomic<size_t> m_blocked{0};                      ///< see OverflowCounters
+  std::atomic<size_t> m_rejected{0};                     ///< see OverflowCounters
+
+  std::atomic<bool> m_stop{false};                       ///< no more messages are accepted
+  std::atomic<size_t> m_flushTarget{0};                  ///< flush() waits until m_completed reaches it
+  std::atomic<bool> m_sleeping{false};                   ///< the writer waits on m_wakeup
+  std::mutex m_mutex;                                    ///< protects the sleep of the writer
+  std::condition_variable m_wakeup;                      ///< signals new messages, flush and stop
+
+  std::thread m_writer;                                  ///< the background thread, started last
+};
+
+}   // end namespace cppsl::file
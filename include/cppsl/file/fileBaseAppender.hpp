@@ -26,6 +26,8 @@
  *   - getMode()      : It returns the file open mode.
  *   - writeMessage() : This protected method is responsible for writing a log
  *                      message to the file.
+ *   - flush()        : This method hands the buffered data of the stream to the
+ *                      operating system.
  *
  *   Overall, the  `FileBaseAppender`  class provides functionality for logging messages
  *   to a file, managing the file open mode, and reopening or closing the log file.
@@ -118,6 +120,10 @@ class FileBaseAppender {
   /// \return true if successfully, otherwise - false
   [[nodiscard]] virtual bool writeMessage(std::string_view message);
 
+  /// Flushes the file stream.
+  /// \return true if successfully, otherwise - false
+  [[nodiscard]] virtual bool flush();
+
  protected:
   std::filesystem::path m_filePath;                                         ///< log file path
   std::fstream m_fs;                                                        ///< file stream
@@ -0,0 +1,172 @@
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * \brief   contains rolling file appender writing into memory mapped segments.
+ * \details Every segment is preallocated to the maximum file size and mapped
+ * shared. Writers reserve a range with one atomic fetch-add and copy the message
+ * into the mapping, the write path makes no system call. The kernel writes the
+ * pages back even if the process crashes; a segment that was not finished ends
+ * with zero bytes up to the preallocated size.
+ * \author  Alexander Sacharov
+ * \date    2024-06-10
+ * \ingroup
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include <cppsl/file/fileRollAppender.hpp>
+
+//----------------------------------------------------------------------------
+// Public Function Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::file {
+
+/// @brief Rolling FileAppender writing lock-free into preallocated memory mapped segments.
+///
+/// Any number of threads may call writeMessage(). The writer whose reservation
+/// crosses the end of the segment rolls over: it waits until the messages before
+/// its own are copied, stages the segment, renames the spare segment into place
+/// and retries; the others wait for the new segment. The spare is opened,
+/// preallocated and mapped ahead of time on the background thread of
+/// FileRollAppender, so a rollover costs two renames. Truncating the finished
+/// segment to its real length, msync, madvise(DONTNEED) and the renaming of the
+/// backups run on the background thread as well.
+///
+/// If no spare is ready, at the first rollover right after construction, after a
+/// failed preparation or a change of the maximum file size, the rolling writer
+/// maps the next segment itself and the other writers wait for the preallocation.
+///
+/// The file stream of FileBaseAppender is not used. A non-empty file found at
+/// construction is rolled over when append is true and truncated otherwise.
+///
+/// A file that cannot be staged keeps its data under its name; the following
+/// segments are mapped under staging names until the staging succeeds. If a
+/// segment cannot be mapped, the next write or rollOver() tries a new mapping.
+class FileMappedAppender : public FileRollAppender {
+ public:
+  /// Opens and maps the first segment.
+  /// \param filePath path of the current segment
+  /// \param maxFileSize segment size, preallocated and mapped
+  /// \param maxBackupIndex number of finished segments kept
+  /// \param append true to keep an existing file as backup, false to overwrite it
+  FileMappedAppender(const std::filesystem::path& filePath, size_t maxFileSize = maxRollFileAppenderSize,
+                     uint maxBackupIndex = maxRollFileAppenderBackIndex, bool append = true);
+
+  /// finishes the current segment and waits for the background thread
+  ~FileMappedAppender() override;
+
+  /// \brief checks whether a segment is mapped
+  /// \return true if mapped, otherwise - false
+  [[nodiscard]] bool isMapped() const { return m_segments[slotOf(m_cursor.load())].m_data.load() != nullptr; }
+
+  /**
+   * Copies the message into the current segment, rolls over if it is full.
+   * @param message The message, at most the segment size long.
+   * @return true if copied, false if the message does not fit into a segment or no segment is mapped.
+   */
+  [[nodiscard]] bool writeMessage(std::string_view message) override;
+
+  /**
+   * Starts the write back of the copied messages without waiting for it.
+   * @return true if successfully, otherwise - false
+   */
+  [[nodiscard]] bool flush() override;
+
+  /**
+   * Returns the number of bytes copied into the current segment.
+   * @return The size of the completed messages of the current segment.
+   */
+  [[nodiscard]] size_t getWrittenSize() const override;
+
+  /**
+   * Finishes the current segment and maps a new one.
+   */
+  void rollOver() override;
+
+  /**
+   * Starts a new segment, the mapped file is never reopened.
+   * @return true if a new segment is mapped, otherwise - false
+   */
+  [[nodiscard]] bool reopenFile() override;
+
+ private:
+  /// an opened, preallocated and mapped file
+  struct Mapping {
+    char* m_data{nullptr};         ///< start of the mapping, nullptr if mapping failed
+    size_t m_capacity{0};          ///< size of the mapping
+    int m_fd{-1};                  ///< descriptor of the file
+    std::filesystem::path m_path;  ///< name of the file
+  };
+
+  /// a mapped segment
+  struct Segment {
+    std::atomic<char*> m_data{nullptr};        ///< start of the mapping, nullptr if mapping failed
+    std::atomic<size_t> m_capacity{0};         ///< size of the mapping
+    std::atomic<uint64_t> m_generation{0};     ///< cursor generation the slot is mapped for
+    std::atomic<size_t> m_committed{0};        ///< bytes copied completely
+    int m_fd{-1};                              ///< descriptor of the segment file, roller only
+    std::filesystem::path m_path;              ///< name of the segment file, roller only
+  };
+
+  static constexpr unsigned offsetBits = 40;                          ///< low bits of the cursor
+  static constexpr uint64_t offsetMask = (uint64_t{1} << offsetBits) - 1;
+
+  /// slot of the segment of a cursor value
+  static size_t slotOf(uint64_t cursor) { return static_cast<size_t>(cursor >> offsetBits) & 1; }
+
+  /// next generation after the one of a cursor value
+  static uint64_t nextGeneration(uint64_t cursor) { return ((cursor >> offsetBits) + 1) & (~uint64_t{0} >> offsetBits); }
+
+  /// opens, preallocates and maps a file, removes the file on failure
+  static Mapping mapFile(const std::filesystem::path& path, size_t capacity);
+
+  /// unmaps, closes and removes a file mapped by mapFile() that holds no messages
+  static void discardMapping(Mapping& mapping);
+
+  /// puts the spare, or a file mapped now if none is ready, into the slot of a generation under a path
+  bool mapSegment(uint64_t generation, const std::filesystem::path& path);
+
+  /// prepares the spare on the background thread unless one is ready or in preparation, roller only
+  void prepareSpare();
+
+  /// removes the spares of former runs
+  void removeSpares() const;
+
+  /// name of the next segment: m_filePath, or a staging name while the current file cannot be staged
+  std::filesystem::path nextPath();
+
+  /// maps a new segment if the one of the cursor is still current and not mapped
+  bool remap(uint64_t cursor);
+
+  /// waits until the segment of the cursor is replaced by a rollover of another writer
+  void waitRoll(uint64_t cursor) const;
+
+  /// finishes the segment of the cursor, whose messages end at length, and maps the next one
+  void roll(uint64_t cursor, size_t length);
+
+  Segment m_segments[2];                   ///< current and previous segment
+  std::atomic<uint64_t> m_cursor{0};       ///< generation and reserved offset of the current segment
+  std::mutex m_rollMutex;                  ///< serializes the rollovers
+  bool m_pendingStage{false};              ///< m_filePath holds data that could not be staged, roller only
+  std::mutex m_spareMutex;                 ///< protects m_spare and m_sparePending
+  Mapping m_spare;                         ///< next segment mapped by the background thread
+  bool m_sparePending{false};              ///< a spare is in preparation
+  size_t m_spareCount{0};                  ///< makes the names of the spares unique, roller only
+};
+
+}   // end namespace cppsl::file
@@ -19,8 +19,17 @@
 //-----------------------------------------------------------------------------
 // includes <...>
 //-----------------------------------------------------------------------------
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
 #include <cppsl/file/fileBaseAppender.hpp>
 
+namespace cppsl::thread {
+class WorkerPool;
+}
+
 //----------------------------------------------------------------------------
 // Public Function Prototypes
 //----------------------------------------------------------------------------
@@ -33,17 +42,33 @@ static const size_t maxRollFileAppenderBackIndex = 10;           ///< max size o
 /// @brief this class implements a rolling FileAppender that rolls over the
 /// logfile once it has reached a certain size limit.
 ///
+/// The size of the current file is counted in memory. A rollover only renames the
+/// full file to a staging name and opens the new file; shifting, pruning and the
+/// optional compression of the backups run on a background thread, so the writing
+/// thread never waits for more than one rename.
+///
+/// Staging names carry the process id and the start time, so they are unique
+/// across runs. Staged files left behind by a crash are archived at construction,
+/// oldest first.
+///
 /// @author Alexander Sacharov (AS)
 /// @date   2015/03/13
 
 class FileRollAppender : public FileBaseAppender {
  public:
+  /// compresses the finished file src into dst
+  /// \return true if dst was written, the background thread then removes src
+  using Compressor = std::function<bool(const std::filesystem::path& src, const std::filesystem::path& dst)>;
+
   FileRollAppender(const std::filesystem::path& filePath, size_t maxFileSize = maxRollFileAppenderSize,
                    uint maxBackupIndex = maxRollFileAppenderBackIndex, bool append = true,
                    std::ios_base::openmode mode = std::ios_base::in | std::ios_base::out);
 
   FileRollAppender(const std::filesystem::path& filePath, bool append, std::ios_base::openmode mode);
 
+  /// waits for pending rollovers, then closes the file
+  ~FileRollAppender() override;
+
   /**
    * sets the maximum number of backup files that can be created for a particular log file.
    * If the number of log files exceeds this limit, the oldest log file will be deleted
@@ -73,10 +98,41 @@ class FileRollAppender : public FileBaseAppender {
   [[nodiscard]] virtual size_t getMaxFileSize() const;
 
   /**
-   * Performs a rollover of the log file, creating a new log file if the maximum file size has been reached.
+   * Sets the compression of the backup files, applied by the background thread.
+   * @param compressor The compression function, an empty function disables compression.
+   * @param suffix The suffix appended to the names of the compressed backups.
+   */
+  virtual void setCompressor(Compressor compressor, std::string suffix = ".gz");
+
+  /**
+   * Returns the number of bytes written to the current log file.
+   * @return The size counted since the file was opened.
+   */
+  [[nodiscard]] virtual size_t getWrittenSize() const { return m_written; }
+
+  /**
+   * Returns the number of rollovers, the index of the current file since construction.
+   * @return The number of files staged so far.
+   */
+  [[nodiscard]] size_t getRollCount() const { return m_rollCount.load(std::memory_order_acquire); }
+
+  /**
+   * Performs a rollover of the log file: the full file is staged, a new log file is opened
+   * and the backups are renamed in the background.
    */
   virtual void rollOver();
 
+  /**
+   * Waits until the background thread has renamed and compressed all staged files.
+   */
+  void waitRollOver();
+
+  /**
+   * Reopens the logfile and restarts the size count.
+   * @return true if the reopen succeeded, otherwise - false
+   */
+  [[nodiscard]] bool reopenFile() override;
+
   /**
    * Writes the given message to the log file.
    * @param message The message to be written to the log file.
@@ -84,8 +140,46 @@ class FileRollAppender : public FileBaseAppender {
   [[nodiscard]] virtual bool writeMessage(std::string_view message) override;
 
  protected:
+  /**
+   * Archives the staged files of former runs found beside the log file, oldest first.
+   */
+  void recoverStaged();
+
+  /**
+   * Renames the current file to a unique staging name. The file must be closed or
+   * written only through a descriptor that stays valid across the rename.
+   * @return The staging name, empty if the rename failed.
+   */
+  std::filesystem::path stageFile();
+
+  /**
+   * Returns a new staging name, unique within the process and across runs.
+   * @return Path beside the log file, "<file>.rolling.<pid>-<start time>.<count>".
+   */
+  std::filesystem::path stagingPath();
+
+  /**
+   * Shifts the backups and moves the staged file to index 1 on the background thread.
+   * @param staged The staging name returned by stageFile().
+   * @param prepare Work on the staged file done first on the background thread, may be empty.
+   */
+  void archiveStaged(std::filesystem::path staged, std::function<void()> prepare = {});
+
+  /**
+   * Runs a task on the background thread, after the archives submitted before.
+   * @param task The task, must not throw.
+   */
+  void submitHousekeeping(std::function<void()> task);
+
   uint m_maxBackupIndex;            ///< the maximum backup index allowed.
   uint16_t m_maxBackupIndexWidth;   ///< width, in terms of number of digits, of the maximum backup index
   size_t m_maxFileSize;             ///< represents the maximum file size allowed.
+  size_t m_written;                 ///< bytes written to the current file
+  std::atomic<size_t> m_rollCount{0};   ///< staged files, makes the staging names unique
+  std::string m_stageTag;           ///< process id and start time in the staging names
+  Compressor m_compressor;          ///< compression of the backups, may be empty
+  std::string m_compressSuffix;     ///< suffix of the compressed backups
+
+  std::unique_ptr<thread::WorkerPool> m_housekeeper;   ///< renames and compresses, started on the first rollover
 };
 }   // end namespace cppsl::file
@@ -23,8 +23,14 @@
 //-----------------------------------------------------------------------------
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <iterator>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 //-----------------------------------------------------------------------------
@@ -35,6 +41,8 @@
 #include <spdlog/sinks/base_sink.h>
 #include <spdlog/sinks/sink.h>
 
+#include <cppsl/container/details/epochDomain.hpp>
+
 //----------------------------------------------------------------------------
 // Public defines and macros
 //----------------------------------------------------------------------------
@@ -48,54 +56,187 @@
 //----------------------------------------------------------------------------
 
 namespace spdlog::sinks {
+   /**
+    * @brief Sends every message to the first sink that does not throw.
+    *
+    * The sinks are an immutable snapshot, swapped atomically by add_sink() and
+    * remove_sink() and freed after an epoch grace period, so log() takes no lock.
+    * The index of the sink that accepted the last message is remembered, a message
+    * normally costs one virtual call. A failed sink is skipped, not removed; the
+    * tiers after it are tried first, then the ones before it. Many sinks never
+    * throw from flush(), so by default the probe thread does not fail back on its
+    * own: it lets the next message try the first sink again, and only a message
+    * that sink accepts makes it the healthy one. A probe callback checking the
+    * preferred sinks directly may be given instead.
+    */
    class fallback_sink : public sink {
+      using sink_list = std::vector<std::shared_ptr<sink>>;
+
     public:
+      /// health check of a sink preferred to the healthy one, true to fail back to it
+      using probe_function = std::function<bool(sink &)>;
+
+      /**
+       * @brief Constructor
+       * @param probe_interval period of the health probe, zero disables fail back
+       * @param probe_fn health check run by the probe thread, empty to try the first sink with the next message
+       */
+      explicit fallback_sink(std::chrono::milliseconds probe_interval = std::chrono::seconds(5),
+                             probe_function probe_fn = {})
+         : _probe_interval(probe_interval), _probe_fn(std::move(probe_fn)) {
+        if (_probe_interval.count() > 0) {
+          _probe = std::thread([this] { probe_loop(); });
+        }
+      }
 
-      ~fallback_sink() {
-        _sinks_to_remove.clear();
-        _sinks.clear();
+      ~fallback_sink() override {
+        {
+          std::lock_guard<std::mutex> lock(_probe_mutex);
+          _stop = true;
+        }
+        _probe_cv.notify_all();
+        if (_probe.joinable()) {
+          _probe.join();
+        }
+        delete _sinks.load();
       }
 
+      fallback_sink(const fallback_sink &) = delete;
+      fallback_sink &operator=(const fallback_sink &) = delete;
+
       void log(const details::log_msg &msg) override {
-        for (auto &sink : _sinks) {
+        auto guard = _epochs.read_lock();
+        const auto &sinks = *_sinks.load(std::memory_order_acquire);
+        const auto count = sinks.size();
+        const auto healthy = _healthy.load(std::memory_order_relaxed);
+        auto first = healthy < count ? healthy : 0;
+        if (_trial.load(std::memory_order_relaxed) && _trial.exchange(false, std::memory_order_relaxed)) {
+          first = 0;
+        }
+        // the tiers after the first one, then the ones before it
+        for (size_t n = 0; n < count; ++n) {
+          const auto i = (first + n) % count;
           try {
-            sink->log(msg);
-            break;
+            sinks[i]->log(msg);
+            if (i != healthy) {
+              _healthy.store(i, std::memory_order_relaxed);
+            }
+            return;
           }
-          catch (const std::exception &ex) {
-            sink->flush();
-
-            _sinks_to_remove.push_back(sink);
+          catch (const std::exception &) {
+            // fall over to the next tier
+            _failovers.fetch_add(1, std::memory_order_relaxed);
           }
         }
+      }
 
-        if (!_sinks_to_remove.empty()) {
-          for (auto sink_to_remove : _sinks_to_remove) {
-            remove_sink(sink_to_remove);
+      void flush() override {
+        auto guard = _epochs.read_lock();
+        for (auto &sink : *_sinks.load(std::memory_order_acquire)) {
+          try {
+            sink->flush();
+          }
+          catch (const std::exception &) {
           }
-          _sinks_to_remove.clear();
         }
       }
 
-      void flush() override {
-        for (auto &sink : _sinks)
-          sink->flush();
+      void set_pattern(const std::string &pattern) override {
+        auto guard = _epochs.read_lock();
+        for (auto &sink : *_sinks.load(std::memory_order_acquire)) {
+          sink->set_pattern(pattern);
+        }
+      }
+
+      void set_formatter(std::unique_ptr<spdlog::formatter> sink_formatter) override {
+        auto guard = _epochs.read_lock();
+        for (auto &sink : *_sinks.load(std::memory_order_acquire)) {
+          sink->set_formatter(sink_formatter->clone());
+        }
       }
 
+      /// appends a sink with the lowest priority
       void add_sink(std::shared_ptr<sink> sink) {
-        _sinks.push_back(sink);
+        std::lock_guard<std::mutex> lock(_write_mutex);
+        auto next = std::make_unique<sink_list>(*_sinks.load(std::memory_order_relaxed));
+        next->push_back(std::move(sink));
+        publish(std::move(next));
       }
 
+      /// removes a sink, does nothing if it is not in the list
       void remove_sink(std::shared_ptr<sink> sink) {
-        auto pos = std::find(_sinks.begin(), _sinks.end(), sink);
+        std::lock_guard<std::mutex> lock(_write_mutex);
+        const auto &current = *_sinks.load(std::memory_order_relaxed);
+        if (std::find(current.begin(), current.end(), sink) == current.end()) {
+          return;
+        }
+        auto next = std::make_unique<sink_list>();
+        std::copy_if(current.begin(), current.end(), std::back_inserter(*next),
+                     [&sink](const auto &s) { return s != sink; });
+        publish(std::move(next));
+      }
 
-        _sinks.erase(pos);
+      /// index of the sink that accepted the last message
+      [[nodiscard]] size_t healthy_index() const { return _healthy.load(std::memory_order_relaxed); }
 
-      }
+      /// number of messages a sink refused with an exception
+      [[nodiscard]] size_t failovers() const { return _failovers.load(std::memory_order_relaxed); }
 
     private:
-      std::vector<std::shared_ptr<sink>> _sinks;
-      std::vector<std::shared_ptr<sink>> _sinks_to_remove;
+      /// swaps in the new list and frees the old one after the grace period, the caller holds _write_mutex
+      void publish(std::unique_ptr<sink_list> next) {
+        const sink_list *old = _sinks.exchange(next.release(), std::memory_order_acq_rel);
+        _healthy.store(0, std::memory_order_relaxed);
+        _epochs.synchronize();
+        delete old;
+      }
+
+      /// checks the sinks preferred to the healthy one, or lets the next message try the first one
+      void probe() {
+        auto guard = _epochs.read_lock();
+        const auto &sinks = *_sinks.load(std::memory_order_acquire);
+        const auto healthy = std::min(_healthy.load(std::memory_order_relaxed), sinks.size());
+        if (healthy == 0) {
+          return;
+        }
+        if (!_probe_fn) {
+          _trial.store(true, std::memory_order_relaxed);
+          return;
+        }
+        for (size_t i = 0; i < healthy; ++i) {
+          try {
+            if (_probe_fn(*sinks[i])) {
+              _healthy.store(i, std::memory_order_relaxed);
+              return;
+            }
+          }
+          catch (const std::exception &) {
+          }
+        }
+      }
+
+      void probe_loop() {
+        std::unique_lock<std::mutex> lock(_probe_mutex);
+        while (!_probe_cv.wait_for(lock, _probe_interval, [this] { return _stop; })) {
+          lock.unlock();
+          probe();
+          lock.lock();
+        }
+      }
+
+      std::atomic<const sink_list *> _sinks{new sink_list()};   ///< current snapshot, never null
+      std::atomic<size_t> _healthy{0};                         ///< sink that accepted the last message
+      std::atomic<size_t> _failovers{0};                       ///< see failovers()
+      std::atomic<bool> _trial{false};                         ///< the next message tries the first sink
+      std::mutex _write_mutex;                                 ///< serializes add_sink() and remove_sink()
+      cppsl::container::details::EpochDomain _epochs;          ///< grace periods of replaced snapshots
+
+      std::chrono::milliseconds _probe_interval;               ///< period of the health probe
+      probe_function _probe_fn;                                ///< health check, empty for a trial message
+      std::mutex _probe_mutex;                                 ///< protects _stop
+      std::condition_variable _probe_cv;                       ///< wakes the probe for shutdown
+      bool _stop{false};                                       ///< ends the probe thread
+      std::thread _probe;                                      ///< health probe, started last
    };
 }
 
@@ -8,6 +8,12 @@
 /*************************************************************************//**
  * @file
  * \brief       contains sink for syslog to remote server.
+ * \details     The "<PRI>ident: " prefix of every level is built once, each
+ * message is assembled in a reused buffer. With rsyslog_batch_config the
+ * messages are collected and sent with one sendmmsg() call when the count,
+ * size or age threshold is reached; the age is checked on the next message
+ * and on flush(), e.g. by spdlog::flush_every(). Messages the non-blocking
+ * socket refuses are counted, not retried.
  * \author      Alexander Sacharov <a.sacharov@gmx.de>
  * \date        2021-07-28
  *****************************************************************************/
@@ -24,10 +30,16 @@
 #include <arpa/inet.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <string>
-#include <map>
-#include <sstream>
+#include <vector>
 
 //-----------------------------------------------------------------------------
 // includes "..."
@@ -51,28 +63,59 @@
 
 namespace spdlog {
    namespace sinks {
+      /**
+       * Batching of rsyslog_sink, max_messages 0 or 1 sends every message at once.
+       */
+      struct rsyslog_batch_config {
+         size_t max_messages{0};                       ///< messages per sendmmsg() call
+         size_t max_bytes{64 * 1024};                  ///< flush when the batch holds this many bytes
+         std::chrono::milliseconds max_delay{100};     ///< flush when the oldest message waits this long
+      };
+
+      /**
+       * Send statistics of rsyslog_sink.
+       */
+      struct rsyslog_counters {
+         uint64_t sent{0};      ///< datagrams accepted by the socket
+         uint64_t eagain{0};    ///< datagrams refused by the non-blocking socket
+         uint64_t dropped{0};   ///< datagrams lost by other send errors
+      };
+
       /**
        * Sink that write to rsyslog using udp.
        */
       template<typename Mutex>
       class rsyslog_sink final : public base_sink<Mutex> {
 
-         std::map<int, int> m_mapSeveritySpd2Syslog = {
-            {   SPDLOG_LEVEL_CRITICAL, LOG_CRIT   }
-            , { SPDLOG_LEVEL_ERROR   , LOG_ERR    }
-            , { SPDLOG_LEVEL_WARN    , LOG_WARNING}
-            , { SPDLOG_LEVEL_INFO    , LOG_INFO }
-            , { SPDLOG_LEVEL_DEBUG   , LOG_DEBUG }
-            , { SPDLOG_LEVEL_TRACE   , LOG_DEBUG }
-            , { SPDLOG_LEVEL_OFF     , 0 }
-            ,};
-
-         const int m_log_buffer_max_size{16777216};   ///< 16K
-         struct sockaddr_in m_sockaddr;               ///< address
-         int m_fd{-1};                                ///< socket descriptor
-         int m_facility{0};                           ///< facility
-         std::string m_ident;                         ///< identity
-         std::string m_buffer;                        ///< buffer
+         /// syslog severity of the spdlog levels
+         static constexpr std::array<int, level::n_levels> m_severity = {
+            LOG_DEBUG,     // trace
+            LOG_DEBUG,     // debug
+            LOG_INFO,      // info
+            LOG_WARNING,   // warn
+            LOG_ERR,       // err
+            LOG_CRIT,      // critical
+            0              // off
+         };
+
+         static constexpr size_t m_datagram_max_size{65507};      ///< largest UDP payload over IPv4
+         const size_t m_log_buffer_max_size{m_datagram_max_size}; ///< limit of a single message
+         struct sockaddr_in m_sockaddr;                           ///< address
+         int m_fd{-1};                                            ///< socket descriptor
+         int m_facility{0};                                       ///< facility
+         std::string m_ident;                                     ///< identity
+         std::string m_buffer;                                    ///< buffer of a single message
+         std::array<std::string, level::n_levels> m_prefix;       ///< "<PRI>ident: " per level
+         memory_buf_t m_formatted;                                ///< reused formatter output
+         rsyslog_batch_config m_batch;                            ///< batching thresholds
+         std::string m_arena;                                     ///< messages of the batch
+         std::vector<size_t> m_offsets;                           ///< start of each message in m_arena
+         std::vector<struct iovec> m_iov;                         ///< one iovec per message
+         std::vector<struct mmsghdr> m_msgs;                      ///< one header per message
+         std::chrono::steady_clock::time_point m_batch_start;     ///< arrival of the oldest message
+         std::atomic<uint64_t> m_sent{0};                         ///< datagrams sent
+         std::atomic<uint64_t> m_eagain{0};                       ///< datagrams refused with EAGAIN
+         std::atomic<uint64_t> m_dropped{0};                      ///< datagrams lost by errors
 
       public:
          /**
@@ -81,22 +124,38 @@ namespace spdlog {
           * @param server_ip - remote server IP
           * @param facility - facility codes
           * @param port - port is 514
-          * @param log_buffer_max_size
+          * @param log_buffer_max_size - limit of a single message, capped at the UDP datagram size
           * @param enable_formatting
+          * @param batch - batching thresholds, disabled by default
           */
          rsyslog_sink(const std::string &ident,
                       const std::string &server_ip,
                       int facility,
                       int log_buffer_max_size,
                       uint16_t port,
-                      bool enable_formatting)
-            : m_log_buffer_max_size(log_buffer_max_size), m_facility(facility), m_ident(ident), m_enable_formatting(enable_formatting) {
+                      bool enable_formatting,
+                      const rsyslog_batch_config &batch = {})
+            : m_log_buffer_max_size(std::min(static_cast<size_t>(log_buffer_max_size), m_datagram_max_size)),
+              m_facility(facility), m_ident(ident),
+              m_batch(batch), m_enable_formatting(enable_formatting) {
+
+            if (log_buffer_max_size <= 0) {
+               SPDLOG_THROW(spdlog_ex("invalid maxLogSize"));
+            }
 
-            if (m_log_buffer_max_size > std::numeric_limits<int>::max()) {
-               SPDLOG_THROW(spdlog_ex("too large maxLogSize"));
+            // <%u>%s:
+            for (size_t lvl = 0; lvl < m_prefix.size(); ++lvl) {
+               m_prefix[lvl] = "<" + std::to_string(m_facility + m_severity[lvl]) + ">" + m_ident + ": ";
             }
 
-            m_buffer.reserve(m_log_buffer_max_size);
+            if (!batching()) {
+               m_buffer.reserve(m_log_buffer_max_size);
+            } else {
+               m_arena.reserve(m_batch.max_bytes + m_log_buffer_max_size);
+               m_offsets.reserve(m_batch.max_messages);
+               m_iov.resize(m_batch.max_messages);
+               m_msgs.resize(m_batch.max_messages);
+            }
             // socket
             memset(&m_sockaddr, 0, sizeof(m_sockaddr));
             m_sockaddr.sin_family = AF_INET;
@@ -111,6 +170,7 @@ namespace spdlog {
           * destructor
           */
          ~rsyslog_sink() override {
+            flush_batch();
             close(m_fd);
          }
 
@@ -120,6 +180,15 @@ namespace spdlog {
          rsyslog_sink(const rsyslog_sink &) = delete;
          rsyslog_sink &operator=(const rsyslog_sink &) = delete;
 
+         /**
+          * send statistics, may be read from any thread
+          * @return counters
+          */
+         rsyslog_counters counters() const {
+            return {m_sent.load(std::memory_order_relaxed), m_eagain.load(std::memory_order_relaxed),
+                    m_dropped.load(std::memory_order_relaxed)};
+         }
+
       protected:
          /**
           * sink message after severity filter
@@ -129,37 +198,113 @@ namespace spdlog {
 
             if( msg.level != level::off) {
                string_view_t payload;
-               memory_buf_t formatted;
                if (m_enable_formatting) {
-                  base_sink<Mutex>::formatter_->format(msg, formatted);
-                  payload = string_view_t(formatted.data(), formatted.size());
+                  m_formatted.clear();
+                  base_sink<Mutex>::formatter_->format(msg, m_formatted);
+                  payload = string_view_t(m_formatted.data(), m_formatted.size());
                }
                else {
                   payload = msg.payload;
                }
-               size_t length = payload.size();
-               // limit to max int
-               length = length > static_cast<size_t>(std::numeric_limits<int>::max()) ? static_cast<size_t>(std::numeric_limits<int>::max())
-                                                                                      : length;
-               std::stringstream ss;
-               // <%u>%s:
-               ss << "<" << m_facility + m_mapSeveritySpd2Syslog[msg.level] << ">" << m_ident << ": ";
-
-               m_buffer += ss.str();
-               length = length > m_log_buffer_max_size - m_buffer.size() ? m_log_buffer_max_size - m_buffer.size() : length;
-               if (length > 0) {
+               const std::string &prefix = m_prefix[msg.level];
+               const size_t room = m_log_buffer_max_size > prefix.size() ? m_log_buffer_max_size - prefix.size() : 0;
+               const size_t length = payload.size() > room ? room : payload.size();
+
+               if (!batching()) {
+                  m_buffer.assign(prefix);
                   m_buffer.append(payload.data(), length);
+                  send_one(m_buffer.data(), m_buffer.size());
+                  return;
+               }
+
+               const auto now = std::chrono::steady_clock::now();
+               if (!m_offsets.empty() && m_arena.size() + prefix.size() + length > m_batch.max_bytes) {
+                  flush_batch();
+               }
+               if (m_offsets.empty()) {
+                  m_batch_start = now;
+               }
+               m_offsets.push_back(m_arena.size());
+               m_arena.append(prefix);
+               m_arena.append(payload.data(), length);
+
+               if (m_offsets.size() >= m_batch.max_messages || m_arena.size() >= m_batch.max_bytes ||
+                   now - m_batch_start >= m_batch.max_delay) {
+                  flush_batch();
                }
-               if( write(m_fd, m_buffer.c_str(), m_buffer.size()) == -1) perror("write error");
-               m_buffer.clear();
             }
          }
 
-         void flush_() override {}
+         void flush_() override {
+            flush_batch();
+         }
 
          bool m_enable_formatting{false};
 
       private:
+         /**
+          * check whether messages are batched
+          * @return true for more than one message per batch
+          */
+         bool batching() const {
+            return m_batch.max_messages > 1;
+         }
+
+         /**
+          * send a single datagram
+          * @param data - datagram
+          * @param size - datagram size
+          */
+         void send_one(const char *data, size_t size) {
+            if (write(m_fd, data, size) == -1) {
+               if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                  m_eagain.fetch_add(1, std::memory_order_relaxed);
+               } else {
+                  m_dropped.fetch_add(1, std::memory_order_relaxed);
+                  perror("write error");
+               }
+            } else {
+               m_sent.fetch_add(1, std::memory_order_relaxed);
+            }
+         }
+
+         /**
+          * send the collected messages with sendmmsg()
+          */
+         void flush_batch() {
+            const size_t count = m_offsets.size();
+            if (count == 0) {
+               return;
+            }
+            for (size_t i = 0; i < count; ++i) {
+               const size_t end = i + 1 < count ? m_offsets[i + 1] : m_arena.size();
+               m_iov[i].iov_base = m_arena.data() + m_offsets[i];
+               m_iov[i].iov_len = end - m_offsets[i];
+               m_msgs[i] = {};
+               m_msgs[i].msg_hdr.msg_iov = &m_iov[i];
+               m_msgs[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            size_t done = 0;
+            while (done < count) {
+               const int res = sendmmsg(m_fd, m_msgs.data() + done, static_cast<unsigned>(count - done), 0);
+               if (res < 0) {
+                  if (errno == EINTR) {
+                     continue;
+                  }
+                  auto &counter = (errno == EAGAIN || errno == EWOULDBLOCK) ? m_eagain : m_dropped;
+                  // the failed datagram is lost, the rest is tried once more
+                  counter.fetch_add(1, std::memory_order_relaxed);
+                  ++done;
+                  continue;
+               }
+               m_sent.fetch_add(static_cast<uint64_t>(res), std::memory_order_relaxed);
+               done += static_cast<size_t>(res);
+            }
+            m_offsets.clear();
+            m_arena.clear();
+         }
+
          /**
           * open UDP socket
           */
@@ -188,9 +333,10 @@ namespace spdlog {
                                                     uint facility,
                                                     int log_buffer_max_size = 1024 * 1024 * 16,
                                                     uint16_t port = 514,
-                                                    bool enable_formatting = true) {
+                                                    bool enable_formatting = true,
+                                                    const sinks::rsyslog_batch_config &batch = {}) {
       return Factory::template create<sinks::rsyslog_sink_mt>(logger_name, ident, rsyslog_ip, facility, log_buffer_max_size, port,
-                                                              enable_formatting);
+                                                              enable_formatting, batch);
    }
 
    template<typename Factory = synchronous_factory>
@@ -200,9 +346,10 @@ namespace spdlog {
                                                     uint facility,
                                                     int log_buffer_max_size = 1024 * 1024 * 16,
                                                     uint16_t port = 514,
-                                                    bool enable_formatting = true) {
+                                                    bool enable_formatting = true,
+                                                    const sinks::rsyslog_batch_config &batch = {}) {
       return Factory::template create<sinks::rsyslog_sink_st>(logger_name, ident, rsyslog_ip, facility, log_buffer_max_size, port,
-                                                              enable_formatting);
+                                                              enable_formatting, batch);
    }
 
 } // namespace spdlog
@@ -0,0 +1,442 @@
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * \brief   contains binary structured trace log writer and reader.
+ * \details A trace event is a format id, a steady clock time stamp and the raw
+ * bytes of its arguments, nothing is formatted on the writing thread. The format
+ * strings and argument types are written once per file of the FileRollAppender,
+ * TraceReader renders the text offline.
+ *
+ * Records, all values in host byte order without padding:
+ *   - segment:  kind 1, magic, version, byte order, steady and system clock in ns
+ *   - format:   kind 2, id, argument count, argument types, length, format string
+ *   - event:    kind 3, length of the rest, id, steady clock in ns, arguments;
+ *               strings as length and bytes
+ *
+ * A zero kind ends the data, so the preallocated tail of a FileMappedAppender
+ * segment left by a crash is skipped. Events whose format is unknown are skipped
+ * by their length.
+ * \author  Alexander Sacharov
+ * \date    2024-06-17
+ * \ingroup
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <fmt/args.h>
+#include <fmt/format.h>
+
+#include <cppsl/file/fileRollAppender.hpp>
+#include <cppsl/time/watch.hpp>
+
+//----------------------------------------------------------------------------
+// Public typedefs, structs, enums, unions and variables
+//----------------------------------------------------------------------------
+
+namespace cppsl::log {
+
+/// kind of a trace record, the first byte of every record
+enum class TraceRecord : uint8_t { end = 0, segment = 1, format = 2, event = 3 };
+
+/// type of a trace argument
+enum class TraceType : uint8_t { i8 = 1, i16, i32, i64, u8, u16, u32, u64, f32, f64, boolean, character, string };
+
+inline constexpr uint32_t traceMagic = 0x43545231;   ///< "CTR1"
+inline constexpr uint8_t traceVersion = 2;           ///< version of the record layout
+inline constexpr size_t traceMaxString = 0xffff;     ///< longer string arguments are truncated
+
+/// @brief maps an argument type to its trace type
+template <typename T>
+constexpr TraceType traceTypeOf() {
+  using U = std::remove_cvref_t<T>;
+  if constexpr (std::is_same_v<U, bool>) {
+    return TraceType::boolean;
+  } else if constexpr (std::is_same_v<U, char>) {
+    return TraceType::character;
+  } else if constexpr (std::is_same_v<U, float>) {
+    return TraceType::f32;
+  } else if constexpr (std::is_same_v<U, double>) {
+    return TraceType::f64;
+  } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+    constexpr std::array types{TraceType::i8, TraceType::i16, TraceType::i32, TraceType::i64};
+    return types[std::bit_width(sizeof(U)) - 1];
+  } else if constexpr (std::is_integral_v<U>) {
+    constexpr std::array types{TraceType::u8, TraceType::u16, TraceType::u32, TraceType::u64};
+    return types[std::bit_width(sizeof(U)) - 1];
+  } else {
+    static_assert(std::is_convertible_v<U, std::string_view>, "unsupported trace argument type");
+    return TraceType::string;
+  }
+}
+
+namespace details {
+/// next id of a TraceFormat, shared by all argument lists
+inline uint32_t nextTraceFormatId() {
+  static std::atomic<uint32_t> counter{0};
+  return counter.fetch_add(1, std::memory_order_relaxed);
+}
+}   // namespace details
+
+/// parameter type of a trace argument, string arguments are taken as views
+template <typename T>
+using TraceArg = std::conditional_t<traceTypeOf<T>() == TraceType::string, std::string_view, T>;
+
+/// @brief a format string with a process wide unique id, define it with static storage duration
+template <typename... Args>
+class TraceFormat {
+ public:
+  /// \param format fmt format string, must outlive the format
+  explicit TraceFormat(std::string_view format) : m_format(format), m_id(details::nextTraceFormatId()) {}
+
+  [[nodiscard]] uint32_t id() const { return m_id; }
+  [[nodiscard]] std::string_view format() const { return m_format; }
+
+  static constexpr std::array<TraceType, sizeof...(Args)> types{traceTypeOf<Args>()...};
+
+ private:
+  std::string_view m_format;
+  uint32_t m_id;
+};
+
+//----------------------------------------------------------------------------
+// Public Function Prototypes
+//----------------------------------------------------------------------------
+
+/// @brief Writes binary trace events to a rolling appender.
+///
+/// One writer per thread, or external locking. The record of an event and the
+/// definitions it needs go to the appender in one writeMessage() call. A
+/// FileMappedAppender rolls over before a record that does not fit, so such a
+/// record carries the definitions for the next file as well.
+class TraceWriter {
+ public:
+  using clock = time::StopWatch<std::chrono::nanoseconds>::clock;
+
+  /// \param target appender that receives the records
+  explicit TraceWriter(file::FileRollAppender& target) : m_target(target) { m_buffer.reserve(256); }
+
+  /// Writes one event.
+  /// \param format the format, defined once per file
+  /// \param args arguments converted to the types of the format
+  /// \return true if the appender accepted the record
+  template <typename... Args>
+  bool write(const TraceFormat<Args...>& format, const TraceArg<Args>&... args) {
+    m_buffer.clear();
+    const auto segment = m_target.getRollCount();
+    const bool started = !m_started || segment != m_segment;
+    if (started) {
+      m_started = true;
+      m_segment = segment;
+      m_defined.assign(m_defined.size(), false);
+      putSegment();
+    }
+    if (format.id() >= m_defined.size()) {
+      m_defined.resize(format.id() + 1, false);
+    }
+    if (!m_defined[format.id()]) {
+      m_defined[format.id()] = true;
+      putFormat(format.id(), format.types, format.format());
+    }
+
+    const auto head = m_buffer.size();
+    put(TraceRecord::event);
+    put(uint32_t{0});
+    put(format.id());
+    put(steadyNow());
+    (putArg(args), ...);
+    const auto length = static_cast<uint32_t>(m_buffer.size() - head - sizeof(TraceRecord) - sizeof(uint32_t));
+    std::memcpy(m_buffer.data() + head + sizeof(TraceRecord), &length, sizeof(length));
+
+    if (!started && m_target.getWrittenSize() + m_buffer.size() > m_target.getMaxFileSize()) {
+      // the record may open the next file, the roll count then makes the next write define its formats again
+      m_event.assign(m_buffer.begin() + static_cast<std::ptrdiff_t>(head), m_buffer.end());
+      m_buffer.clear();
+      putSegment();
+      putFormat(format.id(), format.types, format.format());
+      m_buffer.insert(m_buffer.end(), m_event.begin(), m_event.end());
+    }
+    return m_target.writeMessage({reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size()});
+  }
+
+ private:
+  static int64_t steadyNow() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+  }
+
+  template <typename T>
+  void put(const T& value) {
+    const auto pos = m_buffer.size();
+    m_buffer.resize(pos + sizeof(T));
+    std::memcpy(m_buffer.data() + pos, &value, sizeof(T));
+  }
+
+  void putBytes(std::string_view bytes) {
+    const auto n = std::min(bytes.size(), traceMaxString);
+    put(static_cast<uint16_t>(n));
+    m_buffer.insert(m_buffer.end(), reinterpret_cast<const std::byte*>(bytes.data()),
+                    reinterpret_cast<const std::byte*>(bytes.data()) + n);
+  }
+
+  template <typename T>
+  void putArg(const T& value) {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      putBytes(value);
+    } else {
+      put(value);
+    }
+  }
+
+  void putSegment() {
+    put(TraceRecord::segment);
+    put(traceMagic);
+    put(traceVersion);
+    put(static_cast<uint8_t>(std::endian::native == std::endian::little));
+    put(steadyNow());
+    put(static_cast<int64_t>(
+       std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count()));
+  }
+
+  template <size_t N>
+  void putFormat(uint32_t id, const std::array<TraceType, N>& types, std::string_view format) {
+    put(TraceRecord::format);
+    put(id);
+    put(static_cast<uint8_t>(N));
+    for (auto type : types) {
+      put(type);
+    }
+    putBytes(format);
+  }
+
+  file::FileRollAppender& m_target;   ///< destination of the records
+  std::vector<std::byte> m_buffer;    ///< record under construction, reused
+  std::vector<std::byte> m_event;     ///< event moved behind new definitions, reused
+  std::vector<bool> m_defined;        ///< formats written to the current file, by id
+  size_t m_segment{0};                ///< roll count of the current file
+  bool m_started{false};              ///< segment record written
+};
+
+/// @brief a decoded trace event
+struct TraceEvent {
+  uint32_t id;                                  ///< format id
+  int64_t steady;                               ///< steady clock of the writer in ns
+  std::chrono::system_clock::time_point time;   ///< wall clock derived from the segment record
+  std::string text;                             ///< rendered message
+};
+
+/// @brief Renders binary trace records.
+///
+/// Definitions are kept across decode() calls, so the files of one run can be
+/// decoded in order even if an event precedes its definition after a rollover.
+class TraceReader {
+ public:
+  using Sink = std::function<void(const TraceEvent&)>;
+
+  /// Decodes the records of a file or buffer.
+  /// \param data the records
+  /// \param sink called for every event
+  /// \return the number of bytes of complete records, less than data.size() for a truncated tail
+  size_t decode(std::span<const std::byte> data, const Sink& sink) {
+    size_t pos = 0;
+    while (pos < data.size()) {
+      const auto start = pos;
+      TraceRecord kind{};
+      if (!get(data, pos, kind) || kind == TraceRecord::end) {
+        return start;
+      }
+      bool complete = false;
+      switch (kind) {
+        case TraceRecord::segment:
+          complete = decodeSegment(data, pos);
+          break;
+        case TraceRecord::format:
+          complete = decodeFormat(data, pos);
+          break;
+        case TraceRecord::event:
+          complete = decodeEvent(data, pos, sink);
+          break;
+        default:
+          ++m_errors;
+          return start;
+      }
+      if (!complete) {
+        return start;
+      }
+    }
+    return pos;
+  }
+
+  /// get the number of events with unknown format and of malformed records
+  [[nodiscard]] size_t errors() const { return m_errors; }
+
+ private:
+  struct Definition {
+    std::vector<TraceType> types;
+    std::string format;
+  };
+
+  template <typename T>
+  static bool get(std::span<const std::byte> data, size_t& pos, T& value) {
+    if (data.size() - pos < sizeof(T)) {
+      return false;
+    }
+    std::memcpy(&value, data.data() + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+  }
+
+  static bool getBytes(std::span<const std::byte> data, size_t& pos, std::string& value) {
+    uint16_t n = 0;
+    if (!get(data, pos, n) || data.size() - pos < n) {
+      return false;
+    }
+    value.assign(reinterpret_cast<const char*>(data.data() + pos), n);
+    pos += n;
+    return true;
+  }
+
+  bool decodeSegment(std::span<const std::byte> data, size_t& pos) {
+    uint32_t magic = 0;
+    uint8_t version = 0;
+    uint8_t little = 0;
+    if (!get(data, pos, magic) || !get(data, pos, version) || !get(data, pos, little) || !get(data, pos, m_steady) ||
+        !get(data, pos, m_system)) {
+      return false;
+    }
+    if (magic != traceMagic || version != traceVersion ||
+        (little != 0) != (std::endian::native == std::endian::little)) {
+      ++m_errors;
+      return false;
+    }
+    return true;
+  }
+
+  bool decodeFormat(std::span<const std::byte> data, size_t& pos) {
+    uint32_t id = 0;
+    uint8_t count = 0;
+    if (!get(data, pos, id) || !get(data, pos, count) || data.size() - pos < count) {
+      return false;
+    }
+    Definition definition;
+    definition.types.resize(count);
+    std::memcpy(definition.types.data(), data.data() + pos, count);
+    pos += count;
+    if (!getBytes(data, pos, definition.format)) {
+      return false;
+    }
+    m_formats[id] = std::move(definition);
+    return true;
+  }
+
+  template <typename T>
+  static bool push(std::span<const std::byte> data, size_t& pos, fmt::dynamic_format_arg_store<fmt::format_context>& store) {
+    if constexpr (std::is_same_v<T, bool>) {
+      // a byte other than 0 or 1 is no valid bool, read it as a byte
+      uint8_t value = 0;
+      if (!get(data, pos, value)) {
+        return false;
+      }
+      store.push_back(value != 0);
+    } else {
+      T value{};
+      if (!get(data, pos, value)) {
+        return false;
+      }
+      store.push_back(value);
+    }
+    return true;
+  }
+
+  bool decodeEvent(std::span<const std::byte> data, size_t& pos, const Sink& sink) {
+    uint32_t length = 0;
+    if (!get(data, pos, length) || data.size() - pos < length) {
+      return false;
+    }
+    const auto record = data.subspan(pos, length);
+    pos += length;
+
+    // malformed events and events whose definition was not decoded are skipped
+    TraceEvent event{};
+    size_t at = 0;
+    if (!get(record, at, event.id) || !get(record, at, event.steady)) {
+      ++m_errors;
+      return true;
+    }
+    const auto it = m_formats.find(event.id);
+    if (it == m_formats.end()) {
+      ++m_errors;
+      return true;
+    }
+
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+    for (auto type : it->second.types) {
+      bool ok = false;
+      switch (type) {
+        case TraceType::i8: ok = push<int8_t>(record, at, store); break;
+        case TraceType::i16: ok = push<int16_t>(record, at, store); break;
+        case TraceType::i32: ok = push<int32_t>(record, at, store); break;
+        case TraceType::i64: ok = push<int64_t>(record, at, store); break;
+        case TraceType::u8: ok = push<uint8_t>(record, at, store); break;
+        case TraceType::u16: ok = push<uint16_t>(record, at, store); break;
+        case TraceType::u32: ok = push<uint32_t>(record, at, store); break;
+        case TraceType::u64: ok = push<uint64_t>(record, at, store); break;
+        case TraceType::f32: ok = push<float>(record, at, store); break;
+        case TraceType::f64: ok = push<double>(record, at, store); break;
+        case TraceType::boolean: ok = push<bool>(record, at, store); break;
+        case TraceType::character: ok = push<char>(record, at, store); break;
+        case TraceType::string: {
+          std::string value;
+          ok = getBytes(record, at, value);
+          store.push_back(std::move(value));
+          break;
+        }
+      }
+      if (!ok) {
+        ++m_errors;
+        return true;
+      }
+    }
+
+    event.time = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+       std::chrono::nanoseconds(m_system + (event.steady - m_steady))));
+    try {
+      event.text = fmt::vformat(it->second.format, store);
+    } catch (const fmt::format_error&) {
+      ++m_errors;
+      event.text = it->second.format;
+    }
+    sink(event);
+    return true;
+  }
+
+  std::unordered_map<uint32_t, Definition> m_formats;   ///< definitions by id
+  int64_t m_steady{0};                                  ///< steady clock of the last segment record
+  int64_t m_system{0};                                  ///< system clock of the last segment record
+  size_t m_errors{0};                                   ///< see errors()
+};
+
+}   // namespace cppsl::log
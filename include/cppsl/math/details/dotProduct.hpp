@@ -0,0 +1,191 @@
+/************************************************************************/ /**
+* @file
+* @brief   vectorized dot product and multiply-accumulate kernels for the sample rate converters
+* @details The kernel is selected at compile time from the instruction sets
+* enabled for the target: AVX, SSE2 or NEON, with a scalar fallback.
+* The length must be a multiple of dotBlock, callers pad with zero
+* coefficients.
+* @author Alexander Sacharov <a.sacharov@gmx.de>
+* Project : Digital Signal Processing
+****************************************************************************/
+
+#ifndef INCLUDE_CPPSL_MATH_DSP_DOT_PRODUCT_HPP
+#define INCLUDE_CPPSL_MATH_DSP_DOT_PRODUCT_HPP
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <cstddef>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace cppsl::math::details {
+
+/// Number of elements processed per kernel iteration, lengths are padded to it.
+inline constexpr size_t dotBlock = 8;
+
+/**
+ * @brief Dot product of two float arrays
+ * @param a first array
+ * @param b second array
+ * @param n number of elements, a multiple of dotBlock
+ * @return sum of a[i] * b[i]
+ */
+inline float Dot(const float* a, const float* b, size_t n) {
+#if defined(__AVX__)
+  __m256 acc = _mm256_setzero_ps();
+  for (size_t i = 0; i < n; i += 8) {
+    acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+  }
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum);
+#elif defined(__SSE2__)
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  for (size_t i = 0; i < n; i += 8) {
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+  }
+  __m128 sum = _mm_add_ps(acc0, acc1);
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum);
+#elif defined(__ARM_NEON)
+  float32x4_t acc0 = vdupq_n_f32(0.0f);
+  float32x4_t acc1 = vdupq_n_f32(0.0f);
+  for (size_t i = 0; i < n; i += 8) {
+    acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+    acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+  }
+  const float32x4_t sum = vaddq_f32(acc0, acc1);
+  const float32x2_t half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+  return vget_lane_f32(vpadd_f32(half, half), 0);
+#else
+  float acc[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+  for (size_t i = 0; i < n; i += 4) {
+    acc[0] += a[i] * b[i];
+    acc[1] += a[i + 1] * b[i + 1];
+    acc[2] += a[i + 2] * b[i + 2];
+    acc[3] += a[i + 3] * b[i + 3];
+  }
+  return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+}
+
+/**
+ * @brief Dot product of two double arrays
+ * @param a first array
+ * @param b second array
+ * @param n number of elements, a multiple of dotBlock
+ * @return sum of a[i] * b[i]
+ */
+inline double Dot(const double* a, const double* b, size_t n) {
+#if defined(__AVX__)
+  __m256d acc0 = _mm256_setzero_pd();
+  __m256d acc1 = _mm256_setzero_pd();
+  for (size_t i = 0; i < n; i += 8) {
+    acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+  }
+  const __m256d acc = _mm256_add_pd(acc0, acc1);
+  __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+  sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+  return _mm_cvtsd_f64(sum);
+#elif defined(__SSE2__)
+  __m128d acc0 = _mm_setzero_pd();
+  __m128d acc1 = _mm_setzero_pd();
+  for (size_t i = 0; i < n; i += 4) {
+    acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+    acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+  }
+  __m128d sum = _mm_add_pd(acc0, acc1);
+  sum = _mm_add_sd(sum, _mm_unpackhi_pd(sum, sum));
+  return _mm_cvtsd_f64(sum);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  float64x2_t acc0 = vdupq_n_f64(0.0);
+  float64x2_t acc1 = vdupq_n_f64(0.0);
+  for (size_t i = 0; i < n; i += 4) {
+    acc0 = vfmaq_f64(acc0, vld1q_f64(a + i), vld1q_f64(b + i));
+    acc1 = vfmaq_f64(acc1, vld1q_f64(a + i + 2), vld1q_f64(b + i + 2));
+  }
+  return vaddvq_f64(vaddq_f64(acc0, acc1));
+#else
+  double acc[4] = {0.0, 0.0, 0.0, 0.0};
+  for (size_t i = 0; i < n; i += 4) {
+    acc[0] += a[i] * b[i];
+    acc[1] += a[i + 1] * b[i + 1];
+    acc[2] += a[i + 2] * b[i + 2];
+    acc[3] += a[i + 3] * b[i + 3];
+  }
+  return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+#endif
+}
+
+/**
+ * @brief Multiply-accumulate of a scaled float row, acc[i] += coef * row[i]
+ * @param acc accumulator row
+ * @param coef scale factor
+ * @param row input row
+ * @param n number of elements, a multiple of dotBlock
+ */
+inline void Axpy(float* acc, float coef, const float* row, size_t n) {
+#if defined(__AVX__)
+  const __m256 c = _mm256_set1_ps(coef);
+  for (size_t i = 0; i < n; i += 8) {
+    _mm256_storeu_ps(acc + i, _mm256_add_ps(_mm256_loadu_ps(acc + i), _mm256_mul_ps(c, _mm256_loadu_ps(row + i))));
+  }
+#elif defined(__SSE2__)
+  const __m128 c = _mm_set1_ps(coef);
+  for (size_t i = 0; i < n; i += 4) {
+    _mm_storeu_ps(acc + i, _mm_add_ps(_mm_loadu_ps(acc + i), _mm_mul_ps(c, _mm_loadu_ps(row + i))));
+  }
+#elif defined(__ARM_NEON)
+  for (size_t i = 0; i < n; i += 4) {
+    vst1q_f32(acc + i, vmlaq_n_f32(vld1q_f32(acc + i), vld1q_f32(row + i), coef));
+  }
+#else
+  for (size_t i = 0; i < n; ++i) {
+    acc[i] += coef * row[i];
+  }
+#endif
+}
+
+/**
+ * @brief Multiply-accumulate of a scaled double row, acc[i] += coef * row[i]
+ * @param acc accumulator row
+ * @param coef scale factor
+ * @param row input row
+ * @param n number of elements, a multiple of dotBlock
+ */
+inline void Axpy(double* acc, double coef, const double* row, size_t n) {
+#if defined(__AVX__)
+  const __m256d c = _mm256_set1_pd(coef);
+  for (size_t i = 0; i < n; i += 4) {
+    _mm256_storeu_pd(acc + i, _mm256_add_pd(_mm256_loadu_pd(acc + i), _mm256_mul_pd(c, _mm256_loadu_pd(row + i))));
+  }
+#elif defined(__SSE2__)
+  const __m128d c = _mm_set1_pd(coef);
+  for (size_t i = 0; i < n; i += 2) {
+    _mm_storeu_pd(acc + i, _mm_add_pd(_mm_loadu_pd(acc + i), _mm_mul_pd(c, _mm_loadu_pd(row + i))));
+  }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  const float64x2_t c = vdupq_n_f64(coef);
+  for (size_t i = 0; i < n; i += 2) {
+    vst1q_f64(acc + i, vfmaq_f64(vld1q_f64(acc + i), c, vld1q_f64(row + i)));
+  }
+#else
+  for (size_t i = 0; i < n; ++i) {
+    acc[i] += coef * row[i];
+  }
+#endif
+}
+
+}   // namespace cppsl::math::details
+
+#endif /* INCLUDE_CPPSL_MATH_DSP_DOT_PRODUCT_HPP */
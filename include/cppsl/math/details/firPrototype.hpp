@@ -0,0 +1,51 @@
+/************************************************************************/ /**
+* @file
+* @brief   low pass prototype of the polyphase sample rate converters
+* @author Alexander Sacharov <a.sacharov@gmx.de>
+* Project : Digital Signal Processing
+****************************************************************************/
+
+#ifndef INCLUDE_CPPSL_MATH_DSP_FIR_PROTOTYPE_HPP
+#define INCLUDE_CPPSL_MATH_DSP_FIR_PROTOTYPE_HPP
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <cmath>
+#include <vector>
+
+#include <cppsl/math/constants.hpp>
+
+namespace cppsl::math::details {
+
+/**
+ * @brief Full length Blackman windowed sinc prototype, identical to the half table of SmpRateConvFIR
+ * @param oversampling the number of filter phases
+ * @param mul the number of multiplications
+ * @return oversampling * mul coefficients, normalized to a gain of oversampling
+ */
+inline std::vector<double> FirPrototype(int oversampling, int mul) {
+  const int length = oversampling * mul;
+  const int half = length >> 1;
+  std::vector<double> fir(length);
+  const double w = DSP_PI / oversampling;
+  const double c = (double)half - 0.5;
+  const double nSub1 = length - 1;
+  double sum = 0.0;
+  for (int i = 0; i < half; ++i) {
+    const double d = (double)i - c;
+    const double window = 0.42 - 0.5 * std::cos(2.0 * DSP_PI * i / nSub1) + 0.08 * std::cos(4.0 * DSP_PI * i / nSub1);
+    fir[i] = std::sin(w * d) / d * window;
+    sum += fir[i] + fir[i];
+  }
+  sum /= oversampling;
+  for (int i = 0; i < half; ++i) {
+    fir[i] /= sum;
+    fir[length - 1 - i] = fir[i];
+  }
+  return fir;
+}
+
+}   // namespace cppsl::math::details
+
+#endif /* INCLUDE_CPPSL_MATH_DSP_FIR_PROTOTYPE_HPP */
@@ -0,0 +1,156 @@
+/************************************************************************/ /**
+* @file
+* @brief   Q15/Q31 fixed-point kernels for the sample rate converters
+* @details int16_t samples use Q15 coefficients, int32_t samples Q31
+* coefficients, both accumulate the full products in 64 bits. Partial sums
+* may exceed full scale (the Gibbs overshoot of a step), only the final
+* narrowing saturates to the sample range. NEON targets use widening
+* multiply-accumulates (vmull/vpadal, vqadd for Q31), the others run the
+* scalar fallback with the same arithmetic.
+* @author Alexander Sacharov <a.sacharov@gmx.de>
+* Project : Digital Signal Processing
+****************************************************************************/
+
+#ifndef INCLUDE_CPPSL_MATH_DSP_FIXED_POINT_HPP
+#define INCLUDE_CPPSL_MATH_DSP_FIXED_POINT_HPP
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace cppsl::math::details {
+
+/// Sample types converted with fixed-point coefficients.
+template <typename T>
+inline constexpr bool isFixedPoint = std::is_same_v<T, int16_t> || std::is_same_v<T, int32_t>;
+
+/// Fixed-point format of a sample type, floating point types keep double.
+template <typename T>
+struct QFormat {
+  using coef_type = double;        ///< coefficient type
+  using accu_type = double;        ///< accumulator type
+  static constexpr int bits = 0;   ///< fractional bits of the coefficients
+};
+
+/// Q15 coefficients
+template <>
+struct QFormat<int16_t> {
+  using coef_type = int16_t;        ///< coefficient type
+  using accu_type = int64_t;        ///< accumulator type
+  static constexpr int bits = 15;   ///< fractional bits of the coefficients
+};
+
+/// Q31 coefficients
+template <>
+struct QFormat<int32_t> {
+  using coef_type = int32_t;        ///< coefficient type
+  using accu_type = int64_t;        ///< accumulator type
+  static constexpr int bits = 31;   ///< fractional bits of the coefficients
+};
+
+/**
+ * @brief Rounds a coefficient to the fixed-point format, saturating at +-1
+ * @param value coefficient
+ * @return the fixed-point coefficient
+ */
+template <typename T>
+typename QFormat<T>::coef_type ToQ(double value) {
+  using C = typename QFormat<T>::coef_type;
+  const double scaled = std::round(std::ldexp(value, QFormat<T>::bits));
+  if (scaled >= static_cast<double>(std::numeric_limits<C>::max()))
+    return std::numeric_limits<C>::max();
+  if (scaled <= static_cast<double>(std::numeric_limits<C>::lowest()))
+    return std::numeric_limits<C>::lowest();
+  return static_cast<C>(scaled);
+}
+
+/**
+ * @brief Saturating addition of accumulators
+ * @param a first summand
+ * @param b second summand
+ * @return a + b limited to the accumulator range
+ */
+template <typename A>
+A AddSat(A a, A b) {
+  A res;
+  if (__builtin_add_overflow(a, b, &res))
+    return b < 0 ? std::numeric_limits<A>::lowest() : std::numeric_limits<A>::max();
+  return res;
+}
+
+/**
+ * @brief Multiply-accumulate of a Q15 coefficient row and samples
+ * @param acc accumulator in Q15 sample units
+ * @param coef Q15 coefficients
+ * @param x samples
+ * @param n number of elements
+ * @return acc + sum of coef[i] * x[i]
+ */
+inline int64_t AccumulateQ(int64_t acc, const int16_t* coef, const int16_t* x, size_t n) {
+  size_t i = 0;
+#if defined(__ARM_NEON)
+  int64x2_t vacc = vdupq_n_s64(0);
+  for (; i + 4 <= n; i += 4) {
+    vacc = vpadalq_s32(vacc, vmull_s16(vld1_s16(coef + i), vld1_s16(x + i)));
+  }
+  acc += vgetq_lane_s64(vacc, 0) + vgetq_lane_s64(vacc, 1);
+#endif
+  for (; i < n; ++i) {
+    acc += (int32_t)coef[i] * x[i];
+  }
+  return acc;
+}
+
+/**
+ * @brief Saturating multiply-accumulate of a Q31 coefficient row and samples
+ * @details The products use 62 bits, the sum saturates only if the absolute
+ * coefficients of the row add up to 2 or more.
+ * @param acc accumulator in Q31 sample units
+ * @param coef Q31 coefficients
+ * @param x samples
+ * @param n number of elements
+ * @return acc + sum of coef[i] * x[i], saturated
+ */
+inline int64_t AccumulateQ(int64_t acc, const int32_t* coef, const int32_t* x, size_t n) {
+  size_t i = 0;
+#if defined(__ARM_NEON)
+  int64x2_t vacc = vdupq_n_s64(0);
+  for (; i + 2 <= n; i += 2) {
+    vacc = vqaddq_s64(vacc, vmull_s32(vld1_s32(coef + i), vld1_s32(x + i)));
+  }
+  acc = AddSat(acc, AddSat(vgetq_lane_s64(vacc, 0), vgetq_lane_s64(vacc, 1)));
+#endif
+  for (; i < n; ++i) {
+    acc = AddSat(acc, (int64_t)coef[i] * x[i]);
+  }
+  return acc;
+}
+
+/**
+ * @brief Rounds the accumulator to the sample type, saturating at the sample range
+ * @param acc the accumulator
+ * @return the output sample
+ */
+template <typename T>
+T NarrowQ(int64_t acc) {
+  constexpr int shift = QFormat<T>::bits;
+  const int64_t value = AddSat(acc, int64_t(1) << (shift - 1)) >> shift;
+  if (value > std::numeric_limits<T>::max())
+    return std::numeric_limits<T>::max();
+  if (value < std::numeric_limits<T>::lowest())
+    return std::numeric_limits<T>::lowest();
+  return static_cast<T>(value);
+}
+
+}   // namespace cppsl::math::details
+
+#endif /* INCLUDE_CPPSL_MATH_DSP_FIXED_POINT_HPP */
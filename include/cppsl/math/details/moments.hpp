@@ -0,0 +1,323 @@
+/************************************************************************/ /**
+* @file
+* @brief   vectorized single pass reductions for the statistics functions
+* @details Sum, sum of squares, minimum and maximum of an array in one pass.
+* The sums are kept in double in several independent accumulators, which
+* are combined pairwise at the end, so the rounding error grows with the
+* length divided by the number of accumulators. The kernel is selected at
+* compile time: AVX, SSE2 (every x86-64 target) or NEON on AArch64, with a
+* scalar fallback of the same accumulator layout. 32-bit ARM NEON has no
+* double precision vectors, ARMv7 targets use the scalar kernel.
+* @author Alexander Sacharov <a.sacharov@gmx.de>
+* Project : Digital Signal Processing
+****************************************************************************/
+
+#ifndef INCLUDE_CPPSL_MATH_DSP_MOMENTS_HPP
+#define INCLUDE_CPPSL_MATH_DSP_MOMENTS_HPP
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+namespace cppsl::math::details {
+
+/// Raw moments of an array.
+struct Moments {
+  double sum{0.0};                                          ///< sum of the values
+  double sumSq{0.0};                                        ///< sum of the squared values
+  double min{std::numeric_limits<double>::infinity()};      ///< smallest value
+  double max{-std::numeric_limits<double>::infinity()};     ///< largest value
+};
+
+/**
+ * @brief Scalar reduction with four accumulators, also the tail of the vector kernels
+ * @param x values
+ * @param n number of values
+ * @param res the moments to continue
+ * @return the updated moments
+ */
+template <typename T>
+Moments MomentsScalar(const T* x, size_t n, Moments res = {}) {
+  double sum[4] = {0.0, 0.0, 0.0, 0.0};
+  double sq[4] = {0.0, 0.0, 0.0, 0.0};
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    for (size_t k = 0; k < 4; ++k) {
+      const double v = static_cast<double>(x[i + k]);
+      sum[k] += v;
+      sq[k] += v * v;
+      res.min = std::min(res.min, v);
+      res.max = std::max(res.max, v);
+    }
+  }
+  for (; i < n; ++i) {
+    const double v = static_cast<double>(x[i]);
+    sum[0] += v;
+    sq[0] += v * v;
+    res.min = std::min(res.min, v);
+    res.max = std::max(res.max, v);
+  }
+  res.sum += (sum[0] + sum[1]) + (sum[2] + sum[3]);
+  res.sumSq += (sq[0] + sq[1]) + (sq[2] + sq[3]);
+  return res;
+}
+
+#if defined(__AVX__)
+/**
+ * @brief Folds the vector accumulators into the moments
+ * @param sum0 first sum accumulator
+ * @param sum1 second sum accumulator
+ * @param sq0 first square accumulator
+ * @param sq1 second square accumulator
+ * @param lo minimum accumulator
+ * @param hi maximum accumulator
+ * @return the moments
+ */
+inline Moments FoldMoments(__m256d sum0, __m256d sum1, __m256d sq0, __m256d sq1, __m256d lo, __m256d hi) {
+  alignas(32) double s[4], q[4], mn[4], mx[4];
+  _mm256_store_pd(s, _mm256_add_pd(sum0, sum1));
+  _mm256_store_pd(q, _mm256_add_pd(sq0, sq1));
+  _mm256_store_pd(mn, lo);
+  _mm256_store_pd(mx, hi);
+  Moments res;
+  res.sum = (s[0] + s[1]) + (s[2] + s[3]);
+  res.sumSq = (q[0] + q[1]) + (q[2] + q[3]);
+  res.min = std::min(std::min(mn[0], mn[1]), std::min(mn[2], mn[3]));
+  res.max = std::max(std::max(mx[0], mx[1]), std::max(mx[2], mx[3]));
+  return res;
+}
+
+// accumulates eight values given as two vectors of four doubles
+#define CPPSL_MOMENTS_STEP(a, b)                          \
+  sum0 = _mm256_add_pd(sum0, a);                          \
+  sum1 = _mm256_add_pd(sum1, b);                          \
+  sq0 = _mm256_add_pd(sq0, _mm256_mul_pd(a, a));          \
+  sq1 = _mm256_add_pd(sq1, _mm256_mul_pd(b, b));          \
+  lo = _mm256_min_pd(lo, _mm256_min_pd(a, b));            \
+  hi = _mm256_max_pd(hi, _mm256_max_pd(a, b))
+
+// accumulators of CPPSL_MOMENTS_STEP
+#define CPPSL_MOMENTS_INIT                                                           \
+  __m256d sum0 = _mm256_setzero_pd(), sum1 = _mm256_setzero_pd();                    \
+  __m256d sq0 = _mm256_setzero_pd(), sq1 = _mm256_setzero_pd();                      \
+  __m256d lo = _mm256_set1_pd(std::numeric_limits<double>::infinity());              \
+  __m256d hi = _mm256_set1_pd(-std::numeric_limits<double>::infinity())
+#elif defined(__SSE2__)
+/**
+ * @brief Folds the vector accumulators into the moments
+ * @param sum0 first sum accumulator
+ * @param sum1 second sum accumulator
+ * @param sq0 first square accumulator
+ * @param sq1 second square accumulator
+ * @param lo minimum accumulator
+ * @param hi maximum accumulator
+ * @return the moments
+ */
+inline Moments FoldMoments(__m128d sum0, __m128d sum1, __m128d sq0, __m128d sq1, __m128d lo, __m128d hi) {
+  alignas(16) double s[2], q[2], mn[2], mx[2];
+  _mm_store_pd(s, _mm_add_pd(sum0, sum1));
+  _mm_store_pd(q, _mm_add_pd(sq0, sq1));
+  _mm_store_pd(mn, lo);
+  _mm_store_pd(mx, hi);
+  Moments res;
+  res.sum = s[0] + s[1];
+  res.sumSq = q[0] + q[1];
+  res.min = std::min(mn[0], mn[1]);
+  res.max = std::max(mx[0], mx[1]);
+  return res;
+}
+
+// accumulates four values given as two vectors of two doubles
+#define CPPSL_MOMENTS_STEP(a, b)                    \
+  sum0 = _mm_add_pd(sum0, a);                       \
+  sum1 = _mm_add_pd(sum1, b);                       \
+  sq0 = _mm_add_pd(sq0, _mm_mul_pd(a, a));          \
+  sq1 = _mm_add_pd(sq1, _mm_mul_pd(b, b));          \
+  lo = _mm_min_pd(lo, _mm_min_pd(a, b));            \
+  hi = _mm_max_pd(hi, _mm_max_pd(a, b))
+
+// accumulators of CPPSL_MOMENTS_STEP
+#define CPPSL_MOMENTS_INIT                                                     \
+  __m128d sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd();                    \
+  __m128d sq0 = _mm_setzero_pd(), sq1 = _mm_setzero_pd();                      \
+  __m128d lo = _mm_set1_pd(std::numeric_limits<double>::infinity());           \
+  __m128d hi = _mm_set1_pd(-std::numeric_limits<double>::infinity())
+#endif
+
+/**
+ * @brief Moments of a double array
+ * @param x values
+ * @param n number of values
+ * @return the moments
+ */
+inline Moments MomentsOf(const double* x, size_t n) {
+  size_t i = 0;
+  Moments res;
+#if defined(__AVX__)
+  CPPSL_MOMENTS_INIT;
+  for (; i + 8 <= n; i += 8) {
+    const __m256d a = _mm256_loadu_pd(x + i);
+    const __m256d b = _mm256_loadu_pd(x + i + 4);
+    CPPSL_MOMENTS_STEP(a, b);
+  }
+  res = FoldMoments(sum0, sum1, sq0, sq1, lo, hi);
+#elif defined(__SSE2__)
+  CPPSL_MOMENTS_INIT;
+  for (; i + 4 <= n; i += 4) {
+    const __m128d a = _mm_loadu_pd(x + i);
+    const __m128d b = _mm_loadu_pd(x + i + 2);
+    CPPSL_MOMENTS_STEP(a, b);
+  }
+  res = FoldMoments(sum0, sum1, sq0, sq1, lo, hi);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  float64x2_t sum0 = vdupq_n_f64(0.0), sum1 = vdupq_n_f64(0.0);
+  float64x2_t sq0 = vdupq_n_f64(0.0), sq1 = vdupq_n_f64(0.0);
+  float64x2_t lo = vdupq_n_f64(res.min), hi = vdupq_n_f64(res.max);
+  for (; i + 4 <= n; i += 4) {
+    const float64x2_t a = vld1q_f64(x + i);
+    const float64x2_t b = vld1q_f64(x + i + 2);
+    sum0 = vaddq_f64(sum0, a);
+    sum1 = vaddq_f64(sum1, b);
+    sq0 = vfmaq_f64(sq0, a, a);
+    sq1 = vfmaq_f64(sq1, b, b);
+    lo = vminq_f64(lo, vminq_f64(a, b));
+    hi = vmaxq_f64(hi, vmaxq_f64(a, b));
+  }
+  res.sum = vaddvq_f64(vaddq_f64(sum0, sum1));
+  res.sumSq = vaddvq_f64(vaddq_f64(sq0, sq1));
+  res.min = vminvq_f64(lo);
+  res.max = vmaxvq_f64(hi);
+#endif
+  return MomentsScalar(x + i, n - i, res);
+}
+
+/**
+ * @brief Moments of a float array, accumulated in double
+ * @param x values
+ * @param n number of values
+ * @return the moments
+ */
+inline Moments MomentsOf(const float* x, size_t n) {
+  size_t i = 0;
+  Moments res;
+#if defined(__AVX__)
+  CPPSL_MOMENTS_INIT;
+  for (; i + 8 <= n; i += 8) {
+    const __m256 v = _mm256_loadu_ps(x + i);
+    const __m256d a = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+    const __m256d b = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+    CPPSL_MOMENTS_STEP(a, b);
+  }
+  res = FoldMoments(sum0, sum1, sq0, sq1, lo, hi);
+#elif defined(__SSE2__)
+  CPPSL_MOMENTS_INIT;
+  for (; i + 4 <= n; i += 4) {
+    const __m128 v = _mm_loadu_ps(x + i);
+    const __m128d a = _mm_cvtps_pd(v);
+    const __m128d b = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+    CPPSL_MOMENTS_STEP(a, b);
+  }
+  res = FoldMoments(sum0, sum1, sq0, sq1, lo, hi);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  float64x2_t sum0 = vdupq_n_f64(0.0), sum1 = vdupq_n_f64(0.0);
+  float64x2_t sq0 = vdupq_n_f64(0.0), sq1 = vdupq_n_f64(0.0);
+  float64x2_t lo = vdupq_n_f64(res.min), hi = vdupq_n_f64(res.max);
+  for (; i + 4 <= n; i += 4) {
+    const float32x4_t v = vld1q_f32(x + i);
+    const float64x2_t a = vcvt_f64_f32(vget_low_f32(v));
+    const float64x2_t b = vcvt_high_f64_f32(v);
+    sum0 = vaddq_f64(sum0, a);
+    sum1 = vaddq_f64(sum1, b);
+    sq0 = vfmaq_f64(sq0, a, a);
+    sq1 = vfmaq_f64(sq1, b, b);
+    lo = vminq_f64(lo, vminq_f64(a, b));
+    hi = vmaxq_f64(hi, vmaxq_f64(a, b));
+  }
+  res.sum = vaddvq_f64(vaddq_f64(sum0, sum1));
+  res.sumSq = vaddvq_f64(vaddq_f64(sq0, sq1));
+  res.min = vminvq_f64(lo);
+  res.max = vmaxvq_f64(hi);
+#endif
+  return MomentsScalar(x + i, n - i, res);
+}
+
+/**
+ * @brief Moments of an int32_t array, the SV sample type, accumulated in double
+ * @param x values
+ * @param n number of values
+ * @return the moments
+ */
+inline Moments MomentsOf(const int32_t* x, size_t n) {
+  size_t i = 0;
+  Moments res;
+#if defined(__AVX__)
+  CPPSL_MOMENTS_INIT;
+  for (; i + 8 <= n; i += 8) {
+    const __m256d a = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i)));
+    const __m256d b = _mm256_cvtepi32_pd(_mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i + 4)));
+    CPPSL_MOMENTS_STEP(a, b);
+  }
+  res = FoldMoments(sum0, sum1, sq0, sq1, lo, hi);
+#elif defined(__SSE2__)
+  CPPSL_MOMENTS_INIT;
+  for (; i + 4 <= n; i += 4) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+    const __m128d a = _mm_cvtepi32_pd(v);
+    const __m128d b = _mm_cvtepi32_pd(_mm_unpackhi_epi64(v, v));
+    CPPSL_MOMENTS_STEP(a, b);
+  }
+  res = FoldMoments(sum0, sum1, sq0, sq1, lo, hi);
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+  float64x2_t sum0 = vdupq_n_f64(0.0), sum1 = vdupq_n_f64(0.0);
+  float64x2_t sq0 = vdupq_n_f64(0.0), sq1 = vdupq_n_f64(0.0);
+  float64x2_t lo = vdupq_n_f64(res.min), hi = vdupq_n_f64(res.max);
+  for (; i + 4 <= n; i += 4) {
+    const int32x4_t v = vld1q_s32(x + i);
+    const float64x2_t a = vcvtq_f64_s64(vmovl_s32(vget_low_s32(v)));
+    const float64x2_t b = vcvtq_f64_s64(vmovl_high_s32(v));
+    sum0 = vaddq_f64(sum0, a);
+    sum1 = vaddq_f64(sum1, b);
+    sq0 = vfmaq_f64(sq0, a, a);
+    sq1 = vfmaq_f64(sq1, b, b);
+    lo = vminq_f64(lo, vminq_f64(a, b));
+    hi = vmaxq_f64(hi, vmaxq_f64(a, b));
+  }
+  res.sum = vaddvq_f64(vaddq_f64(sum0, sum1));
+  res.sumSq = vaddvq_f64(vaddq_f64(sq0, sq1));
+  res.min = vminvq_f64(lo);
+  res.max = vmaxvq_f64(hi);
+#endif
+  return MomentsScalar(x + i, n - i, res);
+}
+
+/**
+ * @brief Moments of any other arithmetic type
+ * @param x values
+ * @param n number of values
+ * @return the moments
+ */
+template <typename T>
+Moments MomentsOf(const T* x, size_t n) {
+  return MomentsScalar(x, n);
+}
+
+#if defined(__AVX__) || defined(__SSE2__)
+#undef CPPSL_MOMENTS_STEP
+#undef CPPSL_MOMENTS_INIT
+#endif
+
+}   // namespace cppsl::math::details
+
+#endif /* INCLUDE_CPPSL_MATH_DSP_MOMENTS_HPP */
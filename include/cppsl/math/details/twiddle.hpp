@@ -0,0 +1,70 @@
+/************************************************************************/ /**
+* @file
+* @brief   compile time twiddle tables of the DFT engines
+* @details std::sin is not constexpr, the sine is a Taylor series on the
+* range reduced to [-pi/2, pi/2], accurate to the last bit of a double.
+* @author Alexander Sacharov <a.sacharov@gmx.de>
+* Project : Digital Signal Processing
+****************************************************************************/
+
+#ifndef INCLUDE_CPPSL_MATH_DSP_TWIDDLE_HPP
+#define INCLUDE_CPPSL_MATH_DSP_TWIDDLE_HPP
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <array>
+#include <cstddef>
+
+#include <cppsl/math/constants.hpp>
+
+namespace cppsl::math::details {
+
+/**
+ * @brief Compile time sine
+ * @param x angle in radians, [-pi, pi]
+ * @return sin(x)
+ */
+constexpr double ConstSin(double x) {
+  if (x > DSP_PI_2) {
+    x = DSP_PI - x;
+  } else if (x < -DSP_PI_2) {
+    x = -DSP_PI - x;
+  }
+  double term = x;
+  double sum = x;
+  for (int n = 1; n < 14; ++n) {
+    term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+    sum += term;
+  }
+  return sum;
+}
+
+/// Cosine and sine of the angles 2 * pi * n / W.
+template <size_t W>
+struct Twiddles {
+  std::array<double, W> cos{};   ///< cos(2 * pi * n / W)
+  std::array<double, W> sin{};   ///< sin(2 * pi * n / W)
+};
+
+/**
+ * @brief Builds the twiddle table of a window
+ * @tparam W window length in samples
+ * @return the table
+ */
+template <size_t W>
+constexpr Twiddles<W> MakeTwiddles() {
+  Twiddles<W> res;
+  for (size_t n = 0; n < W; ++n) {
+    // angle in [-pi, pi), its quarter turn for the cosine
+    const double a = (2 * n < W) ? DSP_2PI * (double)n / W : DSP_2PI * ((double)n - W) / W;
+    const double c = a + DSP_PI_2 >= DSP_PI ? a + DSP_PI_2 - DSP_2PI : a + DSP_PI_2;
+    res.sin[n] = ConstSin(a);
+    res.cos[n] = ConstSin(c);
+  }
+  return res;
+}
+
+}   // namespace cppsl::math::details
+
+#endif /* INCLUDE_CPPSL_MATH_DSP_TWIDDLE_HPP */
@@ -1,6 +1,10 @@
 /************************************************************************/ /**
 * @file
 * @brief   general math functions
+* @details statistics() and statisticsMagnitude() compute mean, RMS, min,
+* max and peak of a span in a single vectorized pass
+* (details/moments.hpp), SlidingRms tracks the RMS of the last N samples
+* in O(1) per sample.
 * @author A.Sacharov <a.sacharov@gmx.de>
 ****************************************************************************/
 
@@ -11,12 +15,19 @@
 // includes
 //-----------------------------------------------------------------------------
 #include <algorithm>
+#include <cmath>
 #include <complex>
 #include <cstdint>
+#include <limits>
 #include <numeric>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#include <cppsl/math/details/moments.hpp>
+
 //-----------------------------------------------------------------------------
 // global Defines and Macros
 //-----------------------------------------------------------------------------
@@ -25,6 +36,20 @@
 // global Structures, Typedefs, Enums, Unions
 //-----------------------------------------------------------------------------
 
+namespace cppsl::math {
+
+  /// Statistics of a block of samples, e.g. one power cycle
+  struct Statistics {
+    size_t count{0};   ///< number of samples
+    double mean{0.};   ///< arithmetic mean
+    double rms{0.};    ///< root mean square
+    double min{0.};    ///< smallest value
+    double max{0.};    ///< largest value
+    double peak{0.};   ///< largest absolute value
+  };
+
+}   // namespace cppsl::math
+
 //-----------------------------------------------------------------------------
 // global Variables Declarations
 //-----------------------------------------------------------------------------
@@ -66,7 +91,7 @@ namespace cppsl::math {
   inline double max(const std::vector<NumericType>& data, size_t firstIndex, size_t lastIndex) {
     if (data.empty()) {
       return 0.;
-    } else if ((lastIndex - firstIndex) >= data.size()) {
+    } else if (firstIndex >= lastIndex || lastIndex > data.size()) {
       throw std::range_error("compute complex mag from " + std::to_string(firstIndex) + " up to " +
                              std::to_string(lastIndex));
     } else {
@@ -111,11 +136,11 @@ namespace cppsl::math {
   inline double maxReal(const std::vector<std::complex<NumericType>>& data, size_t firstIndex, size_t lastIndex) {
     if (data.empty()) {
       return 0.;
-    } else if ((lastIndex - firstIndex) >= data.size()) {
+    } else if (firstIndex >= lastIndex || lastIndex > data.size()) {
       throw std::range_error("compute complex mag from " + std::to_string(firstIndex) + " up to " +
                              std::to_string(lastIndex));
     } else {
-      auto iter = std::max_element(data.begin() + firstIndex, data.begin() + firstIndex,
+      auto iter = std::max_element(data.begin() + firstIndex, data.begin() + lastIndex,
                                    [&](const std::complex<NumericType>& a, const std::complex<NumericType>& b) {
                                      return std::abs(a.real()) < std::abs(b.real());
                                    });
@@ -155,7 +180,7 @@ namespace cppsl::math {
   inline double rms(const std::vector<NumericType>& data, size_t firstIndex, size_t lastIndex) {
     if (data.empty()) {
       return 0.;
-    } else if ((lastIndex - firstIndex) >= data.size()) {
+    } else if (firstIndex >= lastIndex || lastIndex > data.size()) {
       throw std::range_error("compute complex mag from " + std::to_string(firstIndex) + " up to " +
                              std::to_string(lastIndex));
     } else {
@@ -180,8 +205,8 @@ namespace cppsl::math {
       return 0.;
     } else {
       double square = std::accumulate(data.begin(), data.end(), (double)0.0,
-                                      [&](const std::complex<double>& s, const std::complex<NumericType>& n) {
-                                        return (s.real() + n.real() * n.real() / data.size());
+                                      [&](const double& s, const std::complex<NumericType>& n) {
+                                        return (s + (double)n.real() * n.real() / data.size());
                                       });
       return std::sqrt(square);
     }
@@ -199,19 +224,185 @@ namespace cppsl::math {
   inline double rmsReal(const std::vector<std::complex<NumericType>>& data, size_t firstIndex, size_t lastIndex) {
     if (data.empty()) {
       return 0.;
-    } else if ((lastIndex - firstIndex) >= data.size()) {
+    } else if (firstIndex >= lastIndex || lastIndex > data.size()) {
       throw std::range_error("compute complex mag from " + std::to_string(firstIndex) + " up to " +
                              std::to_string(lastIndex));
     } else {
       size_t nn = lastIndex - firstIndex;
-      double square = std::partial_sum(data.begin() + firstIndex, data.begin() + lastIndex, (double)0.0,
-                                       [&](const std::complex<double>& s, const std::complex<NumericType>& n) {
-                                         return (s.real() + n.real() * n.real() / nn);
-                                       });
+      double square = std::accumulate(data.begin() + firstIndex, data.begin() + lastIndex, (double)0.0,
+                                      [&](const double& s, const std::complex<NumericType>& n) {
+                                        return (s + (double)n.real() * n.real() / nn);
+                                      });
       return std::sqrt(square);
     }
   }
 
+  /**
+  * @brief compute mean, RMS, min, max and peak in one pass
+  * @param data - values
+  * @return statistics, all zero for empty data
+  */
+  template <typename NumericType>
+  inline Statistics statistics(std::span<const NumericType> data) {
+    Statistics res;
+    if (data.empty()) {
+      return res;
+    }
+    const auto m = details::MomentsOf(data.data(), data.size());
+    res.count = data.size();
+    res.mean = m.sum / (double)res.count;
+    res.rms = std::sqrt(m.sumSq / (double)res.count);
+    res.min = m.min;
+    res.max = m.max;
+    res.peak = std::max(std::abs(m.min), std::abs(m.max));
+    return res;
+  }
+
+  /**
+  * @brief compute mean, RMS, min, max and peak in one pass
+  * @param data - vector values
+  * @return statistics, all zero for empty data
+  */
+  template <typename NumericType>
+  inline Statistics statistics(const std::vector<NumericType>& data) {
+    return statistics(std::span<const NumericType>(data));
+  }
+
+  /**
+  * @brief compute the statistics of the magnitudes of complex values in one pass
+  * @param data - complex values
+  * @return statistics of |data[i]|, peak equals max
+  */
+  template <typename NumericType>
+  inline Statistics statisticsMagnitude(std::span<const std::complex<NumericType>> data) {
+    Statistics res;
+    if (data.empty()) {
+      return res;
+    }
+    double sum[4] = {0., 0., 0., 0.};
+    double sq[4] = {0., 0., 0., 0.};
+    double lo = std::numeric_limits<double>::infinity();
+    double hi = 0.;
+    for (size_t i = 0; i < data.size(); ++i) {
+      const double re = (double)data[i].real();
+      const double im = (double)data[i].imag();
+      const double square = re * re + im * im;
+      const double mag = std::sqrt(square);
+      sum[i & 3] += mag;
+      sq[i & 3] += square;
+      lo = std::min(lo, mag);
+      hi = std::max(hi, mag);
+    }
+    res.count = data.size();
+    res.mean = ((sum[0] + sum[1]) + (sum[2] + sum[3])) / (double)res.count;
+    res.rms = std::sqrt(((sq[0] + sq[1]) + (sq[2] + sq[3])) / (double)res.count);
+    res.min = lo;
+    res.max = res.peak = hi;
+    return res;
+  }
+
+  /**
+  * @brief compute the statistics of the magnitudes of complex values in one pass
+  * @param data - vector complex values
+  * @return statistics of |data[i]|, peak equals max
+  */
+  template <typename NumericType>
+  inline Statistics statisticsMagnitude(const std::vector<std::complex<NumericType>>& data) {
+    return statisticsMagnitude(std::span<const std::complex<NumericType>>(data));
+  }
+
+  /**
+  * @brief Root Mean Square of the last N samples, updated in O(1) per sample
+  * @details Samples of up to 16 bits keep the sum of squares exactly in
+  * 64 bits. Wider integer and floating point samples subtract the leaving square from a running sum and
+  * rebuild the sum from the window once per window length, so rounding
+  * errors cannot build up.
+  * @tparam NumericType sample type
+  */
+  template <typename NumericType>
+  class SlidingRms {
+    static constexpr bool exact = std::is_integral_v<NumericType> && sizeof(NumericType) <= 2;
+    using sum_type = std::conditional_t<exact, int64_t, double>;
+
+   public:
+    /**
+    * @brief Constructor
+    * @param window - number of samples in the window, at least 1
+    */
+    explicit SlidingRms(size_t window) : m_window(std::max<size_t>(window, 1), NumericType(0)) {}
+
+    /**
+    * @brief add a sample, the oldest leaves the window when it is full
+    * @param sample - new sample
+    * @return RMS of the window
+    */
+    double push(NumericType sample) {
+      const sum_type value = static_cast<sum_type>(sample);
+      const sum_type old = static_cast<sum_type>(m_window[m_pos]);
+      m_window[m_pos] = sample;
+      m_sumSq += value * value - old * old;
+      if (++m_pos == m_window.size()) {
+        m_pos = 0;
+        if constexpr (!exact) {
+          m_sumSq = 0.;
+          for (const auto& v : m_window) {
+            m_sumSq += (double)v * v;
+          }
+        }
+      }
+      m_count = std::min(m_count + 1, m_window.size());
+      return rms();
+    }
+
+    /**
+    * @brief add samples
+    * @param data - new samples
+    * @return RMS of the window
+    */
+    double push(std::span<const NumericType> data) {
+      for (const auto& v : data) {
+        push(v);
+      }
+      return rms();
+    }
+
+    /**
+    * @brief compute RMS of the samples in the window
+    * @return RMS value, 0 without samples
+    */
+    [[nodiscard]] double rms() const {
+      return m_count == 0 ? 0. : std::sqrt(std::max(0., (double)m_sumSq / (double)m_count));
+    }
+
+    /**
+    * @brief number of samples in the window
+    * @return up to the window length
+    */
+    [[nodiscard]] size_t size() const { return m_count; }
+
+    /**
+    * @brief check whether the window is full
+    * @return true after window samples
+    */
+    [[nodiscard]] bool full() const { return m_count == m_window.size(); }
+
+    /**
+    * @brief remove all samples
+    */
+    void reset() {
+      std::fill(m_window.begin(), m_window.end(), NumericType(0));
+      m_sumSq = 0;
+      m_pos = 0;
+      m_count = 0;
+    }
+
+   private:
+    std::vector<NumericType> m_window;   ///< circular buffer of the window
+    sum_type m_sumSq{0};                 ///< sum of squares in the window
+    size_t m_pos{0};                     ///< next position to overwrite
+    size_t m_count{0};                   ///< samples in the window
+  };
+
 }   // namespace cppsl::math
 
 #endif /* INCLUDE_CPPSL_MATH_DSP_FUNCTIONS_HPP */
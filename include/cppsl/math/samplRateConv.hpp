@@ -0,0 +1,181 @@
+/************************************************************************//**
+* @file
+* @brief   Common interface of the sampling rate converters.
+* @details All converters offer
+* 1) Convert(std::span<const T> in, std::span<T> out) -> {consumed, produced},
+*    which never allocates and stops when either span is exhausted, so it can
+*    work on mmap'ed or ring buffer memory,
+* 2) maxOutputFor(n), the upper bound of samples produced by n more inputs,
+* 3) the original Convert(std::vector<T>&, std::vector<T>&), which appends
+*    to the output vector.
+* The CRTP base SmpRateConvBase provides 3) on top of 1) and 2), the concept
+* SampleRateConverter lets pipelines swap converters without virtual calls.
+*
+* @author Alexander Sacharov <a.sacharov@gmx.de>
+*
+* Project : Digital Signal Processing
+****************************************************************************/
+
+#ifndef INCLUDE_CPPSL_MATH_DSP_SRC_HPP
+#define INCLUDE_CPPSL_MATH_DSP_SRC_HPP
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// global Structures, Typedefs, Enums, Unions
+//-----------------------------------------------------------------------------
+
+namespace cppsl::math {
+
+/// Result of a span based conversion.
+struct ConvertResult {
+  size_t consumed{0};   ///< input samples consumed
+  size_t produced{0};   ///< output samples written
+};
+
+/// A sampling rate converter usable in a pipeline.
+template <typename C>
+concept SampleRateConverter = requires(C conv, std::span<const typename C::sample_type> in,
+                                       std::span<typename C::sample_type> out, size_t n) {
+  { conv.Convert(in, out) } -> std::same_as<ConvertResult>;
+  { conv.maxOutputFor(n) } -> std::convertible_to<size_t>;
+};
+
+//-----------------------------------------------------------------------------
+// global Function Prototypes
+//-----------------------------------------------------------------------------
+
+/// CRTP base of the sampling rate converters.
+/// @tparam Derived the converter, provides Convert(span, span) and maxOutputFor(n)
+/// @tparam T sample type
+
+template <typename Derived, typename T>
+class SmpRateConvBase {
+ public:
+  using sample_type = T;
+
+  /**
+   * @brief Convert sampling rate
+   * @param inc_sample_data incoming buffer, consumed completely
+   * @param out_waveform the output buffer, results are appended
+   * @return number of samples appended to the output buffer
+   */
+  int Convert(std::vector<T>& inc_sample_data, std::vector<T>& out_waveform) {
+    const size_t old = out_waveform.size();
+    out_waveform.resize(old + derived().maxOutputFor(inc_sample_data.size()));
+    const auto res = derived().Convert(std::span<const T>(inc_sample_data), std::span<T>(out_waveform).subspan(old));
+    out_waveform.resize(old + res.produced);
+    return (int)res.produced;
+  }
+
+ protected:
+  /**
+   * @brief Time bookkeeping of the converters with a floating point ratio.
+   * @details An output is due when the next input time m_inT has passed the
+   * output time m_T. Both are rebased when the input is exhausted to stay small.
+   */
+  struct Clock {
+    double m_dT{1.0};   ///< input samples per output sample
+    double m_T{0.0};    ///< time of the next output
+    int m_inT{0};       ///< time of the next input
+
+    /**
+     * @brief Sets the ratio and resets the time
+     * @param in_sampling_rate input sample rate
+     * @param out_sampling_rate output sample rate
+     */
+    void Initialize(int in_sampling_rate, int out_sampling_rate) {
+      m_dT = (double)in_sampling_rate / (double)out_sampling_rate;
+      m_T = 0.0;
+      m_inT = 0;
+    }
+
+    /**
+     * @brief Upper bound of outputs due until n more inputs are consumed
+     * @param n number of input samples
+     * @return number of output samples
+     */
+    [[nodiscard]] size_t MaxOutputFor(size_t n) const {
+      const double span = (double)m_inT + (double)n - m_T;
+      return span > 0.0 ? (size_t)std::ceil(span / m_dT) + 1 : 0;
+    }
+
+    /**
+     * @brief Keeps the time values small, preserving their difference
+     */
+    void Rebase() {
+      if (m_inT < m_T) {
+        m_T = m_T - (double)m_inT;
+        m_inT = 0;
+      } else {
+        m_inT = m_inT - (int)m_T;
+        m_T = m_T - (double)(int)m_T;
+      }
+    }
+
+    /**
+     * @brief Fraction of the output time between two inputs
+     * @return value in [0, 1)
+     */
+    [[nodiscard]] double Fraction() const { return m_T - (double)(int)m_T; }
+  };
+
+  /**
+   * @brief Conversion loop of the clocked converters
+   * @details Calls Derived::Push(T) for every consumed input and
+   * Derived::Compute() for every produced output.
+   * @param clock the time bookkeeping
+   * @param in input samples
+   * @param out output samples
+   * @return consumed and produced sample counts
+   */
+  ConvertResult ConvertClocked(Clock& clock, std::span<const T> in, std::span<T> out) {
+    ConvertResult res;
+    while (true) {
+      while (clock.m_inT <= clock.m_T) {
+        if (res.consumed == in.size()) {
+          clock.Rebase();
+          return res;
+        }
+        clock.m_inT++;
+        derived().Push(in[res.consumed++]);
+      }
+      if (res.produced == out.size()) {
+        return res;
+      }
+      out[res.produced++] = derived().Compute();
+      clock.m_T = clock.m_T + clock.m_dT;
+    }
+  }
+
+  /**
+   * @brief Clamps and converts a computed value to the sample type
+   * @details The maximum of T may round up when converted to V (INT32_MAX becomes 2^31 as float),
+   * so a value equal to the converted maximum is clamped too.
+   * @param value the computed value
+   * @return the output sample
+   */
+  template <typename V>
+  static T Limit(V value) {
+    if (value >= static_cast<V>(std::numeric_limits<T>::max()))
+      return std::numeric_limits<T>::max();
+    if (value < static_cast<V>(std::numeric_limits<T>::lowest()))
+      return std::numeric_limits<T>::lowest();
+    return static_cast<T>(value);
+  }
+
+ private:
+  Derived& derived() { return static_cast<Derived&>(*this); }
+};
+
+}   // namespace cppsl::math
+
+#endif /* INCLUDE_CPPSL_MATH_DSP_SRC_HPP */
@@ -19,6 +19,10 @@
 * 4) https://www.hpmemoryproject.org/an/pdf/an_243.pdf
 * 5) https://en.wikipedia.org/wiki/Window_function
 *
+* int16_t and int32_t samples are filtered with Q15/Q31 coefficient rows
+* and saturating integer arithmetic (details/fixedPoint.hpp), they are never
+* converted to double.
+*
 * @author Alexander Sacharov <a.sacharov@gmx.de>
 *
 * Project : Digital Signal Processing
@@ -33,8 +37,13 @@
 //-----------------------------------------------------------------------------
 #include <cmath>
 #include <limits>
+#include <span>
 #include <vector>
 #include <stdexcept>
+#include <type_traits>
+
+#include <cppsl/math/details/fixedPoint.hpp>
+#include <cppsl/math/samplRateConv.hpp>
 
 //-----------------------------------------------------------------------------
 // global Defines and Macros
@@ -61,7 +70,7 @@ namespace cppsl::math {
   /// add a linear interpolation calculation of the missing FIR values of the filter.
   
   template <typename T>
-  class SmpRateConvFIR {
+  class SmpRateConvFIR : public SmpRateConvBase<SmpRateConvFIR<T>, T> {
     const double PI_RAD = 3.141592653589793238463;
    public:
     /**
@@ -141,77 +150,88 @@ namespace cppsl::math {
 
       for (int i = m_mul_count; i-- > 0;)
         m_buff[i] = 0;
-      m_dT = (double)in_sampling_rate / (double)out_sample_rate;
-      m_T = 0.0;
-      m_inT = 0;
+
+      if constexpr (details::isFixedPoint<T>) {
+        // one coefficient row per shift in the order of the delay line
+        const size_t row = m_buff.size();
+        m_phasesQ.assign((m_oversampling + 1) * row, 0);
+        for (int shift = 0; shift <= m_oversampling; ++shift) {
+          auto* coef = &m_phasesQ[shift * row];
+          int k, i;
+          for (k = shift, i = 0; k < (int)m_fir.size(); k += m_oversampling)
+            coef[i++] = details::ToQ<T>(m_fir[k]);
+          for (k = m_fir_length1 - k; k >= 0; k -= m_oversampling)
+            coef[i++] = details::ToQ<T>(m_fir[k]);
+        }
+      }
+      m_clock.Initialize(in_sampling_rate, out_sample_rate);
 
       return true;
     }
 
     /**
    * @brief Convert sampling rate
-   * @param inc_sample_data incoming buffer
-   * @param out_waveform the output buffer, must be of an appropriate size
-   * @return number of samples in the output buffer
+   * @param in incoming samples
+   * @param out the output samples
+   * @return number of samples consumed from in and written to out
    */
-    int Convert(std::vector<T>& inc_sample_data, std::vector<T>& out_waveform) {
-      int outCount = 0;
-      int s = 0;
-      while (true) {
-        while (m_inT <= m_T) {
-          m_inT++;
-
-          /*
-         * filtering buffer, delay line
-         */
-          for (int i = m_mul_count; --i > 0;)
-            m_buff[i] = m_buff[i - 1];
-
-          m_buff[0] = inc_sample_data[s++];
-          if (s >= (int)inc_sample_data.size()) {
-            if (m_inT < m_T) {
-              m_T = m_T - (double)m_inT;
-              m_inT = 0;
-            } else {
-              m_inT = m_inT - (int)m_T;
-              m_T = m_T - (double)(int)m_T;
-            }
-            return outCount;
-          }
-        }
+    ConvertResult Convert(std::span<const T> in, std::span<T> out) {
+      return this->ConvertClocked(m_clock, in, out);
+    }
+
+    using SmpRateConvBase<SmpRateConvFIR<T>, T>::Convert;
+
+    /**
+   * @brief Upper bound of the output samples for the next inputs
+   * @param n number of input samples
+   * @return maximal number of output samples
+   */
+    [[nodiscard]] size_t maxOutputFor(size_t n) const { return m_clock.MaxOutputFor(n); }
+
+   private:
+    friend class SmpRateConvBase<SmpRateConvFIR<T>, T>;
 
-        /*
+    /**
+   * @brief Filtering buffer, delay line
+   * @param sample the new input sample
+   */
+    void Push(T sample) {
+      for (int i = m_mul_count; --i > 0;)
+        m_buff[i] = m_buff[i - 1];
+      m_buff[0] = sample;
+    }
+
+    /**
+   * @brief Computes the output sample at the current time
+   * @return the output sample
+   */
+    T Compute() {
+      /*
        * the nearest initial displacement on the time axis
        */
-        int shift = (int)(0.5 + m_oversampling * (m_T - (double)(int)m_T));
-        /*
+      int shift = (int)(0.5 + m_oversampling * m_clock.Fraction());
+
+      if constexpr (details::isFixedPoint<T>) {
+        const size_t row = m_buff.size();
+        return details::NarrowQ<T>(details::AccumulateQ(typename details::QFormat<T>::accu_type(0), &m_phasesQ[shift * row], m_buff.data(), row));
+      }
+      /*
        * To increase accuracy at small oversampling value you can
        * additionally calculate by interpolation value of the filter coefficient at the required point
        */
-        double fout = 0.0;
-        int k, i;
-        // first half of the FIR filter
-        for (k = shift, i = 0; k < (int)m_fir.size(); k += m_oversampling)
-          fout += m_fir[k] * m_buff[i++];
-        // second half of the FIR filter
-        for (k = m_fir_length1 - k; k >= 0; k -= m_oversampling)
-          fout += m_fir[k] * m_buff[i++];
-
-        // amplitude limit
-        if (fout > std::numeric_limits<T>::max())
-          fout = std::numeric_limits<T>::max();
-
-        if (fout < std::numeric_limits<T>::lowest())
-          fout = std::numeric_limits<T>::lowest();
-
-        out_waveform.push_back(fout);
-        outCount++;
-        m_T = m_T + m_dT;
-      }
+      double fout = 0.0;
+      int k, i;
+      // first half of the FIR filter
+      for (k = shift, i = 0; k < (int)m_fir.size(); k += m_oversampling)
+        fout += m_fir[k] * m_buff[i++];
+      // second half of the FIR filter
+      for (k = m_fir_length1 - k; k >= 0; k -= m_oversampling)
+        fout += m_fir[k] * m_buff[i++];
+
+      // amplitude limit
+      return this->Limit(fout);
     }
 
-   private:
-
     /** @brief Windowing. Gets Blackman window element
    * @details in
    * 1) Harris, Fredric J. (Jan 1978). "On the use of Windows for
@@ -236,10 +256,9 @@ namespace cppsl::math {
     int m_oversampling;
     int m_fir_length1;
     std::vector<double> m_fir;
-    std::vector<double> m_buff;
-    double m_dT;
-    double m_T;
-    int m_inT;
+    std::vector<std::conditional_t<details::isFixedPoint<T>, T, double>> m_buff;
+    std::vector<typename details::QFormat<T>::coef_type> m_phasesQ;
+    typename SmpRateConvFIR::Clock m_clock;
   };
 
 }   // namespace cppsl::math
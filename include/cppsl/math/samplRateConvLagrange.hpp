@@ -22,6 +22,18 @@
 * 4) https://www.hpmemoryproject.org/an/pdf/an_243.pdf
 * 5) https://en.wikipedia.org/wiki/Window_function
 *
+* The weights of the N+1 taps depend only on the fractional phase. Evaluating
+* the basis for every output costs O(N^2) with a division per term, so
+* LagrangeWeights selects:
+* 1) direct - the basis per output sample, the reference,
+* 2) table - weights cached per phase, exact for rational rate pairs whose
+*    phase cycle fits the table, otherwise quantized to the table resolution,
+*    O(N) per output,
+* 3) farrow - the weights as polynomials of the fraction (Farrow structure),
+*    exact for arbitrary ratios, (N+1)^2 multiply-adds and no division.
+* int16_t and int32_t samples stay integer, the weights are applied as
+* Q15/Q31 values with saturating arithmetic (details/fixedPoint.hpp).
+*
 * @author Alexander Sacharov <a.sacharov@gmx.de>
 *
 * Project : Digital Signal Processing
@@ -33,11 +45,16 @@
 //-----------------------------------------------------------------------------
 // includes
 //-----------------------------------------------------------------------------
+#include <algorithm>
 #include <cmath>
-#include <limits>
+#include <numeric>
+#include <span>
 #include <vector>
 #include <stdexcept>
-#include <limits>
+#include <type_traits>
+
+#include <cppsl/math/details/fixedPoint.hpp>
+#include <cppsl/math/samplRateConv.hpp>
 
 //-----------------------------------------------------------------------------
 // global Defines and Macros
@@ -55,14 +72,20 @@
 // global Function Prototypes
 //-----------------------------------------------------------------------------
 
-namespace DSP {
-namespace SRC {
+namespace cppsl::math {
+
+  /// Evaluation of the Lagrange weights of SmpRateConvLagrange
+  enum class LagrangeWeights : unsigned char {
+    direct,   ///< basis evaluated for every output sample
+    table,    ///< weights cached per phase
+    farrow    ///< weights from polynomials of the fraction
+  };
 
   /// A sampling rate converter with Lagrange interpolation.
   /// The output signal is delayed by (N+1)/2 samples.
 
   template <typename T>
-  class SmpRateConvLagrange {
+  class SmpRateConvLagrange : public SmpRateConvBase<SmpRateConvLagrange<T>, T> {
    public:
     SmpRateConvLagrange() {
       Initialize(1, 1, (unsigned char)1);
@@ -73,9 +96,12 @@ namespace SRC {
    * @param in_sampling_rate input sample frequency
    * @param out_sampling_rate output sample frequency
    * @param interpolation_order interpolation order. The value must be odd!
+   * @param weights evaluation of the interpolation weights
+   * @param resolution phases of the table, 0 selects the rational phase cycle
    */
-    SmpRateConvLagrange(int in_sampling_rate, int out_sampling_rate, unsigned char interpolation_order = 1) {
-      Initialize(in_sampling_rate, out_sampling_rate, interpolation_order);
+    SmpRateConvLagrange(int in_sampling_rate, int out_sampling_rate, unsigned char interpolation_order = 1,
+                        LagrangeWeights weights = LagrangeWeights::direct, unsigned resolution = 0) {
+      Initialize(in_sampling_rate, out_sampling_rate, interpolation_order, weights, resolution);
     }
 
     /**
@@ -83,96 +109,201 @@ namespace SRC {
    * @param in_sampling_rate input sample rate
    * @param out_sampling_rate output sample rate
    * @param interpolation interpolation order
+   * @param weights evaluation of the interpolation weights
+   * @param resolution phases of the table, 0 selects the rational phase cycle
+   * of the rate pair, or tableResolution if the cycle is longer
    */
-    bool Initialize(int in_sampling_rate, int out_sampling_rate, unsigned char interpolation) {
+    bool Initialize(int in_sampling_rate, int out_sampling_rate, unsigned char interpolation,
+                    LagrangeWeights weights = LagrangeWeights::direct, unsigned resolution = 0) {
       if ((interpolation & 1) == 0) {
         throw std::invalid_argument("the interpolation value must be odd");
       }
       m_interpolation = interpolation;
       m_Hinterpolation = (unsigned char)((interpolation - 1) >> 1);
-      m_pF.resize(m_interpolation + 1);
+      m_pF.assign(m_interpolation + 1, 0);
       m_pLI.resize(m_interpolation + 1);
+      m_pLIQ.resize(m_interpolation + 1);
       m_wrPos = m_interpolation;
-      m_dT = (double)in_sampling_rate / (double)out_sampling_rate;
-      m_T = 0.0;
-      m_inT = 0;
-      return (m_dT > 0.0);
+      m_weights = weights;
+      m_clock.Initialize(in_sampling_rate, out_sampling_rate);
+
+      const size_t taps = m_interpolation + 1;
+      m_table.clear();
+      if (m_weights == LagrangeWeights::table) {
+        if (resolution == 0) {
+          // the phases of in/out repeat after out/gcd outputs
+          const int cycle = out_sampling_rate / std::max(1, std::gcd(in_sampling_rate, out_sampling_rate));
+          resolution = (cycle > 0 && cycle <= (int)maxCycle) ? (unsigned)cycle : tableResolution;
+        }
+        m_resolution = resolution;
+        m_table.resize((m_resolution + 1) * taps);
+        for (unsigned p = 0; p <= m_resolution; ++p) {
+          Basis((double)p / m_resolution, &m_table[p * taps]);
+        }
+        if constexpr (details::isFixedPoint<T>) {
+          m_tableQ.resize(m_table.size());
+          for (size_t i = 0; i < m_table.size(); ++i) {
+            m_tableQ[i] = details::ToQ<T>(m_table[i]);
+          }
+        }
+      } else if (m_weights == LagrangeWeights::farrow) {
+        FarrowCoefficients();
+      }
+      return (m_clock.m_dT > 0.0);
     }
 
     /**
    * @brief Convert sampling rate
-   * @param inc_sample_data incoming buffer
-   * @param out_waveform the output buffer, must be of an appropriate size
-   * @return number of samples in the output buffer
+   * @param in incoming samples
+   * @param out the output samples
+   * @return number of samples consumed from in and written to out
    */
-    int Convert(std::vector<T>& inc_sample_data, std::vector<T>& out_waveform) {
-      int outCount = 0;
-      int s = 0;
-
-      while (true) {
-        while (m_inT <= (int)m_T) {
-          m_inT++;
-          m_pF[m_wrPos++] = inc_sample_data[s++];
-          if (m_wrPos > m_interpolation)
-            m_wrPos = 0;
-          if (s >= (int)inc_sample_data.size()) {
-            if (m_inT < m_T) {
-              m_T = m_T - (double)m_inT;
-              m_inT = 0;
-            } else {
-              m_inT = m_inT - (int)m_T;
-              m_T = m_T - (double)(int)m_T;
-            }
-            return outCount;
-          }
-        }
+    ConvertResult Convert(std::span<const T> in, std::span<T> out) {
+      return this->ConvertClocked(m_clock, in, out);
+    }
+
+    using SmpRateConvBase<SmpRateConvLagrange<T>, T>::Convert;
+
+    /**
+   * @brief Upper bound of the output samples for the next inputs
+   * @param n number of input samples
+   * @return maximal number of output samples
+   */
+    [[nodiscard]] size_t maxOutputFor(size_t n) const { return m_clock.MaxOutputFor(n); }
+
+   private:
+    friend class SmpRateConvBase<SmpRateConvLagrange<T>, T>;
+
+    /**
+   * @brief Writes a sample into the circular history
+   * @param sample the new input sample
+   */
+    void Push(T sample) {
+      m_pF[m_wrPos++] = sample;
+      if (m_wrPos > m_interpolation)
+        m_wrPos = 0;
+    }
 
-        double D = (double)m_Hinterpolation + m_T - (double)(int)m_T;
+    /**
+   * @brief Computes the output sample at the current time
+   * @return the output sample
+   */
+    T Compute() {
+      const double fraction = m_clock.Fraction();
+      const double* weights = m_pLI.data();
+      const size_t taps = m_interpolation + 1;
 
-        for (unsigned char n = 0; n <= m_interpolation; ++n) {
-          m_pLI[n] = 1.0;
-          for (unsigned char k = 0; k <= m_interpolation; ++k) {
-            if (n != k) {
-              m_pLI[n] = m_pLI[n] * (D - (double)k) / (double)(n - k);
+      switch (m_weights) {
+        case LagrangeWeights::table:
+          weights = &m_table[(size_t)(0.5 + fraction * m_resolution) * taps];
+          break;
+        case LagrangeWeights::farrow:
+          // Horner scheme over the powers of the fraction
+          for (size_t n = 0; n < taps; ++n) {
+            const double* c = &m_table[n * taps];
+            double w = c[m_interpolation];
+            for (size_t j = m_interpolation; j-- > 0;) {
+              w = w * fraction + c[j];
             }
+            m_pLI[n] = w;
+          }
+          break;
+        default:
+          Basis(fraction, m_pLI.data());
+          break;
+      }
+
+      if constexpr (details::isFixedPoint<T>) {
+        const typename details::QFormat<T>::coef_type* weightsQ = m_pLIQ.data();
+        if (m_weights == LagrangeWeights::table) {
+          weightsQ = &m_tableQ[(size_t)(0.5 + fraction * m_resolution) * taps];
+        } else {
+          for (size_t n = 0; n < taps; ++n) {
+            m_pLIQ[n] = details::ToQ<T>(m_pLI[n]);
           }
         }
+        // the history starts with the oldest sample at m_wrPos
+        const size_t older = taps - m_wrPos;
+        auto acc = details::AccumulateQ(typename details::QFormat<T>::accu_type(0), weightsQ, &m_pF[m_wrPos], older);
+        acc = details::AccumulateQ(acc, weightsQ + older, m_pF.data(), m_wrPos);
+        return details::NarrowQ<T>(acc);
+      }
 
-        double fout = 0.0;
+      double fout = 0.0;
 
-        for (unsigned char k = 0, index = m_wrPos;;) {
-          fout = fout + m_pLI[k++] * m_pF[index];
-          if (k > m_interpolation)
-            break;
-          if (++index > m_interpolation)
-            index = 0;
-        }
+      for (unsigned char k = 0, index = m_wrPos;;) {
+        fout = fout + weights[k++] * m_pF[index];
+        if (k > m_interpolation)
+          break;
+        if (++index > m_interpolation)
+          index = 0;
+      }
 
-        // check amplitude for limits
-        if (fout > std::numeric_limits<T>::max())
-          fout = std::numeric_limits<T>::max();
+      // check amplitude for limits
+      return this->Limit(fout);
+    }
 
-        if (fout < std::numeric_limits<T>::lowest())
-          fout = std::numeric_limits<T>::lowest();
+    /**
+   * @brief Evaluates the Lagrange basis at a fraction
+   * @param fraction the output time between two inputs, [0, 1]
+   * @param weights the m_interpolation + 1 weights
+   */
+    void Basis(double fraction, double* weights) const {
+      double D = (double)m_Hinterpolation + fraction;
 
-        out_waveform.push_back(fout);
-        outCount++;
-        m_T = m_T + m_dT;
+      for (unsigned char n = 0; n <= m_interpolation; ++n) {
+        weights[n] = 1.0;
+        for (unsigned char k = 0; k <= m_interpolation; ++k) {
+          if (n != k) {
+            weights[n] = weights[n] * (D - (double)k) / (double)(n - k);
+          }
+        }
       }
     }
 
+    /**
+   * @brief Expands every basis polynomial in powers of the fraction
+   * @details Row n of m_table holds c[j] with weight n = sum c[j] * fraction^j.
+   */
+    void FarrowCoefficients() {
+      const size_t taps = m_interpolation + 1;
+      m_table.assign(taps * taps, 0.0);
+      for (unsigned char n = 0; n <= m_interpolation; ++n) {
+        double* c = &m_table[n * taps];
+        c[0] = 1.0;
+        size_t degree = 0;
+        for (unsigned char k = 0; k <= m_interpolation; ++k) {
+          if (n == k) {
+            continue;
+          }
+          // multiply by (fraction + H - k) / (n - k)
+          const double offset = (double)m_Hinterpolation - (double)k;
+          const double scale = 1.0 / (double)(n - k);
+          ++degree;
+          for (size_t j = degree; j > 0; --j) {
+            c[j] = (c[j - 1] + c[j] * offset) * scale;
+          }
+          c[0] = c[0] * offset * scale;
+        }
+      }
+    }
 
-   private:
-    double m_dT;
-    double m_T;
-    int m_inT;
-    std::vector<double> m_pF;
+    static constexpr unsigned maxCycle = 4096;          ///< longest rational phase cycle kept exactly
+    static constexpr unsigned tableResolution = 1024;   ///< phases of the quantized table
+
+    typename SmpRateConvLagrange::Clock m_clock;
+    std::vector<std::conditional_t<details::isFixedPoint<T>, T, double>> m_pF;
     unsigned char m_wrPos;
     std::vector<double> m_pLI;
     unsigned char m_interpolation;
     unsigned char m_Hinterpolation;
+    LagrangeWeights m_weights{LagrangeWeights::direct};   ///< evaluation of the weights
+    unsigned m_resolution{0};                            ///< phases of the table
+    std::vector<double> m_table;                         ///< weights per phase or Farrow coefficients
+    std::vector<typename details::QFormat<T>::coef_type> m_tableQ;   ///< fixed-point weights per phase
+    std::vector<typename details::QFormat<T>::coef_type> m_pLIQ;     ///< fixed-point weights of one output
   };
 
-}  // namespace SRC
+}   // namespace cppsl::math
 
 #endif /* INCLUDE_CPPSL_MATH_DSP_SRC_LAGRANGE_HPP */
@@ -29,11 +29,13 @@
 // includes
 //-----------------------------------------------------------------------------
 #include <cmath>
-#include <iostream>
 #include <limits>
+#include <span>
 #include <stdexcept>
 #include <vector>
 
+#include <cppsl/math/samplRateConv.hpp>
+
 //-----------------------------------------------------------------------------
 // global Defines and Macros
 //-----------------------------------------------------------------------------
@@ -56,7 +58,7 @@ namespace cppsl::math {
   /// The output signal will have a 1-sample delay
 
   template <typename T>
-  class SmpRateConvLinear {
+  class SmpRateConvLinear : public SmpRateConvBase<SmpRateConvLinear<T>, T> {
    public:
     /**
    * @brief default constructor
@@ -99,44 +101,69 @@ namespace cppsl::math {
 
     /**
      * @brief Convert sampling rate
-     * @param inc_sample_data incoming buffer
-     * @param out_waveform the output buffer, will be set to an appropriate size
-     * @return number of samples in the output buffer
+     * @param in incoming samples
+     * @param out the output samples
+     * @return number of samples consumed from in and written to out
      */
-    int Convert(std::vector<T>& inc_sample_data, std::vector<T>& out_waveform) {
-      int out_count = 0;
-      int s = 0;
-
+    ConvertResult Convert(std::span<const T> in, std::span<T> out) {
+      ConvertResult res;
       while (true) {
         while (m_inT <= m_T) {
+          if (res.consumed == in.size()) {
+            Rebase();
+            return res;
+          }
           // get previous
-          m_previous = inc_sample_data[s++];
+          m_previous = in[res.consumed++];
           m_inT++;
-          if (s >= (int)inc_sample_data.size()) {
-            if (m_inT < m_T) {
-              m_T = m_T - m_inT;
-              m_inT = 0;
-            } else {
-              m_inT = m_inT - m_T;
-              m_T = 0;
-            }
-            return out_count;
-          }
+        }
+        // the interpolation needs the next sample too
+        if (res.consumed == in.size()) {
+          Rebase();
+          return res;
+        }
+        if (res.produced == out.size()) {
+          return res;
         }
 
         T temp = (T)((long long)m_previous +
-                     (long long)(((long long)m_Tf * (long long)((long long)inc_sample_data[s] - (long long)m_previous)) >>
+                     (long long)(((long long)m_Tf * (long long)((long long)in[res.consumed] - (long long)m_previous)) >>
                                  m_accuracy));
 
-        out_waveform.push_back(temp);
-        out_count++;
+        out[res.produced++] = temp;
         long long t = m_Tf + m_dTf;
         m_T = m_T + m_dT + (long long)(t >> m_accuracy);
         m_Tf = t & m_mask;
       }
     }
 
+    using SmpRateConvBase<SmpRateConvLinear<T>, T>::Convert;
+
+    /**
+     * @brief Upper bound of the output samples for the next inputs
+     * @param n number of input samples
+     * @return maximal number of output samples
+     */
+    [[nodiscard]] size_t maxOutputFor(size_t n) const {
+      const double step = (double)m_dT + std::ldexp((double)m_dTf, -m_accuracy);
+      const double span = (double)m_inT + (double)n - ((double)m_T + std::ldexp((double)m_Tf, -m_accuracy));
+      return span > 0.0 ? (size_t)std::ceil(span / step) + 1 : 0;
+    }
+
    private:
+    /**
+     * @brief Keeps the time values small, preserving their difference
+     */
+    void Rebase() {
+      if (m_inT < m_T) {
+        m_T = m_T - m_inT;
+        m_inT = 0;
+      } else {
+        m_inT = m_inT - m_T;
+        m_T = 0;
+      }
+    }
+
     unsigned char m_accuracy{1};  ///< accuracy shift bits
     long long m_mask{0xffff};     ///< mask for the shifted approximated number
     long long m_dTf{0};           ///<
@@ -0,0 +1,228 @@
+/************************************************************************//**
+* @file
+* @brief   Multi-channel polyphase Sampling Rate Converter.
+* @details Resamples all channels of a frame stream in one pass, as needed
+* for the currents and voltages of an IEC 61850-9-2 ASDU. The output time,
+* the fractional phase and the selected coefficient row are computed once
+* per output instant and applied to all channels:
+* 1) the history is a double-length circular buffer of frames, each frame
+*    row holds the channels side by side, padded to the SIMD block size,
+* 2) every filter tap is one vectorized multiply-accumulate over the
+*    channels (details::Axpy).
+* The filter is the one of SmpRateConvPolyphase and SmpRateConvFIR.
+* Frames can be interleaved (Convert) or planar (ConvertPlanar).
+*
+* @author Alexander Sacharov <a.sacharov@gmx.de>
+*
+* Project : Digital Signal Processing
+****************************************************************************/
+
+#ifndef INCLUDE_CPPSL_MATH_DSP_SRC_MULTI_CHANNEL_HPP
+#define INCLUDE_CPPSL_MATH_DSP_SRC_MULTI_CHANNEL_HPP
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <cppsl/math/details/dotProduct.hpp>
+#include <cppsl/math/details/firPrototype.hpp>
+#include <cppsl/math/samplRateConv.hpp>
+
+//-----------------------------------------------------------------------------
+// global Function Prototypes
+//-----------------------------------------------------------------------------
+
+namespace cppsl::math {
+
+/// Multi-channel polyphase sample rate converter with low pass FIR filter.
+/// The interleaved Convert counts samples, only complete frames are consumed
+/// and produced. ConvertPlanar counts frames.
+/// @tparam T sample type
+/// @tparam TCoef coefficient and accumulator type, float or double
+
+template <typename T, typename TCoef = float>
+class SmpRateConvMultiChannel : public SmpRateConvBase<SmpRateConvMultiChannel<T, TCoef>, T> {
+  static_assert(std::is_same_v<TCoef, float> || std::is_same_v<TCoef, double>, "TCoef must be float or double");
+
+ public:
+  /**
+   * @brief Default constructor, one channel
+   */
+  SmpRateConvMultiChannel() { Initialize(1, 1, 1, 2, 1); }
+
+  /**
+   * @brief Initialization
+   * @param in_sampling_rate the input sample rate
+   * @param out_sample_rate the output sample rate
+   * @param oversampling the number of filter phases between two input samples
+   * @param mul the number of multiplications per output sample and channel
+   * @param channels the number of channels per frame
+   */
+  SmpRateConvMultiChannel(int in_sampling_rate, int out_sample_rate, int oversampling, unsigned char mul,
+                          size_t channels) {
+    Initialize(in_sampling_rate, out_sample_rate, oversampling, mul, channels);
+  }
+
+  /**
+   * @brief Parameter initialization, builds the phase table
+   * @param in_sampling_rate input sample rate
+   * @param out_sample_rate output sample rate
+   * @param oversampling the number of filter phases between two input samples
+   * @param mul the number of multiplications per output sample and channel
+   * @param channels the number of channels per frame
+   * @return true if successful, otherwise false
+   */
+  bool Initialize(int in_sampling_rate, int out_sample_rate, int oversampling, unsigned char mul, size_t channels) {
+    if ((mul & oversampling & 1) != 0 || oversampling <= 0 || mul == 0 || channels == 0) {
+      return false;
+    }
+
+    m_oversampling = oversampling;
+    m_taps = mul;
+    m_channels = channels;
+    m_stride = (channels + details::dotBlock - 1) / details::dotBlock * details::dotBlock;
+    const auto prototype = details::FirPrototype(oversampling, mul);
+    const int length = static_cast<int>(prototype.size());
+
+    // phase p holds the taps p, p + oversampling, ... of the prototype
+    m_phases.assign(static_cast<size_t>(m_oversampling + 1) * m_taps, TCoef(0));
+    for (int p = 0; p <= m_oversampling; ++p) {
+      for (int i = 0, k = p; i < mul && k < length; ++i, k += m_oversampling) {
+        m_phases[p * m_taps + i] = static_cast<TCoef>(prototype[k]);
+      }
+    }
+
+    m_history.assign(2 * m_taps * m_stride, TCoef(0));
+    m_accu.assign(m_stride, TCoef(0));
+    m_newest = 0;
+    m_clock.Initialize(in_sampling_rate, out_sample_rate);
+    return true;
+  }
+
+  /**
+   * @brief Convert sampling rate of interleaved frames
+   * @param in incoming samples, frame after frame
+   * @param out the output samples, frame after frame
+   * @return number of samples consumed from in and written to out, multiples of channels()
+   */
+  ConvertResult Convert(std::span<const T> in, std::span<T> out) {
+    const auto ch = m_channels;
+    const auto res = Run(
+       in.size() / ch, out.size() / ch, [&](size_t frame, size_t c) { return in[frame * ch + c]; },
+       [&](size_t frame, size_t c, T value) { out[frame * ch + c] = value; });
+    return {res.consumed * ch, res.produced * ch};
+  }
+
+  using SmpRateConvBase<SmpRateConvMultiChannel<T, TCoef>, T>::Convert;
+
+  /**
+   * @brief Convert sampling rate of planar frames
+   * @param in one span of incoming samples per channel
+   * @param out one span of output samples per channel
+   * @return number of frames consumed from in and written to out
+   * @exception invalid_argument if in or out holds fewer spans than channels
+   */
+  ConvertResult ConvertPlanar(std::span<const std::span<const T>> in, std::span<const std::span<T>> out) {
+    if (in.size() < m_channels || out.size() < m_channels) {
+      throw std::invalid_argument(std::to_string(in.size()) + " input and " + std::to_string(out.size()) +
+                                  " output planes for " + std::to_string(m_channels) + " channels");
+    }
+    size_t inFrames = in.empty() ? 0 : in[0].size();
+    size_t outFrames = out.empty() ? 0 : out[0].size();
+    for (size_t c = 0; c < m_channels; ++c) {
+      inFrames = std::min(inFrames, in[c].size());
+      outFrames = std::min(outFrames, out[c].size());
+    }
+    return Run(
+       inFrames, outFrames, [&](size_t frame, size_t c) { return in[c][frame]; },
+       [&](size_t frame, size_t c, T value) { out[c][frame] = value; });
+  }
+
+  /**
+   * @brief Upper bound of the output samples for the next inputs
+   * @param n number of input samples, complete frames are counted
+   * @return maximal number of output samples
+   */
+  [[nodiscard]] size_t maxOutputFor(size_t n) const { return m_clock.MaxOutputFor(n / m_channels) * m_channels; }
+
+  /**
+   * @brief Returns the number of channels
+   * @return channels per frame
+   */
+  [[nodiscard]] size_t channels() const { return m_channels; }
+
+ private:
+  /**
+   * @brief Conversion loop over frames
+   * @param inFrames number of available input frames
+   * @param outFrames number of available output frames
+   * @param read returns sample c of input frame
+   * @param write stores sample c of output frame
+   * @return consumed and produced frame counts
+   */
+  template <typename Read, typename Write>
+  ConvertResult Run(size_t inFrames, size_t outFrames, Read read, Write write) {
+    ConvertResult res;
+    while (true) {
+      while (m_clock.m_inT <= m_clock.m_T) {
+        if (res.consumed == inFrames) {
+          m_clock.Rebase();
+          return res;
+        }
+        m_clock.m_inT++;
+        PushFrame(res.consumed++, read);
+      }
+      if (res.produced == outFrames) {
+        return res;
+      }
+
+      // phase and coefficient row once for all channels
+      const int shift = (int)(0.5 + m_oversampling * m_clock.Fraction());
+      const TCoef* coef = &m_phases[shift * m_taps];
+      std::fill(m_accu.begin(), m_accu.end(), TCoef(0));
+      for (size_t i = 0; i < m_taps; ++i) {
+        details::Axpy(m_accu.data(), coef[i], &m_history[(m_newest + i) * m_stride], m_stride);
+      }
+      for (size_t c = 0; c < m_channels; ++c) {
+        write(res.produced, c, this->Limit(m_accu[c]));
+      }
+      res.produced++;
+      m_clock.m_T = m_clock.m_T + m_clock.m_dT;
+    }
+  }
+
+  /**
+   * @brief Writes an input frame into both halves of the history
+   * @param frame the index of the input frame
+   * @param read returns sample c of input frame
+   */
+  template <typename Read>
+  void PushFrame(size_t frame, Read& read) {
+    m_newest = (m_newest == 0 ? m_taps : m_newest) - 1;
+    TCoef* first = &m_history[m_newest * m_stride];
+    TCoef* second = &m_history[(m_newest + m_taps) * m_stride];
+    for (size_t c = 0; c < m_channels; ++c) {
+      first[c] = second[c] = static_cast<TCoef>(read(frame, c));
+    }
+  }
+
+  int m_oversampling{1};                             ///< number of phases between two input samples
+  size_t m_taps{0};                                  ///< coefficients per phase
+  size_t m_channels{1};                              ///< channels per frame
+  size_t m_stride{0};                                ///< history row length, channels padded to the SIMD block
+  std::vector<TCoef> m_phases;                       ///< (oversampling + 1) rows of m_taps coefficients
+  std::vector<TCoef> m_history;                      ///< double-length circular history of frame rows
+  std::vector<TCoef> m_accu;                         ///< accumulators of one output frame
+  size_t m_newest{0};                                ///< row of the newest frame in the first half
+  typename SmpRateConvMultiChannel::Clock m_clock;   ///< input and output time
+};
+
+}   // namespace cppsl::math
+
+#endif /* INCLUDE_CPPSL_MATH_DSP_SRC_MULTI_CHANNEL_HPP */
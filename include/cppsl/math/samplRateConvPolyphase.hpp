@@ -0,0 +1,146 @@
+/************************************************************************//**
+* @file
+* @brief   Polyphase Sampling Rate Converter with a finite impulse response (FIR).
+* @details Computes the same windowed sinc low pass as SmpRateConvFIR, which
+* stays the reference implementation, but
+* 1) the filter is split into oversampling + 1 phases, each phase is a
+*    contiguous row of coefficients padded to the SIMD block size,
+* 2) the history is a double-length circular buffer, every input sample is
+*    written twice and the newest mul samples are always contiguous, no
+*    sample is shifted,
+* 3) each output is one vectorized dot product (AVX, SSE2, NEON or scalar),
+*    in float or double as selected by TCoef.
+*
+* @author Alexander Sacharov <a.sacharov@gmx.de>
+*
+* Project : Digital Signal Processing
+****************************************************************************/
+
+#ifndef INCLUDE_CPPSL_MATH_DSP_SRC_POLYPHASE_HPP
+#define INCLUDE_CPPSL_MATH_DSP_SRC_POLYPHASE_HPP
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <cppsl/math/constants.hpp>
+#include <cppsl/math/samplRateConv.hpp>
+#include <cppsl/math/details/dotProduct.hpp>
+#include <cppsl/math/details/firPrototype.hpp>
+
+//-----------------------------------------------------------------------------
+// global Function Prototypes
+//-----------------------------------------------------------------------------
+
+namespace cppsl::math {
+
+/// Polyphase sample rate converter with low pass FIR filter.
+/// The output signal has a delay depending on the length of the filter.
+/// @tparam T sample type
+/// @tparam TCoef coefficient and accumulator type, float or double
+
+template <typename T, typename TCoef = float>
+class SmpRateConvPolyphase : public SmpRateConvBase<SmpRateConvPolyphase<T, TCoef>, T> {
+  static_assert(std::is_same_v<TCoef, float> || std::is_same_v<TCoef, double>, "TCoef must be float or double");
+
+ public:
+  /**
+   * @brief Default constructor
+   */
+  SmpRateConvPolyphase() { Initialize(1, 1, 1, 2); }
+
+  /**
+   * @brief Initialization, the parameters are those of SmpRateConvFIR
+   * @param in_sampling_rate the input sample rate
+   * @param out_sample_rate the output sample rate
+   * @param oversampling the number of filter phases between two input samples
+   * @param mul the number of multiplications per output sample
+   */
+  SmpRateConvPolyphase(int in_sampling_rate, int out_sample_rate, int oversampling, unsigned char mul) {
+    Initialize(in_sampling_rate, out_sample_rate, oversampling, mul);
+  }
+
+  /**
+   * @brief Parameter initialization, builds the phase table
+   * @param in_sampling_rate input sample rate
+   * @param out_sample_rate output sample rate
+   * @param oversampling the number of filter phases between two input samples
+   * @param mul the number of multiplications per output sample
+   * @return true if successful, otherwise false
+   */
+  bool Initialize(int in_sampling_rate, int out_sample_rate, int oversampling, unsigned char mul) {
+    if ((mul & oversampling & 1) != 0 || oversampling <= 0 || mul == 0) {
+      return false;
+    }
+
+    m_oversampling = oversampling;
+    m_taps = (mul + details::dotBlock - 1) / details::dotBlock * details::dotBlock;
+    const auto prototype = details::FirPrototype(oversampling, mul);
+    const int length = static_cast<int>(prototype.size());
+
+    // phase p holds the taps p, p + oversampling, ... of the prototype
+    m_phases.assign(static_cast<size_t>(m_oversampling + 1) * m_taps, TCoef(0));
+    for (int p = 0; p <= m_oversampling; ++p) {
+      for (int i = 0, k = p; i < mul && k < length; ++i, k += m_oversampling) {
+        m_phases[p * m_taps + i] = static_cast<TCoef>(prototype[k]);
+      }
+    }
+
+    m_history.assign(2 * m_taps, TCoef(0));
+    m_newest = 0;
+    m_clock.Initialize(in_sampling_rate, out_sample_rate);
+    return true;
+  }
+
+  /**
+   * @brief Convert sampling rate
+   * @param in incoming samples
+   * @param out the output samples
+   * @return number of samples consumed from in and written to out
+   */
+  ConvertResult Convert(std::span<const T> in, std::span<T> out) { return this->ConvertClocked(m_clock, in, out); }
+
+  using SmpRateConvBase<SmpRateConvPolyphase<T, TCoef>, T>::Convert;
+
+  /**
+   * @brief Upper bound of the output samples for the next inputs
+   * @param n number of input samples
+   * @return maximal number of output samples
+   */
+  [[nodiscard]] size_t maxOutputFor(size_t n) const { return m_clock.MaxOutputFor(n); }
+
+ private:
+  friend class SmpRateConvBase<SmpRateConvPolyphase<T, TCoef>, T>;
+
+  /**
+   * @brief Writes a sample into both halves of the history
+   * @param sample the new sample
+   */
+  void Push(T sample) {
+    m_newest = (m_newest == 0 ? m_taps : m_newest) - 1;
+    m_history[m_newest] = m_history[m_newest + m_taps] = static_cast<TCoef>(sample);
+  }
+
+  /**
+   * @brief Computes the output sample at the current time with the nearest phase of the filter
+   * @return the output sample
+   */
+  T Compute() {
+    const int shift = (int)(0.5 + m_oversampling * m_clock.Fraction());
+    return this->Limit(details::Dot(&m_phases[shift * m_taps], &m_history[m_newest], m_taps));
+  }
+
+  int m_oversampling{1};                          ///< number of phases between two input samples
+  size_t m_taps{0};                               ///< coefficients per phase, padded to the SIMD block
+  std::vector<TCoef> m_phases;                    ///< (oversampling + 1) rows of m_taps coefficients
+  std::vector<TCoef> m_history;                   ///< double-length circular history
+  size_t m_newest{0};                             ///< index of the newest sample in the first half
+  typename SmpRateConvPolyphase::Clock m_clock;   ///< input and output time
+};
+
+}   // namespace cppsl::math
+
+#endif /* INCLUDE_CPPSL_MATH_DSP_SRC_POLYPHASE_HPP */
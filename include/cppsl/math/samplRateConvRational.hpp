@@ -0,0 +1,225 @@
+/************************************************************************//**
+* @file
+* @brief   Rational L/M Sampling Rate Converter with exact phase tracking.
+* @details The rates are reduced by their greatest common divisor to
+* L = out / gcd and M = in / gcd. Output j of a period of L outputs lies at
+* the input time j * M / L, so its filter phase (j * M) mod L and the number
+* of inputs it needs are integers, precomputed once per period in a
+* schedule. No floating point time is accumulated: the converter never
+* drifts and never needs a resync, however long the stream runs.
+* 1) the filter is the windowed sinc of SmpRateConvPolyphase with exactly
+*    L phases, so every output uses its exact coefficient row,
+* 2) the history is the double-length circular buffer of SmpRateConvPolyphase,
+* 3) while a whole period of input and output fits into the spans, the
+*    period is processed with the schedule only, without span checks.
+*
+* @author Alexander Sacharov <a.sacharov@gmx.de>
+*
+* Project : Digital Signal Processing
+****************************************************************************/
+
+#ifndef INCLUDE_CPPSL_MATH_DSP_SRC_RATIONAL_HPP
+#define INCLUDE_CPPSL_MATH_DSP_SRC_RATIONAL_HPP
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <cppsl/math/details/dotProduct.hpp>
+#include <cppsl/math/details/firPrototype.hpp>
+#include <cppsl/math/samplRateConv.hpp>
+
+//-----------------------------------------------------------------------------
+// global Function Prototypes
+//-----------------------------------------------------------------------------
+
+namespace cppsl::math {
+
+/// Rational polyphase sample rate converter with low pass FIR filter.
+/// The output signal has a delay depending on the length of the filter.
+/// @tparam T sample type
+/// @tparam TCoef coefficient and accumulator type, float or double
+
+template <typename T, typename TCoef = float>
+class SmpRateConvRational : public SmpRateConvBase<SmpRateConvRational<T, TCoef>, T> {
+  static_assert(std::is_same_v<TCoef, float> || std::is_same_v<TCoef, double>, "TCoef must be float or double");
+
+ public:
+  /// Largest number of phases L of the coefficient table
+  static constexpr int maxPhases = 4096;
+
+  /**
+   * @brief Default constructor
+   */
+  SmpRateConvRational() { Initialize(1, 1, 2); }
+
+  /**
+   * @brief Initialization
+   * @param in_sampling_rate the input sample rate
+   * @param out_sample_rate the output sample rate
+   * @param mul the number of multiplications per output sample
+   */
+  SmpRateConvRational(int in_sampling_rate, int out_sample_rate, unsigned char mul) {
+    Initialize(in_sampling_rate, out_sample_rate, mul);
+  }
+
+  /**
+   * @brief Parameter initialization, reduces the ratio and builds the phase table and schedule
+   * @param in_sampling_rate input sample rate
+   * @param out_sample_rate output sample rate
+   * @param mul the number of multiplications per output sample
+   * @return false if the rates are not positive, L exceeds maxPhases or L and mul are both odd
+   */
+  bool Initialize(int in_sampling_rate, int out_sample_rate, unsigned char mul) {
+    if (in_sampling_rate <= 0 || out_sample_rate <= 0 || mul == 0) {
+      return false;
+    }
+    const int g = std::gcd(in_sampling_rate, out_sample_rate);
+    const int L = out_sample_rate / g;
+    const int M = in_sampling_rate / g;
+    if (L > maxPhases || (L & mul & 1) != 0) {
+      return false;
+    }
+
+    m_L = static_cast<size_t>(L);
+    m_M = static_cast<size_t>(M);
+    m_taps = (mul + details::dotBlock - 1) / details::dotBlock * details::dotBlock;
+    const auto prototype = details::FirPrototype(L, mul);
+    const int length = static_cast<int>(prototype.size());
+
+    // phase p holds the taps p, p + L, ... of the prototype
+    m_phases.assign(m_L * m_taps, TCoef(0));
+    for (int p = 0; p < L; ++p) {
+      for (int i = 0, k = p; i < mul && k < length; ++i, k += L) {
+        m_phases[p * m_taps + i] = static_cast<TCoef>(prototype[k]);
+      }
+    }
+
+    // output j needs the inputs up to floor(j * M / L) of its period
+    m_schedule.resize(m_L);
+    for (size_t j = 0; j < m_L; ++j) {
+      const uint64_t t = static_cast<uint64_t>(j) * m_M;
+      m_schedule[j].m_need = static_cast<int64_t>(t / m_L) + 1;
+      m_schedule[j].m_row = static_cast<size_t>(t % m_L) * m_taps;
+    }
+
+    m_history.assign(2 * m_taps, TCoef(0));
+    m_newest = 0;
+    m_index = 0;
+    m_consumed = 0;
+    return true;
+  }
+
+  /**
+   * @brief Convert sampling rate
+   * @param in incoming samples
+   * @param out the output samples
+   * @return number of samples consumed from in and written to out
+   */
+  ConvertResult Convert(std::span<const T> in, std::span<T> out) {
+    ConvertResult res;
+    while (true) {
+      if (m_index == 0) {
+        // whole periods: the schedule alone drives the loop
+        while (in.size() - res.consumed >= m_M && out.size() - res.produced >= m_L) {
+          for (const auto& step : m_schedule) {
+            for (; m_consumed < step.m_need; ++m_consumed) {
+              Push(in[res.consumed++]);
+            }
+            out[res.produced++] = Compute(step.m_row);
+          }
+          m_consumed -= (int64_t)m_M;
+        }
+      }
+
+      const auto& step = m_schedule[m_index];
+      for (; m_consumed < step.m_need; ++m_consumed) {
+        if (res.consumed == in.size()) {
+          return res;
+        }
+        Push(in[res.consumed++]);
+      }
+      if (res.produced == out.size()) {
+        return res;
+      }
+      out[res.produced++] = Compute(step.m_row);
+      if (++m_index == m_L) {
+        m_index = 0;
+        m_consumed -= (int64_t)m_M;
+      }
+    }
+  }
+
+  using SmpRateConvBase<SmpRateConvRational<T, TCoef>, T>::Convert;
+
+  /**
+   * @brief Exact number of outputs due until n more inputs are consumed
+   * @param n number of input samples
+   * @return number of output samples
+   */
+  [[nodiscard]] size_t maxOutputFor(size_t n) const {
+    // output k is due once floor(k * M / L) < available inputs, k < available * L / M
+    const int64_t available = m_consumed + (int64_t)n;
+    if (available <= 0) {
+      return 0;
+    }
+    const uint64_t due = ((uint64_t)available * m_L + m_M - 1) / m_M;
+    return due > m_index ? static_cast<size_t>(due - m_index) : 0;
+  }
+
+  /**
+   * @brief Returns the reduced interpolation factor
+   * @return L, outputs per period
+   */
+  [[nodiscard]] size_t interpolation() const { return m_L; }
+
+  /**
+   * @brief Returns the reduced decimation factor
+   * @return M, inputs per period
+   */
+  [[nodiscard]] size_t decimation() const { return m_M; }
+
+ private:
+  /// Schedule entry of one output of the period
+  struct Step {
+    int64_t m_need{0};   ///< inputs of the period consumed before the output
+    size_t m_row{0};     ///< offset of the coefficient row
+  };
+
+  /**
+   * @brief Writes a sample into both halves of the history
+   * @param sample the new sample
+   */
+  void Push(T sample) {
+    m_newest = (m_newest == 0 ? m_taps : m_newest) - 1;
+    m_history[m_newest] = m_history[m_newest + m_taps] = static_cast<TCoef>(sample);
+  }
+
+  /**
+   * @brief Computes the output sample with the given coefficient row
+   * @param row offset of the coefficient row
+   * @return the output sample
+   */
+  T Compute(size_t row) const {
+    return SmpRateConvRational::Limit(details::Dot(&m_phases[row], &m_history[m_newest], m_taps));
+  }
+
+  size_t m_L{1};                  ///< outputs per period
+  size_t m_M{1};                  ///< inputs per period
+  size_t m_taps{0};               ///< coefficients per phase, padded to the SIMD block
+  std::vector<TCoef> m_phases;    ///< L rows of m_taps coefficients
+  std::vector<Step> m_schedule;   ///< the L outputs of a period
+  std::vector<TCoef> m_history;   ///< double-length circular history
+  size_t m_newest{0};             ///< index of the newest sample in the first half
+  size_t m_index{0};              ///< next output of the period
+  int64_t m_consumed{0};          ///< inputs consumed in the period, negative if the last one ended early
+};
+
+}   // namespace cppsl::math
+
+#endif /* INCLUDE_CPPSL_MATH_DSP_SRC_RATIONAL_HPP */
@@ -0,0 +1,231 @@
+/************************************************************************//**
+* @file
+* @brief   Streaming phasor engine, sliding DFT and Goertzel.
+* @details SlidingDft keeps the DFT bins of the fundamental and selected
+* harmonics over a window of whole cycles and updates them with every new
+* sample in O(1) per bin:
+*   S_k += (x_new - x_old) * exp(-j * 2 * pi * k * n / W)
+* The sum is referenced to the absolute sample index, so a signal on the
+* nominal frequency gives a stationary phasor. Unlike the rotating
+* recursion X_k = (X_k + x_new - x_old) * exp(j * 2 * pi * k / W), no
+* rounding error is multiplied into the state; the bins are additionally
+* rebuilt from the window once per window length, so long streams in
+* float stay exact without costing more than O(1) per sample.
+* The channels of a frame lie side by side, padded to the SIMD block, and
+* every bin update is one vectorized multiply-accumulate over all channels
+* (details::Axpy). The twiddle table is built at compile time.
+* goertzel() computes a single bin of a whole block.
+*
+* @author Alexander Sacharov <a.sacharov@gmx.de>
+*
+* Project : Digital Signal Processing
+****************************************************************************/
+
+#ifndef INCLUDE_CPPSL_MATH_DSP_SLIDING_DFT_HPP
+#define INCLUDE_CPPSL_MATH_DSP_SLIDING_DFT_HPP
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <cppsl/math/constants.hpp>
+#include <cppsl/math/details/dotProduct.hpp>
+#include <cppsl/math/details/twiddle.hpp>
+
+//-----------------------------------------------------------------------------
+// global Function Prototypes
+//-----------------------------------------------------------------------------
+
+namespace cppsl::math {
+
+/// Sliding DFT of the harmonics of several channels.
+/// @tparam SamplesPerCycle samples per cycle of the fundamental, e.g. 80 or 256
+/// @tparam Cycles window length in cycles
+/// @tparam TCoef state and twiddle type, float or double
+
+template <size_t SamplesPerCycle, size_t Cycles = 1, typename TCoef = double>
+class SlidingDft {
+  static_assert(std::is_same_v<TCoef, float> || std::is_same_v<TCoef, double>, "TCoef must be float or double");
+  static_assert(SamplesPerCycle > 0 && Cycles > 0, "the window must not be empty");
+
+ public:
+  /// Window length in samples
+  static constexpr size_t window = SamplesPerCycle * Cycles;
+
+  /**
+   * @brief Constructor
+   * @param harmonics the harmonic orders, 0 for DC, 1 for the fundamental
+   * @param channels the number of channels per frame
+   * @exception invalid_argument if a harmonic is not below the Nyquist frequency
+   */
+  explicit SlidingDft(std::vector<unsigned> harmonics, size_t channels = 1)
+      : m_harmonics(std::move(harmonics)), m_channels(std::max<size_t>(channels, 1)) {
+    for (const auto h : m_harmonics) {
+      if (2 * h * Cycles >= window && h != 0) {
+        throw std::invalid_argument("harmonic " + std::to_string(h) + " is not below the Nyquist frequency");
+      }
+    }
+    m_stride = (m_channels + details::dotBlock - 1) / details::dotBlock * details::dotBlock;
+    m_history.assign(window * m_stride, TCoef(0));
+    m_delta.assign(m_stride, TCoef(0));
+    m_bins.assign(2 * m_harmonics.size() * m_stride, TCoef(0));
+  }
+
+  /**
+   * @brief Adds one frame, the oldest frame leaves the window
+   * @param frame one sample per channel
+   * @exception invalid_argument if the frame holds fewer samples than channels
+   */
+  template <typename T>
+  void Update(std::span<const T> frame) {
+    if (frame.size() < m_channels) {
+      throw std::invalid_argument("frame of " + std::to_string(frame.size()) + " samples for " +
+                                  std::to_string(m_channels) + " channels");
+    }
+    TCoef* slot = &m_history[m_pos * m_stride];
+    for (size_t c = 0; c < m_channels; ++c) {
+      const TCoef value = static_cast<TCoef>(frame[c]);
+      m_delta[c] = value - slot[c];
+      slot[c] = value;
+    }
+
+    for (size_t b = 0; b < m_harmonics.size(); ++b) {
+      const size_t n = (m_harmonics[b] * Cycles * m_pos) % window;
+      details::Axpy(Real(b), static_cast<TCoef>(twiddles.cos[n]), m_delta.data(), m_stride);
+      details::Axpy(Imag(b), static_cast<TCoef>(-twiddles.sin[n]), m_delta.data(), m_stride);
+    }
+
+    m_count = std::min(m_count + 1, window);
+    if (++m_pos == window) {
+      m_pos = 0;
+      Rebuild();
+    }
+  }
+
+  /**
+   * @brief Adds one sample of a single channel converter
+   * @param sample the new sample
+   * @exception invalid_argument if the converter has more than one channel
+   */
+  template <typename T>
+  void Update(T sample)
+    requires std::is_arithmetic_v<T>
+  {
+    if (m_channels != 1) {
+      throw std::invalid_argument("single sample for " + std::to_string(m_channels) + " channels");
+    }
+    Update(std::span<const T>(&sample, 1));
+  }
+
+  /**
+   * @brief Returns the RMS phasor of a harmonic
+   * @details The angle refers to the absolute sample index 0 modulo the
+   * window, a cosine on the harmonic frequency starting at index 0 has angle 0.
+   * DC returns the mean value.
+   * @param index the index into the harmonics of the constructor
+   * @param channel the channel
+   * @return the phasor, valid once Ready()
+   */
+  [[nodiscard]] std::complex<double> Phasor(size_t index, size_t channel = 0) const {
+    const double scale = m_harmonics[index] == 0 ? 1.0 / window : DSP_SQRT2 / window;
+    return {scale * m_bins[(2 * index) * m_stride + channel], scale * m_bins[(2 * index + 1) * m_stride + channel]};
+  }
+
+  /**
+   * @brief Checks whether the window is filled
+   * @return true after window frames
+   */
+  [[nodiscard]] bool Ready() const { return m_count == window; }
+
+  /**
+   * @brief Returns the harmonic orders
+   * @return the harmonics of the constructor
+   */
+  [[nodiscard]] const std::vector<unsigned>& Harmonics() const { return m_harmonics; }
+
+  /**
+   * @brief Returns the number of channels
+   * @return channels per frame
+   */
+  [[nodiscard]] size_t Channels() const { return m_channels; }
+
+  /**
+   * @brief Clears the window and the bins
+   */
+  void Reset() {
+    std::fill(m_history.begin(), m_history.end(), TCoef(0));
+    std::fill(m_bins.begin(), m_bins.end(), TCoef(0));
+    m_pos = 0;
+    m_count = 0;
+  }
+
+ private:
+  static constexpr details::Twiddles<window> twiddles = details::MakeTwiddles<window>();
+
+  TCoef* Real(size_t b) { return &m_bins[(2 * b) * m_stride]; }
+  TCoef* Imag(size_t b) { return &m_bins[(2 * b + 1) * m_stride]; }
+
+  /**
+   * @brief Recomputes all bins from the window, slot s holds the sample of index s modulo window
+   */
+  void Rebuild() {
+    std::fill(m_bins.begin(), m_bins.end(), TCoef(0));
+    for (size_t b = 0; b < m_harmonics.size(); ++b) {
+      const size_t k = m_harmonics[b] * Cycles;
+      for (size_t s = 0; s < window; ++s) {
+        const size_t n = (k * s) % window;
+        const TCoef* row = &m_history[s * m_stride];
+        details::Axpy(Real(b), static_cast<TCoef>(twiddles.cos[n]), row, m_stride);
+        details::Axpy(Imag(b), static_cast<TCoef>(-twiddles.sin[n]), row, m_stride);
+      }
+    }
+  }
+
+  std::vector<unsigned> m_harmonics;   ///< harmonic orders of the bins
+  size_t m_channels{1};                ///< channels per frame
+  size_t m_stride{0};                  ///< row length, channels padded to the SIMD block
+  std::vector<TCoef> m_history;        ///< window of frame rows
+  std::vector<TCoef> m_delta;          ///< new minus leaving frame
+  std::vector<TCoef> m_bins;           ///< real and imaginary row per harmonic
+  size_t m_pos{0};                     ///< slot of the next frame, index modulo window
+  size_t m_count{0};                   ///< frames in the window
+};
+
+/**
+ * @brief Goertzel algorithm, one DFT bin of a block
+ * @param data the block
+ * @param k the bin, may be fractional
+ * @return sum of data[n] * exp(-j * 2 * pi * k * n / size)
+ */
+template <typename NumericType>
+inline std::complex<double> goertzel(std::span<const NumericType> data, double k) {
+  const size_t n = data.size();
+  if (n == 0) {
+    return {};
+  }
+  const double w = DSP_2PI * k / (double)n;
+  const double coeff = 2.0 * std::cos(w);
+  double s1 = 0.0;
+  double s2 = 0.0;
+  for (const auto& x : data) {
+    const double s0 = (double)x + coeff * s1 - s2;
+    s2 = s1;
+    s1 = s0;
+  }
+  // y[N-1] = s1 - exp(-jw) * s2, shifted to the block start
+  const std::complex<double> y = std::complex<double>(s1, 0.0) - std::polar(1.0, -w) * s2;
+  return y * std::polar(1.0, -w * (double)(n - 1));
+}
+
+}   // namespace cppsl::math
+
+#endif /* INCLUDE_CPPSL_MATH_DSP_SLIDING_DFT_HPP */
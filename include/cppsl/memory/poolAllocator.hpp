@@ -0,0 +1,157 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * @brief   standard allocator on top of the fixed-size block pools.
+ * @ingroup Memory
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include <cppsl/memory/poolFixed.hpp>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::memory {
+
+namespace details {
+
+inline constexpr size_t minPooledSize = 16;     ///< smallest size class
+inline constexpr size_t maxPooledSize = 4096;   ///< larger requests go to the heap
+inline constexpr size_t sizeClassCount = std::bit_width(maxPooledSize / minPooledSize);
+
+/**
+ * @brief Maps a request size to the index of the smallest size class holding it.
+ * @param bytes The request size, at most maxPooledSize.
+ * @return The size class index, the class has minPooledSize << index bytes.
+ */
+constexpr size_t sizeClass(size_t bytes) noexcept {
+  return std::bit_width(std::max(bytes, minPooledSize) - 1) - std::bit_width(minPooledSize - 1);
+}
+
+template <size_t... I>
+void* allocateClass(size_t index, std::index_sequence<I...>) {
+  static constexpr std::array<void* (*)(), sizeof...(I)> table{&PoolFixed<(minPooledSize << I)>::allocate...};
+  return table[index]();
+}
+
+template <size_t... I>
+void deallocateClass(size_t index, void* block, std::index_sequence<I...>) noexcept {
+  static constexpr std::array<void (*)(void*) noexcept, sizeof...(I)> table{
+      &PoolFixed<(minPooledSize << I)>::deallocate...};
+  table[index](block);
+}
+
+}   // namespace details
+
+/**
+ * @brief Takes a block of at least bytes bytes from the pool of its size class.
+ * @param bytes The request size, at most details::maxPooledSize.
+ * @return The block.
+ */
+inline void* poolAllocate(size_t bytes) {
+  return details::allocateClass(details::sizeClass(bytes), std::make_index_sequence<details::sizeClassCount>{});
+}
+
+/**
+ * @brief Returns a block obtained from poolAllocate().
+ * @param block The block.
+ * @param bytes The size passed to poolAllocate().
+ */
+inline void poolDeallocate(void* block, size_t bytes) noexcept {
+  details::deallocateClass(details::sizeClass(bytes), block, std::make_index_sequence<details::sizeClassCount>{});
+}
+
+/**
+ * @brief Pre-grows the pool of the size class holding bytes.
+ * @param bytes The request size, at most details::maxPooledSize.
+ * @param count The number of blocks to keep free.
+ */
+inline void poolReserve(size_t bytes, size_t count) {
+  [&]<size_t... I>(std::index_sequence<I...>) {
+    const auto index = details::sizeClass(bytes);
+    ((I == index ? PoolFixed<(details::minPooledSize << I)>::reserve(count) : void()), ...);
+  }(std::make_index_sequence<details::sizeClassCount>{});
+}
+
+/**
+ * @class PoolAllocator
+ * @brief Stateless allocator serving requests up to 4 KiB from the PoolFixed size classes.
+ *
+ * Requests are rounded up to the next power of 2 of at least 16 bytes. Larger or
+ * over-aligned requests go to std::allocator. Usable as TAlloc of DequeSafe, ListSafe
+ * and QueueLockFree, which rebind it to their node types.
+ *
+ * @tparam T The value type.
+ */
+template <typename T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  PoolAllocator() noexcept = default;
+
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+  /**
+   * @brief Allocates storage for n objects.
+   * @param n The number of objects.
+   * @return The storage.
+   */
+  [[nodiscard]] T* allocate(size_t n) {
+    if (!pooled(n)) {
+      return std::allocator<T>().allocate(n);
+    }
+    return static_cast<T*>(poolAllocate(n * sizeof(T)));
+  }
+
+  /**
+   * @brief Frees storage obtained from allocate().
+   * @param p The storage.
+   * @param n The number of objects passed to allocate().
+   */
+  void deallocate(T* p, size_t n) noexcept {
+    if (!pooled(n)) {
+      std::allocator<T>().deallocate(p, n);
+      return;
+    }
+    poolDeallocate(p, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U>&) const noexcept {
+    return true;
+  }
+
+ private:
+  /**
+   * @brief Checks whether a request is served by the pools.
+   * @param n The number of objects.
+   * @return true if pooled, false if forwarded to std::allocator.
+   */
+  static constexpr bool pooled(size_t n) noexcept {
+    return alignof(T) <= alignof(std::max_align_t) && n <= details::maxPooledSize / sizeof(T);
+  }
+};
+
+}   // namespace cppsl::memory
@@ -0,0 +1,254 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * @brief   fixed-size block pool with per-thread caches.
+ * @ingroup Memory
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::memory {
+
+/**
+ * @class PoolFixed
+ * @brief Process wide pool of blocks of one size.
+ *
+ * Blocks are carved from chunks taken from the global heap and are never given back to
+ * it, so once the pool has grown to the working set allocate() and deallocate() do not
+ * call malloc. Every thread keeps a free list of its own and exchanges blocks with the
+ * shared free list in batches under a mutex. Blocks freed by another thread than the
+ * one which allocated them simply move into the cache of the freeing thread.
+ *
+ * @tparam BlockSize The block size in bytes, a power of 2 not less than sizeof(void*).
+ */
+template <size_t BlockSize>
+class PoolFixed {
+  static_assert(BlockSize >= sizeof(void*) && (BlockSize & (BlockSize - 1)) == 0,
+                "BlockSize must be a power of 2 and hold a pointer");
+
+  static constexpr size_t blocksPerChunk = std::max<size_t>(16, 16384 / BlockSize);
+  static constexpr size_t batchSize = 32;               ///< blocks moved between a cache and the shared list at once
+  static constexpr size_t cacheLimit = 2 * batchSize;   ///< a cache holding more returns one batch
+
+  struct freeBlock {
+    freeBlock* m_next;
+  };
+
+  /**
+   * @brief The shared free list.
+   */
+  struct central {
+    std::mutex m_mutex;
+    freeBlock* m_free{nullptr};
+    size_t m_freeCount{0};
+    size_t m_reserved{0};   ///< blocks carved from chunks so far
+  };
+
+  /**
+   * @brief The free list of a thread. Trivially destructible, so it stays usable while
+   * other thread-local objects are destroyed; the flusher empties it on thread exit.
+   */
+  struct cache {
+    freeBlock* m_free;
+    size_t m_count;
+    bool m_closed;
+  };
+
+  struct cacheFlusher {
+    ~cacheFlusher() {
+      flush(t_cache.m_count);
+      t_cache.m_closed = true;
+    }
+  };
+
+  static inline thread_local cache t_cache{nullptr, 0, false};
+
+ public:
+  static constexpr size_t blockSize = BlockSize;
+
+  /**
+   * @brief Takes a block from the pool.
+   * @return The block, aligned to min(BlockSize, alignof(std::max_align_t)).
+   * @throws std::bad_alloc if the pool has to grow and the heap is exhausted.
+   */
+  static void* allocate() {
+    auto& c = local();
+    if (c.m_closed) {
+      // thread is exiting, bypass the cache
+      auto& s = shared();
+      std::lock_guard<std::mutex> lk(s.m_mutex);
+      size_t taken;
+      return take(s, 1, taken);
+    }
+    if (!c.m_free) {
+      refill();
+    }
+    auto* block = c.m_free;
+    c.m_free = block->m_next;
+    --c.m_count;
+    return block;
+  }
+
+  /**
+   * @brief Returns a block to the pool.
+   * @param block A block obtained from allocate().
+   */
+  static void deallocate(void* block) noexcept {
+    auto* b = static_cast<freeBlock*>(block);
+    auto& c = local();
+    if (c.m_closed) {
+      auto& s = shared();
+      std::lock_guard<std::mutex> lk(s.m_mutex);
+      b->m_next = s.m_free;
+      s.m_free = b;
+      ++s.m_freeCount;
+      return;
+    }
+    b->m_next = c.m_free;
+    c.m_free = b;
+    if (++c.m_count > cacheLimit) {
+      flush(batchSize);
+    }
+  }
+
+  /**
+   * @brief Grows the pool until at least count blocks are free in the shared list.
+   * Call it at startup to avoid heap allocations later.
+   * @param count The number of blocks.
+   * @throws std::bad_alloc if the heap is exhausted.
+   */
+  static void reserve(size_t count) {
+    auto& s = shared();
+    std::lock_guard<std::mutex> lk(s.m_mutex);
+    while (s.m_freeCount < count) {
+      grow(s);
+    }
+  }
+
+  /**
+   * @brief Returns the number of blocks the pool has taken from the heap so far.
+   * @return The number of blocks, free or in use.
+   */
+  static size_t reserved() {
+    auto& s = shared();
+    std::lock_guard<std::mutex> lk(s.m_mutex);
+    return s.m_reserved;
+  }
+
+ private:
+  /**
+   * @brief The shared free list. Intentionally never destroyed, threads may return blocks
+   * during static destruction.
+   * @return The shared free list.
+   */
+  static central& shared() {
+    static central* instance = new central;
+    return *instance;
+  }
+
+  /**
+   * @brief Carves a new chunk into free blocks. Caller holds the mutex.
+   * @param s The shared free list.
+   */
+  static void grow(central& s) {
+    auto* chunk = static_cast<std::byte*>(::operator new(blocksPerChunk * BlockSize));
+    for (size_t i = 0; i < blocksPerChunk; ++i) {
+      auto* b = reinterpret_cast<freeBlock*>(chunk + i * BlockSize);
+      b->m_next = s.m_free;
+      s.m_free = b;
+    }
+    s.m_freeCount += blocksPerChunk;
+    s.m_reserved += blocksPerChunk;
+  }
+
+  /**
+   * @brief Detaches up to count blocks from the shared list, growing it if it is empty. Caller holds the mutex.
+   * @param s The shared free list.
+   * @param count The number of blocks wanted.
+   * @param taken Receives the number of blocks detached.
+   * @return A chain of at least one block.
+   */
+  static freeBlock* take(central& s, size_t count, size_t& taken) {
+    if (!s.m_free) {
+      grow(s);
+    }
+    auto* first = s.m_free;
+    auto* last = first;
+    taken = 1;
+    for (; taken < count && last->m_next; ++taken) {
+      last = last->m_next;
+    }
+    s.m_free = last->m_next;
+    s.m_freeCount -= taken;
+    last->m_next = nullptr;
+    return first;
+  }
+
+  /**
+   * @brief Returns the cache of the calling thread and makes sure it is flushed on thread exit.
+   * @return The cache.
+   */
+  static cache& local() noexcept {
+    static thread_local cacheFlusher flusher;
+    (void)flusher;
+    return t_cache;
+  }
+
+  /**
+   * @brief Fills the cache of the calling thread with one batch.
+   */
+  static void refill() {
+    auto& s = shared();
+    size_t taken;
+    std::lock_guard<std::mutex> lk(s.m_mutex);
+    t_cache.m_free = take(s, batchSize, taken);
+    t_cache.m_count = taken;
+  }
+
+  /**
+   * @brief Moves up to count blocks from the cache of the calling thread to the shared list.
+   * @param count The number of blocks.
+   */
+  static void flush(size_t count) noexcept {
+    auto& c = t_cache;
+    if (count == 0 || !c.m_free) {
+      return;
+    }
+    auto* first = c.m_free;
+    auto* last = first;
+    size_t n = 1;
+    for (; n < count && last->m_next; ++n) {
+      last = last->m_next;
+    }
+    c.m_free = last->m_next;
+    c.m_count -= n;
+
+    auto& s = shared();
+    std::lock_guard<std::mutex> lk(s.m_mutex);
+    last->m_next = s.m_free;
+    s.m_free = first;
+    s.m_freeCount += n;
+  }
+};
+
+}   // namespace cppsl::memory
@@ -0,0 +1,139 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * @brief   spin-then-park waiting on an arbitrary condition.
+ * @ingroup Thread
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <stop_token>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::thread::details {
+
+/// Number of condition checks before a waiter parks.
+inline constexpr unsigned spinCount = 64;
+
+/**
+ * @brief Hints the CPU that the caller is busy waiting.
+ */
+inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield");
+#endif
+}
+
+/**
+ * @class EventCount
+ * @brief Parks threads until a condition, kept elsewhere, becomes true.
+ *
+ * Waiters spin for a short while and then park on an epoch counter with std::atomic::wait.
+ * Notifiers bump the epoch only if somebody is parked, so a notification without waiters
+ * costs a single load and no system call. A stop request wakes the parked waiters of its
+ * stop_token.
+ *
+ * Notifiers must change the condition with a seq_cst operation, or follow the change by a
+ * seq_cst fence, before they call notify_one() or notify_all(). Otherwise a waiter that has
+ * just parked could miss the change.
+ */
+class EventCount {
+  std::atomic<uint32_t> m_epoch{0};     ///< parking word, bumped by every notification with waiters
+  std::atomic<uint32_t> m_waiters{0};   ///< parked or parking threads
+
+  /**
+   * @brief Stop callback waking all parked threads.
+   */
+  struct wake {
+    EventCount* m_self;
+    void operator()() noexcept { m_self->bump_and_notify_all(); }
+  };
+
+ public:
+  /**
+   * @brief Wakes one parked thread, if any.
+   */
+  void notify_one() noexcept {
+    if (m_waiters.load() != 0) {
+      m_epoch.fetch_add(1);
+      m_epoch.notify_one();
+    }
+  }
+
+  /**
+   * @brief Wakes all parked threads, if any, with one call.
+   */
+  void notify_all() noexcept {
+    if (m_waiters.load() != 0) {
+      bump_and_notify_all();
+    }
+  }
+
+  /**
+   * @brief Waits until the predicate is true or a stop is requested.
+   * @param pred The condition, checked before parking and after every wakeup.
+   * @param stoken The stop token interrupting the wait.
+   * @return true if the predicate became true, false if a stop was requested.
+   */
+  template <typename Predicate>
+  bool wait(Predicate pred, std::stop_token stoken = {}) {
+    for (unsigned i = 0; i < spinCount; ++i) {
+      if (pred()) {
+        return true;
+      }
+      if (stoken.stop_requested()) {
+        return false;
+      }
+      cpuRelax();
+    }
+
+    m_waiters.fetch_add(1);
+    std::optional<std::stop_callback<wake>> onStop;
+    if (stoken.stop_possible()) {
+      onStop.emplace(stoken, wake{this});
+    }
+    bool res;
+    for (;;) {
+      // read the epoch before checking, a notification in between changes it and wait() returns
+      const auto epoch = m_epoch.load();
+      if (pred()) {
+        res = true;
+        break;
+      }
+      if (stoken.stop_requested()) {
+        res = false;
+        break;
+      }
+      m_epoch.wait(epoch);
+    }
+    m_waiters.fetch_sub(1);
+    return res;
+  }
+
+ private:
+  void bump_and_notify_all() noexcept {
+    m_epoch.fetch_add(1);
+    m_epoch.notify_all();
+  }
+};
+
+}   // namespace cppsl::thread::details
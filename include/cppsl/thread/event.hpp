@@ -0,0 +1,101 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * @brief   manual reset event without mutex.
+ * @ingroup Thread
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <stop_token>
+#include <utility>
+
+#include <cppsl/thread/details/eventCount.hpp>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::thread {
+
+/**
+ * @class Event
+ * @brief A manual reset event built on std::atomic::wait.
+ *
+ * set() releases every current and future waiter until reset() is called. A group of
+ * workers sharing one Event is woken with a single set(). Setting an event nobody waits
+ * for costs one atomic exchange and no system call.
+ */
+class Event {
+  std::atomic<bool> m_set;        ///< the event state
+  details::EventCount m_parked;   ///< the waiting threads
+
+ public:
+  /**
+   * @brief Constructor.
+   * @param set The initial state.
+   */
+  explicit Event(bool set = false) noexcept : m_set(set) {}
+
+  Event(const Event&) = delete;
+  Event& operator=(const Event&) = delete;
+
+  /**
+   * @brief Sets the event and wakes all waiters.
+   */
+  void set() noexcept {
+    if (!m_set.exchange(true)) {
+      m_parked.notify_all();
+    }
+  }
+
+  /**
+   * @brief Resets the event, following waits block again.
+   */
+  void reset() noexcept { m_set.store(false); }
+
+  /**
+   * @brief Returns the state of the event.
+   * @return true if the event is set, false otherwise.
+   */
+  [[nodiscard]] bool is_set() const noexcept { return m_set.load(); }
+
+  /**
+   * @brief Waits until the event is set or a stop is requested.
+   * @param stoken The stop token interrupting the wait.
+   * @return true if the event is set, false if a stop was requested.
+   */
+  bool wait(std::stop_token stoken = {}) {
+    return m_parked.wait([this] { return m_set.load(); }, std::move(stoken));
+  }
+
+  /**
+   * @brief Waits until the event is set and resets it.
+   *
+   * With several waiters all of them may return, the event works as a wakeup of one worker.
+   *
+   * @param stoken The stop token interrupting the wait.
+   * @return true if the event was set, false if a stop was requested.
+   */
+  bool wait_and_reset(std::stop_token stoken = {}) {
+    const bool res = wait(std::move(stoken));
+    if (res) {
+      reset();
+    }
+    return res;
+  }
+};
+
+}   // namespace cppsl::thread
@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * @brief   single use countdown latch with stop token support.
+ * @ingroup Thread
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <cstddef>
+#include <stop_token>
+#include <utility>
+
+#include <cppsl/thread/details/eventCount.hpp>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::thread {
+
+/**
+ * @class Latch
+ * @brief A single use countdown built on std::atomic::wait.
+ *
+ * Like std::latch, but waits can be interrupted by a std::stop_token. The final count_down()
+ * releases all waiters with one call.
+ */
+class Latch {
+  std::atomic<std::ptrdiff_t> m_count;   ///< outstanding arrivals
+  details::EventCount m_parked;          ///< the waiting threads
+
+ public:
+  /**
+   * @brief Constructor.
+   * @param expected The number of arrivals releasing the latch.
+   */
+  explicit Latch(std::ptrdiff_t expected) noexcept : m_count(expected) {}
+
+  Latch(const Latch&) = delete;
+  Latch& operator=(const Latch&) = delete;
+
+  /**
+   * @brief Decrements the counter, releases the waiters when it reaches zero.
+   * @param count The number of arrivals.
+   */
+  void count_down(std::ptrdiff_t count = 1) noexcept {
+    if (m_count.fetch_sub(count) == count) {
+      m_parked.notify_all();
+    }
+  }
+
+  /**
+   * @brief Checks whether the counter has reached zero.
+   * @return true if the latch is released, false otherwise.
+   */
+  [[nodiscard]] bool try_wait() const noexcept { return m_count.load() <= 0; }
+
+  /**
+   * @brief Waits until the counter reaches zero.
+   * @param stoken The stop token interrupting the wait.
+   * @return true if the latch is released, false if a stop was requested.
+   */
+  bool wait(std::stop_token stoken = {}) {
+    return m_parked.wait([this] { return try_wait(); }, std::move(stoken));
+  }
+
+  /**
+   * @brief Decrements the counter and waits until it reaches zero.
+   * @param count The number of arrivals.
+   * @param stoken The stop token interrupting the wait.
+   * @return true if the latch is released, false if a stop was requested.
+   */
+  bool arrive_and_wait(std::ptrdiff_t count = 1, std::stop_token stoken = {}) {
+    count_down(count);
+    return wait(std::move(stoken));
+  }
+};
+
+}   // namespace cppsl::thread
@@ -0,0 +1,98 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * @brief   counting semaphore with stop token support.
+ * @ingroup Thread
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <cstddef>
+#include <stop_token>
+#include <utility>
+
+#include <cppsl/thread/details/eventCount.hpp>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::thread {
+
+/**
+ * @class Semaphore
+ * @brief A counting semaphore built on std::atomic::wait.
+ *
+ * Unlike std::counting_semaphore an acquire can be interrupted by a std::stop_token. A release
+ * without parked threads costs one atomic add and no system call.
+ */
+class Semaphore {
+  std::atomic<std::ptrdiff_t> m_count;   ///< available permits
+  details::EventCount m_parked;          ///< the waiting threads
+
+ public:
+  /**
+   * @brief Constructor.
+   * @param initial The initial number of permits.
+   */
+  explicit Semaphore(std::ptrdiff_t initial = 0) noexcept : m_count(initial) {}
+
+  Semaphore(const Semaphore&) = delete;
+  Semaphore& operator=(const Semaphore&) = delete;
+
+  /**
+   * @brief Adds permits and wakes as many waiters.
+   * @param count The number of permits.
+   */
+  void release(std::ptrdiff_t count = 1) noexcept {
+    m_count.fetch_add(count);
+    if (count == 1) {
+      m_parked.notify_one();
+    } else {
+      m_parked.notify_all();
+    }
+  }
+
+  /**
+   * @brief Takes a permit if one is available.
+   * @return true if a permit was taken, false otherwise.
+   */
+  [[nodiscard]] bool try_acquire() noexcept {
+    auto count = m_count.load();
+    while (count > 0) {
+      if (m_count.compare_exchange_weak(count, count - 1)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Waits for a permit and takes it.
+   * @param stoken The stop token interrupting the wait.
+   * @return true if a permit was taken, false if a stop was requested.
+   */
+  bool acquire(std::stop_token stoken = {}) {
+    return m_parked.wait([this] { return try_acquire(); }, std::move(stoken));
+  }
+
+  /**
+   * @brief Returns the number of available permits.
+   * @return The number of permits.
+   */
+  [[nodiscard]] std::ptrdiff_t available() const noexcept { return m_count.load(); }
+};
+
+}   // namespace cppsl::thread
@@ -0,0 +1,203 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * @brief   work-stealing thread pool.
+ * @ingroup Thread
+ *****************************************************************************/
+
+#pragma once
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cppsl/container/dequeWorkStealing.hpp>
+#include <cppsl/container/queueLockFreeBounded.hpp>
+#include <cppsl/thread/details/eventCount.hpp>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::thread {
+
+/**
+ * @class WorkerPool
+ * @brief A fixed set of worker threads sharing work by stealing.
+ *
+ * Every worker owns a DequeWorkStealing. Tasks submitted from inside a task go to the
+ * deque of the current worker and are popped LIFO by it; idle workers steal FIFO from the
+ * others. Tasks submitted from outside the pool enter a bounded lock-free injection queue.
+ * Idle workers spin briefly and then park on a details::EventCount, so a submit only
+ * notifies when somebody is parked.
+ *
+ * Tasks must not throw, an escaping exception terminates the program.
+ */
+class WorkerPool {
+ public:
+  using Task = std::function<void()>;
+
+ private:
+  /**
+   * @brief Per worker state, one cache line apart from its neighbours.
+   */
+  struct alignas(container::details::cacheLineSize) worker {
+    container::DequeWorkStealing<Task*> m_deque;
+  };
+
+  std::vector<std::unique_ptr<worker>> m_workers;           ///< worker deques
+  container::QueueLockFreeBounded<Task*> m_injection;       ///< tasks submitted from outside
+  alignas(container::details::cacheLineSize) details::EventCount m_idle;   ///< parked workers
+  std::atomic<size_t> m_pending{0};                         ///< submitted and not yet finished tasks
+  std::atomic<bool> m_stop{false};                          ///< set by the destructor
+  std::vector<std::jthread> m_threads;                      ///< the worker threads
+
+  /// The pool and the worker index of the calling thread, if it is a worker.
+  static inline thread_local WorkerPool* t_pool = nullptr;
+  static inline thread_local size_t t_index = 0;
+
+ public:
+  /**
+   * @brief Constructor: starts the workers.
+   * @param threads The number of worker threads, 0 selects std::thread::hardware_concurrency().
+   * @param injectionCapacity The capacity of the queue for tasks submitted from outside the pool.
+   */
+  explicit WorkerPool(size_t threads = 0, size_t injectionCapacity = 1024) : m_injection(injectionCapacity) {
+    if (threads == 0) {
+      threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+      m_workers.push_back(std::make_unique<worker>());
+    }
+    m_threads.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+      m_threads.emplace_back([this, i] { run(i); });
+    }
+  }
+
+  /**
+   * @brief Destructor: runs the tasks still queued, then stops and joins the workers.
+   */
+  ~WorkerPool() {
+    wait_idle();
+    m_stop.store(true);
+    m_idle.notify_all();
+    m_threads.clear();
+  }
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  /**
+   * @brief Submits a task. From a worker it goes to the worker's own deque without locking,
+   * from any other thread to the injection queue; the call yields while that queue is full.
+   * @param task The task to be run.
+   */
+  void submit(Task task) {
+    auto* item = new Task(std::move(task));
+    m_pending.fetch_add(1, std::memory_order_relaxed);
+    if (t_pool == this) {
+      m_workers[t_index]->m_deque.push(item);
+    } else {
+      while (!m_injection.try_push(item)) {
+        std::this_thread::yield();
+      }
+    }
+    // order the publication before the waiter check of the event count
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    m_idle.notify_one();
+  }
+
+  /**
+   * @brief Blocks until all submitted tasks, including those they submit, have finished.
+   * Must not be called from a task.
+   */
+  void wait_idle() {
+    for (auto pending = m_pending.load(std::memory_order_acquire); pending != 0;
+         pending = m_pending.load(std::memory_order_acquire)) {
+      m_pending.wait(pending, std::memory_order_acquire);
+    }
+  }
+
+  /**
+   * @brief Returns the number of worker threads.
+   * @return The number of workers.
+   */
+  [[nodiscard]] size_t size() const noexcept { return m_workers.size(); }
+
+  /**
+   * @brief Returns the index of the calling worker.
+   * @return The worker index, or size() if the caller is not a worker of this pool.
+   */
+  [[nodiscard]] size_t current_index() const noexcept { return t_pool == this ? t_index : size(); }
+
+ private:
+  /**
+   * @brief The worker loop.
+   * @param index The index of the worker.
+   */
+  void run(size_t index) {
+    t_pool = this;
+    t_index = index;
+    Task* task = nullptr;
+    while (m_idle.wait([&] { return (task = find_task(index)) || m_stop.load(); })) {
+      if (!task) {
+        break;
+      }
+      execute(task);
+    }
+    t_pool = nullptr;
+  }
+
+  /**
+   * @brief Looks for work: the own deque first, then the injection queue, then the other workers.
+   * @param index The index of the calling worker.
+   * @return A task, or nullptr if none was found.
+   */
+  Task* find_task(size_t index) {
+    if (auto task = m_workers[index]->m_deque.pop()) {
+      return *task;
+    }
+    if (auto task = m_injection.try_pop()) {
+      return *task;
+    }
+    const auto count = m_workers.size();
+    for (size_t i = 1; i < count; ++i) {
+      if (auto task = m_workers[(index + i) % count]->m_deque.steal()) {
+        return *task;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Runs and deletes a task, wakes wait_idle() when it was the last one.
+   * @param task The task to be run.
+   */
+  void execute(Task* task) noexcept {
+    (*task)();
+    delete task;
+    if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      m_pending.notify_all();
+    }
+  }
+};
+
+}   // namespace cppsl::thread
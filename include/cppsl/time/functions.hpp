@@ -56,6 +56,16 @@
  *  ---- get_time
  *  ---- get_time
  *
+ *   toString and fromString are convenient but slow. Hot paths format into a
+ *   buffer of the caller and parse with the matching fast functions:
+ *
+ *   char buffer[timestampBufferSize];
+ *   auto end = formatTimestamp<6>(buffer, system_clock::now());
+ *   auto tp = parseTimestamp<system_clock::time_point>({buffer, end});
+ *
+ *   fmt::memory_buffer out;
+ *   appendTimestamp<3>(out, system_clock::now());
+ *
 ****************************************************************************/
 
 #ifndef INCLUDE_CPPSL_TIME_CHRONO_FUNC_HPP
@@ -65,6 +75,7 @@
 // includes
 //-----------------------------------------------------------------------------
 #include <cerrno>
+#include <charconv>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
@@ -72,9 +83,11 @@
 #include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 //----------------------------------------------------------------------------
 // Public Prototypes
@@ -130,6 +143,216 @@ namespace cppsl::time {
     return timePoint += hr_clock::duration(zeconds);
   }
 
+
+  /// largest output of formatTimestamp, "-2147481748-Jan-01 00:00:00.000000000" included
+  inline constexpr std::size_t timestampBufferSize = 40;
+
+  namespace details {
+
+  inline constexpr char digitPairs[] =
+     "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+     "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+     "8081828384858687888990919293949596979899";
+
+  inline constexpr char monthNames[12][4] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                             "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+  inline constexpr std::int64_t powersOf10[10] = {1,      10,      100,      1000,      10000,
+                                                  100000, 1000000, 10000000, 100000000, 1000000000};
+
+  inline char *writeTwoDigits(char *out, unsigned value) noexcept {
+    std::memcpy(out, &digitPairs[value * 2], 2);
+    return out + 2;
+  }
+
+  constexpr std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) noexcept {
+    return value / divisor - (value % divisor < 0 ? 1 : 0);
+  }
+
+  /// days since 1970-01-01 of a proleptic Gregorian date
+  constexpr std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day) noexcept {
+    year -= month <= 2 ? 1 : 0;
+    const std::int64_t era = floorDiv(year, 400);
+    const auto yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<std::int64_t>(dayOfEra) - 719468;
+  }
+
+  constexpr unsigned daysInMonth(std::int64_t year, unsigned month) noexcept {
+    if (month == 2)
+      return (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) ? 29 : 28;
+    return (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+  }
+
+  /// "YYYY-Mon-DD HH:MM:" of the last formatted minute of the thread
+  struct TimestampPrefix {
+    std::int64_t minute{INT64_MIN};
+    char text[timestampBufferSize];
+    std::size_t size{0};
+  };
+
+  /// offset of local time to UTC of the last parsed local minute of the thread
+  struct TimestampOffset {
+    std::int64_t localMinute{INT64_MIN};
+    std::int64_t offset{0};
+  };
+
+  /// parses 1 to maxDigits digits
+  inline bool parseNumber(std::string_view &str, unsigned maxDigits, std::int64_t &value) noexcept {
+    value = 0;
+    unsigned n = 0;
+    while (n < str.size() && n < maxDigits && str[n] >= '0' && str[n] <= '9')
+      value = value * 10 + (str[n++] - '0');
+    str.remove_prefix(n);
+    return n != 0;
+  }
+
+  inline bool parseChar(std::string_view &str, char c) noexcept {
+    if (str.empty() || str.front() != c)
+      return false;
+    str.remove_prefix(1);
+    return true;
+  }
+
+  }// namespace details
+
+  /**
+   * formats a time point as local time like toString, "2023-Jun-25 19:27:52.117357", into a buffer
+   * @remarks The date and minute are formatted by localtime_r once per minute and thread, the
+   * seconds and the fraction come from a digit table. The fraction is truncated, not rounded.
+   * Month names are those of the C locale. A change of TZ is seen from the next minute on.
+   * @tparam Digits number of fraction digits, 0 omits the decimal point
+   * @param out buffer of at least timestampBufferSize characters
+   * @param timePoint time point of a clock with the Unix epoch
+   * @return end of the written characters, no terminating zero
+   */
+  template<std::size_t Digits = 6, typename Clock, typename Duration>
+    requires(Digits <= 9)
+  inline char *formatTimestamp(char *out, const std::chrono::time_point<Clock, Duration> &timePoint) {
+    using namespace std::chrono;
+    const auto sinceEpoch = timePoint.time_since_epoch();
+    const auto secs = floor<seconds>(sinceEpoch);
+    [[maybe_unused]] const auto fraction =
+       static_cast<std::int64_t>(duration_cast<nanoseconds>(sinceEpoch - secs).count());
+    const std::int64_t minute = details::floorDiv(secs.count(), 60);
+
+    thread_local details::TimestampPrefix prefix;
+    if (prefix.minute != minute) {
+      const std::time_t tt{static_cast<std::time_t>(minute * 60)};
+      std::tm tm{};
+      if (!localtime_r(&tt, &tm))
+        throw std::runtime_error(std::strerror(errno));
+      char *p = std::to_chars(prefix.text, prefix.text + 12, tm.tm_year + 1900LL).ptr;
+      *p++ = '-';
+      std::memcpy(p, details::monthNames[tm.tm_mon], 3);
+      p += 3;
+      *p++ = '-';
+      p = details::writeTwoDigits(p, static_cast<unsigned>(tm.tm_mday));
+      *p++ = ' ';
+      p = details::writeTwoDigits(p, static_cast<unsigned>(tm.tm_hour));
+      *p++ = ':';
+      p = details::writeTwoDigits(p, static_cast<unsigned>(tm.tm_min));
+      *p++ = ':';
+      prefix.size = static_cast<std::size_t>(p - prefix.text);
+      prefix.minute = minute;
+    }
+
+    std::memcpy(out, prefix.text, prefix.size);
+    out = details::writeTwoDigits(out + prefix.size, static_cast<unsigned>(secs.count() - minute * 60));
+    if constexpr (Digits > 0) {
+      *out++ = '.';
+      auto value = fraction / details::powersOf10[9 - Digits];
+      for (std::size_t i = Digits; i > 0; --i) {
+        out[i - 1] = static_cast<char>('0' + value % 10);
+        value /= 10;
+      }
+      out += Digits;
+    }
+    return out;
+  }
+
+  /**
+   * appends a time point formatted by formatTimestamp
+   * @tparam Digits number of fraction digits
+   * @param buffer e.g. fmt::memory_buffer or std::string, needs append(const char*, const char*)
+   * @param timePoint time point of a clock with the Unix epoch
+   */
+  template<std::size_t Digits = 6, typename Buffer, typename Clock, typename Duration>
+  inline void appendTimestamp(Buffer &buffer, const std::chrono::time_point<Clock, Duration> &timePoint) {
+    char text[timestampBufferSize];
+    buffer.append(text, formatTimestamp<Digits>(text, timePoint));
+  }
+
+  /**
+   * parses a local time written by formatTimestamp or toString
+   * @remarks Accepts "YYYY-Mon-DD" and "YYYY-Mon-DD HH:MM:SS[.fraction]"; the month name is case
+   * insensitive, day, hour, minute and second take one or two digits, fraction digits beyond
+   * nanoseconds are ignored. The local time offset is taken from mktime once per minute and thread.
+   * @tparam TimePoint time point of a clock with the Unix epoch
+   * @param str the text
+   * @return the time point, or std::nullopt if the text is malformed or out of range
+   */
+  template<typename TimePoint>
+  std::optional<TimePoint> parseTimestamp(std::string_view str) noexcept {
+    using namespace std::chrono;
+    std::int64_t year, day, hour = 0, minute = 0, second = 0, fraction = 0;
+    unsigned month = 0;
+
+    if (!details::parseNumber(str, 9, year) || !details::parseChar(str, '-') || str.size() < 3)
+      return std::nullopt;
+    for (unsigned m = 0; m < 12 && month == 0; ++m) {
+      if (((str[0] | 0x20) == (details::monthNames[m][0] | 0x20)) && ((str[1] | 0x20) == details::monthNames[m][1]) &&
+          ((str[2] | 0x20) == details::monthNames[m][2]))
+        month = m + 1;
+    }
+    str.remove_prefix(3);
+    if (month == 0 || !details::parseChar(str, '-') || !details::parseNumber(str, 2, day) || day < 1 ||
+        day > details::daysInMonth(year, month))
+      return std::nullopt;
+
+    if (!str.empty()) {
+      if (!details::parseChar(str, ' ') || !details::parseNumber(str, 2, hour) || !details::parseChar(str, ':') ||
+          !details::parseNumber(str, 2, minute) || !details::parseChar(str, ':') ||
+          !details::parseNumber(str, 2, second) || hour > 23 || minute > 59 || second > 60)
+        return std::nullopt;
+      if (details::parseChar(str, '.')) {
+        const auto digits = str.size();
+        if (!details::parseNumber(str, 9, fraction))
+          return std::nullopt;
+        fraction *= details::powersOf10[9 - (digits - str.size())];
+        while (!str.empty() && str.front() >= '0' && str.front() <= '9')
+          str.remove_prefix(1);
+      }
+      if (!str.empty())
+        return std::nullopt;
+    }
+
+    const std::int64_t local = details::daysFromCivil(year, month, static_cast<unsigned>(day)) * 86400 +
+                               hour * 3600 + minute * 60 + second;
+    thread_local details::TimestampOffset cache;
+    const std::int64_t localMinute = details::floorDiv(local, 60);
+    if (cache.localMinute != localMinute) {
+      std::tm tm{};
+      tm.tm_year = static_cast<int>(year - 1900);
+      tm.tm_mon = static_cast<int>(month - 1);
+      tm.tm_mday = static_cast<int>(day);
+      tm.tm_hour = static_cast<int>(hour);
+      tm.tm_min = static_cast<int>(minute);
+      tm.tm_isdst = -1;
+      errno = 0;
+      const std::time_t tt = std::mktime(&tm);
+      if (tt == -1 && errno != 0)
+        return std::nullopt;
+      cache.offset = localMinute * 60 - static_cast<std::int64_t>(tt);
+      cache.localMinute = localMinute;
+    }
+
+    using Duration = typename TimePoint::duration;
+    return TimePoint{duration_cast<Duration>(seconds(local - cache.offset)) +
+                     duration_cast<Duration>(nanoseconds(fraction))};
+  }
+
 }// namespace cppsl::chrono::func
 
 #endif /* INCLUDE_CPPSL_TIME_CHRONO_FUNC_HPP */
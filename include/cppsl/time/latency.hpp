@@ -0,0 +1,437 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/************************************************************************/ /**
+ * @file
+ * @brief latency histograms with fixed memory for instrumentation left on in
+ * production.
+ *
+ * LatencyHistogram counts nanoseconds in log-linear buckets: every power of two
+ * is split into 32 linear sub-buckets, so a reported value is at most about 3%
+ * above the recorded one, from 1 ns up to 2^64 ns, in 15 KiB.
+ *
+ * LatencyRecorder gives every recording thread its own histogram, written
+ * without atomic read-modify-write and merged by Snapshot(). ScopedLatency
+ * records the lifetime of a scope, read from steady_clock or from the cycle
+ * counter of the CPU (TSC on x86, CNTVCT_EL0 on AArch64).
+ *
+ ****************************************************************************/
+
+#ifndef INCLUDE_CPPSL_TIME_LATENCY_HPP
+#define INCLUDE_CPPSL_TIME_LATENCY_HPP
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::time {
+
+/**
+ * @brief clock source reading steady_clock, the counter is in nanoseconds
+ */
+struct SteadyClockSource {
+  [[nodiscard]] static uint64_t Now() noexcept {
+    return static_cast<uint64_t>(
+       std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+  }
+
+  [[nodiscard]] static uint64_t ToNanoseconds(uint64_t ticks) noexcept { return ticks; }
+};
+
+/**
+ * @brief clock source reading the cycle counter of the CPU without a system call
+ * @remarks x86 needs an invariant TSC, its rate is calibrated against steady_clock
+ * once, see Calibrate(). AArch64 reads the rate from CNTFRQ_EL0. Other CPUs fall
+ * back to steady_clock.
+ */
+struct CycleClockSource {
+  [[nodiscard]] static uint64_t Now() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return SteadyClockSource::Now();
+#endif
+  }
+
+  [[nodiscard]] static uint64_t ToNanoseconds(uint64_t ticks) noexcept {
+    return static_cast<uint64_t>(static_cast<double>(ticks) * Calibrate());
+  }
+
+  /**
+   * @brief get the nanoseconds per tick, measured on the first call
+   * @remarks The first call on x86 spins for about 10 ms; call it at start up to keep
+   * this out of the first measurement.
+   */
+  static double Calibrate() noexcept {
+    static const double nsPerTick = Measure();
+    return nsPerTick;
+  }
+
+ private:
+  static double Measure() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    const auto startNs = SteadyClockSource::Now();
+    const auto startTicks = Now();
+    uint64_t ns;
+    do {
+      ns = SteadyClockSource::Now() - startNs;
+    } while (ns < 10'000'000);
+    const auto ticks = Now() - startTicks;
+    return ticks != 0 ? static_cast<double>(ns) / static_cast<double>(ticks) : 1.0;
+#elif defined(__aarch64__)
+    uint64_t frequency;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+    return frequency != 0 ? 1e9 / static_cast<double>(frequency) : 1.0;
+#else
+    return 1.0;
+#endif
+  }
+};
+
+/**
+ * @brief percentiles exported by a snapshot, in nanoseconds
+ */
+struct LatencySummary {
+  uint64_t count{0};
+  uint64_t min{0};
+  uint64_t p50{0};
+  uint64_t p99{0};
+  uint64_t p999{0};
+  uint64_t max{0};
+  double mean{0.0};
+
+  /**
+   * @brief formats the summary
+   * @return e.g. "count=10 min=12ns p50=20ns p99=95ns p999=95ns max=96ns mean=27.5ns"
+   */
+  [[nodiscard]] std::string ToString() const {
+    return "count=" + std::to_string(count) + " min=" + std::to_string(min) + "ns p50=" + std::to_string(p50) +
+           "ns p99=" + std::to_string(p99) + "ns p999=" + std::to_string(p999) + "ns max=" + std::to_string(max) +
+           "ns mean=" + std::to_string(mean) + "ns";
+  }
+};
+
+/**
+ * @brief log-linear histogram of nanoseconds
+ * @remarks Record() may be called by one thread while others read; the counters are
+ * atomics written with plain load and store.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr unsigned subBucketBits = 5;                                  ///< sub-buckets per power of two 2^subBucketBits
+  static constexpr uint64_t subBuckets = uint64_t{1} << subBucketBits;
+  static constexpr size_t bucketCount = (65 - subBucketBits) * subBuckets;      ///< covers all uint64_t values
+
+  LatencyHistogram() = default;
+  LatencyHistogram(const LatencyHistogram& other) { Merge(other); }
+  LatencyHistogram& operator=(const LatencyHistogram& other) {
+    if (this != &other) {
+      Reset();
+      Merge(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief get the bucket of a value
+   */
+  [[nodiscard]] static constexpr size_t IndexOf(uint64_t value) noexcept {
+    if (value < subBuckets) {
+      return static_cast<size_t>(value);
+    }
+    const auto msb = static_cast<unsigned>(63 - __builtin_clzll(value));
+    const auto shift = msb - subBucketBits;
+    return static_cast<size_t>(((shift + 1) << subBucketBits) + ((value >> shift) - subBuckets));
+  }
+
+  /**
+   * @brief get the highest value counted by a bucket
+   */
+  [[nodiscard]] static constexpr uint64_t ValueOf(size_t index) noexcept {
+    if (index < subBuckets) {
+      return index;
+    }
+    const auto shift = static_cast<unsigned>(index >> subBucketBits) - 1;
+    const auto lowest = (subBuckets + (index & (subBuckets - 1))) << shift;
+    return lowest + ((uint64_t{1} << shift) - 1);
+  }
+
+  /**
+   * @brief counts a value, single writer
+   * @param ns the value in nanoseconds
+   */
+  void Record(uint64_t ns) noexcept {
+    Bump(m_counts[IndexOf(ns)], 1);
+    Bump(m_count, 1);
+    Bump(m_sum, ns);
+    if (ns > m_max.load(std::memory_order_relaxed)) {
+      m_max.store(ns, std::memory_order_relaxed);
+    }
+    if (ns < m_min.load(std::memory_order_relaxed)) {
+      m_min.store(ns, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief adds the counts of another histogram, single writer
+   */
+  void Merge(const LatencyHistogram& other) noexcept {
+    if (other.Count() == 0) {
+      return;
+    }
+    for (size_t i = 0; i < bucketCount; ++i) {
+      if (const auto n = other.m_counts[i].load(std::memory_order_relaxed)) {
+        Bump(m_counts[i], n);
+      }
+    }
+    Bump(m_count, other.m_count.load(std::memory_order_relaxed));
+    Bump(m_sum, other.m_sum.load(std::memory_order_relaxed));
+    m_max.store(std::max(Max(), other.Max()), std::memory_order_relaxed);
+    m_min.store(std::min(m_min.load(std::memory_order_relaxed), other.m_min.load(std::memory_order_relaxed)),
+                std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief clears all counts, single writer
+   */
+  void Reset() noexcept {
+    for (auto& c : m_counts) {
+      c.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] uint64_t Count() const noexcept { return m_count.load(std::memory_order_relaxed); }
+  [[nodiscard]] uint64_t Max() const noexcept { return m_max.load(std::memory_order_relaxed); }
+  [[nodiscard]] uint64_t Min() const noexcept { return Count() != 0 ? m_min.load(std::memory_order_relaxed) : 0; }
+
+  /**
+   * @brief get a percentile
+   * @param percentile in [0, 100]
+   * @return the highest value of the bucket holding the percentile, at most Max()
+   */
+  [[nodiscard]] uint64_t Percentile(double percentile) const noexcept {
+    const auto count = Count();
+    if (count == 0) {
+      return 0;
+    }
+    const auto rank = std::max<uint64_t>(
+       1, static_cast<uint64_t>(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(count) + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < bucketCount; ++i) {
+      seen += m_counts[i].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        return std::min(ValueOf(i), Max());
+      }
+    }
+    return Max();
+  }
+
+  /**
+   * @brief get count, min, p50, p99, p99.9, max and mean
+   */
+  [[nodiscard]] LatencySummary Summary() const noexcept {
+    LatencySummary summary;
+    summary.count = Count();
+    if (summary.count != 0) {
+      summary.min = Min();
+      summary.p50 = Percentile(50.0);
+      summary.p99 = Percentile(99.0);
+      summary.p999 = Percentile(99.9);
+      summary.max = Max();
+      summary.mean =
+         static_cast<double>(m_sum.load(std::memory_order_relaxed)) / static_cast<double>(summary.count);
+    }
+    return summary;
+  }
+
+ private:
+  /// increment of a single writer, no atomic read-modify-write
+  static void Bump(std::atomic<uint64_t>& counter, uint64_t n) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  std::array<std::atomic<uint64_t>, bucketCount> m_counts{};               ///< counts per bucket
+  std::atomic<uint64_t> m_count{0};                                        ///< number of values
+  std::atomic<uint64_t> m_sum{0};                                          ///< sum of the values
+  std::atomic<uint64_t> m_max{0};                                          ///< highest value
+  std::atomic<uint64_t> m_min{std::numeric_limits<uint64_t>::max()};       ///< lowest value
+};
+
+/**
+ * @brief latency metric recorded by many threads into own histograms
+ * @remarks A thread takes its histogram on its first Record() or Local(), later calls find
+ * it in a thread local table. The table is indexed by the id of the recorder; ids of
+ * destroyed recorders are reused, so a table grows only to the number of recorders alive
+ * at the same time. Histograms of finished threads stay counted. Reset() must not run
+ * concurrently with Record().
+ */
+class LatencyRecorder {
+ public:
+  LatencyRecorder() : m_id(AcquireId()), m_tag(NextTag()) {}
+  ~LatencyRecorder() { ReleaseId(m_id); }
+  LatencyRecorder(const LatencyRecorder&) = delete;
+  LatencyRecorder& operator=(const LatencyRecorder&) = delete;
+
+  /**
+   * @brief counts a value into the histogram of the calling thread
+   * @remarks The first call of a thread allocates its histogram and may throw
+   * std::bad_alloc, call Local() before the hot path to avoid it.
+   * @param ns the value in nanoseconds
+   */
+  void Record(uint64_t ns) { Local().Record(ns); }
+
+  /**
+   * @brief get the histogram of the calling thread, created on the first call
+   * @remarks The histogram is written by the calling thread only.
+   */
+  LatencyHistogram& Local() {
+    thread_local std::vector<Entry> local;
+    if (m_id < local.size() && local[m_id].tag == m_tag) {
+      return *local[m_id].histogram;
+    }
+    if (m_id >= local.size()) {
+      local.resize(m_id + 1);
+    }
+    std::lock_guard<std::mutex> lk(m_mutex);
+    // a deque keeps the histograms in place; an entry of a destroyed recorder is overwritten
+    local[m_id] = {m_tag, &m_shards.emplace_back()};
+    return *local[m_id].histogram;
+  }
+
+  /**
+   * @brief merges the histograms of all threads
+   */
+  [[nodiscard]] LatencyHistogram Snapshot() const {
+    LatencyHistogram merged;
+    std::lock_guard<std::mutex> lk(m_mutex);
+    for (const auto& shard : m_shards) {
+      merged.Merge(shard);
+    }
+    return merged;
+  }
+
+  /**
+   * @brief get the percentiles over all threads
+   */
+  [[nodiscard]] LatencySummary Summary() const { return Snapshot().Summary(); }
+
+  /**
+   * @brief clears the histograms of all threads
+   */
+  void Reset() noexcept {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    for (auto& shard : m_shards) {
+      shard.Reset();
+    }
+  }
+
+ private:
+  /// entry of the thread local table, valid while the tag matches the recorder
+  struct Entry {
+    uint64_t tag{0};
+    LatencyHistogram* histogram{nullptr};
+  };
+
+  /// ids in use and ids given back by destroyed recorders
+  struct IdPool {
+    std::mutex mutex;
+    std::vector<size_t> released;
+    size_t next{0};
+  };
+
+  static IdPool& Ids() {
+    static IdPool pool;
+    return pool;
+  }
+
+  static size_t AcquireId() {
+    auto& pool = Ids();
+    std::lock_guard<std::mutex> lk(pool.mutex);
+    if (pool.released.empty()) {
+      return pool.next++;
+    }
+    const auto id = pool.released.back();
+    pool.released.pop_back();
+    return id;
+  }
+
+  static void ReleaseId(size_t id) noexcept {
+    auto& pool = Ids();
+    std::lock_guard<std::mutex> lk(pool.mutex);
+    try {
+      pool.released.push_back(id);
+    } catch (const std::bad_alloc&) {
+      // the id is lost, the thread local tables grow by one entry
+    }
+  }
+
+  /// tags are never reused, they tell a recorder from a destroyed one with the same id
+  static uint64_t NextTag() noexcept {
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  const size_t m_id;                       ///< index into the thread local tables
+  const uint64_t m_tag;                    ///< identifies this recorder in the tables
+  mutable std::mutex m_mutex;              ///< protects the list of histograms
+  std::deque<LatencyHistogram> m_shards;   ///< one histogram per recording thread
+};
+
+/**
+ * @brief records the lifetime of a scope
+ * @code
+ *   static cppsl::time::LatencyRecorder decodeLatency;
+ *   {
+ *     cppsl::time::ScopedLatency<cppsl::time::CycleClockSource> measure(decodeLatency);
+ *     decode(frame);
+ *   }
+ * @endcode
+ */
+template <class TClockSource = SteadyClockSource>
+class ScopedLatency {
+ public:
+  /// looks up the histogram of the thread, may throw std::bad_alloc on the first use of a thread
+  explicit ScopedLatency(LatencyRecorder& recorder) : m_histogram(recorder.Local()), m_start(TClockSource::Now()) {}
+  ~ScopedLatency() { m_histogram.Record(TClockSource::ToNanoseconds(TClockSource::Now() - m_start)); }
+
+  ScopedLatency(const ScopedLatency&) = delete;
+  ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+ private:
+  LatencyHistogram& m_histogram;   ///< destination, histogram of the thread
+  const uint64_t m_start;          ///< clock reading at construction
+};
+
+}   // namespace cppsl::time
+
+#endif /* INCLUDE_CPPSL_TIME_LATENCY_HPP */
@@ -0,0 +1,457 @@
+/* SPDX-License-Identifier: MIT */
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/************************************************************************/ /**
+ * @file
+ * @brief hierarchical timing wheel serving thousands of timers with one clock
+ * read per tick.
+ *
+ * Four wheels of 256 slots cover 2^32 ticks. A timer is linked into the slot of
+ * the wheel that matches its distance to the current tick; when the lower wheel
+ * wraps, the next slot of the upper wheel is cascaded down. Start, cancel and
+ * restart unlink or link one node, independent of the number of timers.
+ *
+ * Expired timers either call their callback or are queued for PopExpired().
+ * The wheel is driven by its own thread, sleeping with clock_nanosleep on
+ * absolute CLOCK_MONOTONIC deadlines, or by the caller through Advance().
+ *
+ ****************************************************************************/
+
+#ifndef INCLUDE_CPPSL_TIME_TIMER_WHEEL_HPP
+#define INCLUDE_CPPSL_TIME_TIMER_WHEEL_HPP
+
+//-----------------------------------------------------------------------------
+// includes
+//-----------------------------------------------------------------------------
+#include <time.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <cppsl/time/stopTimer.hpp>
+
+//----------------------------------------------------------------------------
+// Public Prototypes
+//----------------------------------------------------------------------------
+
+namespace cppsl::time {
+
+/**
+ * @brief handle of a timer, stays unique after the timer was freed
+ */
+struct TimerId {
+  uint32_t index{std::numeric_limits<uint32_t>::max()};   ///< slot in the timer table
+  uint32_t generation{0};                                 ///< incremented whenever the slot is freed
+
+  bool operator==(const TimerId&) const = default;
+};
+
+template <class TDuration = std::chrono::milliseconds>
+class TimerWheel {
+ public:
+  /** types */
+  using Clock = typename StopTimer<TDuration>::Clock;
+  using TimePoint = typename Clock::time_point;
+  using Callback = std::function<void(TimerId)>;
+
+  static constexpr unsigned levelBits = 8;                   ///< slots per wheel 2^levelBits
+  static constexpr unsigned levels = 4;                      ///< number of wheels
+  static constexpr uint64_t maxTicks = (uint64_t{1} << (levelBits * levels)) - 1;   ///< longest timeout in ticks
+
+  /**
+   * @brief constructor
+   * @param tick resolution of the wheel
+   * @param runThread true to start the timer thread, false to drive the wheel with Advance()
+   */
+  explicit TimerWheel(TDuration tick = TDuration{1}, bool runThread = true)
+      : m_tick(tick.count() > 0 ? tick : TDuration{1}), m_origin(Clock::now()) {
+    m_heads.fill(npos);
+    if (runThread) {
+      m_thread = std::thread([this] { Run(); });
+    }
+  }
+
+  /**
+   * @brief destructor, stops the timer thread, pending timers do not fire
+   */
+  ~TimerWheel() {
+    m_stop.store(true);
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+  }
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  /**
+   * @brief starts a timer calling back on expiry
+   * @param timeout time until the first expiry, rounded up to ticks
+   * @param callback called with the id on the thread driving the wheel, may restart or cancel timers
+   * @param period re-arm interval, zero for a one-shot timer
+   * @return the id of the timer
+   */
+  TimerId Start(TDuration timeout, Callback callback, TDuration period = TDuration{}) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    const auto index = Allocate();
+    auto& node = m_nodes[index];
+    node.m_callback = std::move(callback);
+    node.m_period = Ticks(period);
+    Arm(index, Ticks(timeout));
+    return {index, node.m_generation};
+  }
+
+  /**
+   * @brief starts a timer delivered to PopExpired() on expiry
+   * @param timeout time until the first expiry, rounded up to ticks
+   * @param period re-arm interval, zero for a one-shot timer
+   * @return the id of the timer
+   */
+  TimerId Start(TDuration timeout, TDuration period = TDuration{}) { return Start(timeout, Callback{}, period); }
+
+  /**
+   * @brief starts a StopTimer and a wheel timer with its timeout, so polling and callback agree
+   * @param timer the StopTimer, started now
+   * @param callback called on expiry
+   * @return the id of the timer
+   */
+  TimerId Start(StopTimer<TDuration>& timer, Callback callback) {
+    timer.Start();
+    return Start(timer.Timeout(), std::move(callback));
+  }
+
+  /**
+   * @brief stops a timer
+   * @param id the timer
+   * @return true if the timer was active, false if it expired or was cancelled before
+   * @remarks An expired timer waiting for Release() is freed as well.
+   */
+  bool Cancel(TimerId id) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (!Valid(id)) {
+      return false;
+    }
+    auto& node = m_nodes[id.index];
+    if (node.m_state == State::expired) {
+      Free(id.index);
+      return false;
+    }
+    if (node.m_state == State::armed) {
+      Unlink(id.index);
+    }
+    if (node.m_dispatching) {
+      // the callback may run right now on the wheel thread
+      node.m_state = State::cancelled;
+    } else {
+      Free(id.index);
+    }
+    return true;
+  }
+
+  /**
+   * @brief re-arms a timer with a new timeout, also after it expired as long as it was not freed
+   * @param id the timer
+   * @param timeout time until the next expiry
+   * @return true if re-armed, false if the id is stale
+   */
+  bool Restart(TimerId id, TDuration timeout) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (!Valid(id)) {
+      return false;
+    }
+    if (m_nodes[id.index].m_state == State::armed) {
+      Unlink(id.index);
+    }
+    Arm(id.index, Ticks(timeout));
+    return true;
+  }
+
+  /**
+   * @brief checks whether a timer waits for its expiry
+   * @param id the timer
+   * @return true if armed
+   */
+  [[nodiscard]] bool IsActive(TimerId id) const {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return Valid(id) && m_nodes[id.index].m_state == State::armed;
+  }
+
+  /**
+   * @brief takes the next expired timer without callback
+   * @return the id, or std::nullopt if none expired
+   */
+  std::optional<TimerId> PopExpired() {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (m_queue.empty()) {
+      return std::nullopt;
+    }
+    const auto id = m_queue.front();
+    m_queue.pop_front();
+    return id;
+  }
+
+  /**
+   * @brief processes all ticks up to a time point, called by the timer thread or by the owner
+   * @remarks Callbacks of a tick run before the next tick is processed. A timer cancelled or
+   * restarted by an earlier callback of the same tick is skipped. Only one thread may drive the
+   * wheel, never from a callback.
+   * @param now the current time, read once by the caller
+   * @return the number of expired timers, queued or called back
+   */
+  size_t Advance(TimePoint now) {
+    const auto target = static_cast<uint64_t>(std::max<typename Clock::duration>(now - m_origin, {}) / m_tick);
+
+    std::unique_lock<std::mutex> lk(m_mutex);
+    size_t fired = 0;
+    while (m_current < target) {
+      const auto queued = m_queue.size();
+      Step();
+      fired += m_queue.size() - queued;
+      if (m_firing.empty()) {
+        continue;
+      }
+
+      // callbacks run unlocked, the nodes are not freed until the dispatch ends
+      for (const auto& [node, id] : m_firing) {
+        if (node->m_state != State::firing) {
+          continue;
+        }
+        ++fired;
+        lk.unlock();
+        node->m_callback(id);
+        lk.lock();
+      }
+      Settle();
+    }
+    return fired;
+  }
+
+  /**
+   * @brief frees a one-shot timer without callback after its id was taken from PopExpired()
+   * @param id the timer
+   */
+  void Release(TimerId id) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (Valid(id) && m_nodes[id.index].m_state == State::expired) {
+      Free(id.index);
+    }
+  }
+
+  /**
+   * @brief get the tick duration
+   */
+  [[nodiscard]] TDuration Tick() const noexcept { return m_tick; }
+
+  /**
+   * @brief get the time point of tick zero
+   */
+  [[nodiscard]] TimePoint Origin() const noexcept { return m_origin; }
+
+ private:
+  static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+  static constexpr uint64_t slotMask = (uint64_t{1} << levelBits) - 1;
+
+  enum class State : unsigned char { free, armed, firing, expired, cancelled };
+
+  struct Node {
+    uint64_t m_expiry{0};         ///< tick of the expiry
+    uint64_t m_period{0};         ///< re-arm interval in ticks
+    uint32_t m_prev{npos};        ///< previous node in the slot
+    uint32_t m_next{npos};        ///< next node in the slot, or next free node
+    uint32_t m_slot{npos};        ///< slot the node is linked into
+    uint32_t m_generation{0};     ///< see TimerId
+    State m_state{State::free};   ///< life cycle
+    bool m_dispatching{false};    ///< expired in the running tick, freed after the dispatch
+    Callback m_callback;          ///< empty for queue delivery
+  };
+
+  /// ticks of a duration, rounded up and limited to the range of the wheel
+  uint64_t Ticks(TDuration d) const {
+    if (d.count() <= 0) {
+      return 0;
+    }
+    return std::min<uint64_t>((d.count() + m_tick.count() - 1) / m_tick.count(), maxTicks);
+  }
+
+  bool Valid(TimerId id) const {
+    return id.index < m_nodes.size() && m_nodes[id.index].m_generation == id.generation &&
+           m_nodes[id.index].m_state != State::free && m_nodes[id.index].m_state != State::cancelled;
+  }
+
+  uint32_t Allocate() {
+    if (m_freeHead != npos) {
+      const auto index = m_freeHead;
+      m_freeHead = m_nodes[index].m_next;
+      return index;
+    }
+    // a deque keeps the nodes in place while callbacks run unlocked
+    m_nodes.emplace_back();
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+  }
+
+  void Free(uint32_t index) {
+    auto& node = m_nodes[index];
+    node.m_state = State::free;
+    node.m_callback = nullptr;
+    ++node.m_generation;
+    node.m_next = m_freeHead;
+    m_freeHead = index;
+  }
+
+  /// arms a node, the expiry is one tick later than the timeout so it never fires early
+  void Arm(uint32_t index, uint64_t ticks) {
+    m_nodes[index].m_expiry = m_current + 1 + ticks;
+    m_nodes[index].m_state = State::armed;
+    Link(index);
+  }
+
+  /// re-arms a periodic node from its previous expiry, so the periods do not drift
+  void Rearm(uint32_t index) {
+    auto& node = m_nodes[index];
+    node.m_expiry += node.m_period;
+    node.m_state = State::armed;
+    Link(index);
+  }
+
+  /// links a node into the slot matching its distance to the current tick
+  /// @remarks A cascaded node expiring at the current tick lands in the level 0 slot Step() collects next.
+  void Link(uint32_t index) {
+    auto& node = m_nodes[index];
+    const auto delta = node.m_expiry - m_current;
+    unsigned level = 0;
+    while (level + 1 < levels && delta >= (uint64_t{1} << (levelBits * (level + 1)))) {
+      ++level;
+    }
+    const auto slot = static_cast<uint32_t>((level << levelBits) | ((node.m_expiry >> (levelBits * level)) & slotMask));
+
+    node.m_slot = slot;
+    node.m_prev = npos;
+    node.m_next = m_heads[slot];
+    if (node.m_next != npos) {
+      m_nodes[node.m_next].m_prev = index;
+    }
+    m_heads[slot] = index;
+  }
+
+  void Unlink(uint32_t index) {
+    auto& node = m_nodes[index];
+    if (node.m_prev != npos) {
+      m_nodes[node.m_prev].m_next = node.m_next;
+    } else {
+      m_heads[node.m_slot] = node.m_next;
+    }
+    if (node.m_next != npos) {
+      m_nodes[node.m_next].m_prev = node.m_prev;
+    }
+    node.m_slot = npos;
+  }
+
+  /// moves the nodes of a slot of an upper wheel to the lower wheels
+  void Cascade(unsigned level) {
+    const auto slot = static_cast<uint32_t>((level << levelBits) | ((m_current >> (levelBits * level)) & slotMask));
+    auto index = std::exchange(m_heads[slot], npos);
+    while (index != npos) {
+      const auto next = m_nodes[index].m_next;
+      Link(index);
+      index = next;
+    }
+  }
+
+  /// advances one tick, cascades the upper wheels and collects the expired nodes
+  void Step() {
+    ++m_current;
+    unsigned level = 0;
+    while (level + 1 < levels && ((m_current >> (levelBits * level)) & slotMask) == 0) {
+      ++level;
+    }
+    // the highest wheel first, its nodes may end up in the lower wheels cascaded next
+    for (; level > 0; --level) {
+      Cascade(level);
+    }
+
+    auto index = std::exchange(m_heads[m_current & slotMask], npos);
+    while (index != npos) {
+      auto& node = m_nodes[index];
+      const auto next = node.m_next;
+      node.m_slot = npos;
+      if (node.m_callback) {
+        node.m_state = State::firing;
+        node.m_dispatching = true;
+        m_firing.push_back({&node, {index, node.m_generation}});
+      } else {
+        // queue delivery needs no dispatch
+        m_queue.push_back({index, node.m_generation});
+        if (node.m_period != 0) {
+          Rearm(index);
+        } else {
+          node.m_state = State::expired;
+        }
+      }
+      index = next;
+    }
+  }
+
+  /// re-arms or frees the nodes after their callbacks returned
+  void Settle() {
+    for (const auto& [node, id] : m_firing) {
+      node->m_dispatching = false;
+      if (node->m_state == State::cancelled) {
+        Free(id.index);
+      } else if (node->m_state == State::firing) {
+        if (node->m_period != 0) {
+          Rearm(id.index);
+        } else {
+          Free(id.index);
+        }
+      }
+    }
+    m_firing.clear();
+  }
+
+  /// timer thread: one clock read and one absolute sleep per tick
+  void Run() {
+    const auto tickNs = std::chrono::duration_cast<std::chrono::nanoseconds>(m_tick);
+    while (!m_stop.load(std::memory_order_relaxed)) {
+      const auto now = Clock::now();
+      Advance(now);
+      const auto deadline = m_origin + (((now - m_origin) / m_tick) + 1) * tickNs;
+      const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+      const timespec ts{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+      }
+    }
+  }
+
+  const TDuration m_tick;                                   ///< resolution
+  const TimePoint m_origin;                                 ///< time of tick zero
+  uint64_t m_current{0};                                    ///< last processed tick
+  std::array<uint32_t, levels << levelBits> m_heads{};      ///< first node of every slot
+  std::deque<Node> m_nodes;                                 ///< timer table
+  uint32_t m_freeHead{npos};                                ///< first free node
+  std::vector<std::pair<Node*, TimerId>> m_firing;          ///< nodes expired in the running tick, stable while unlocked
+  std::deque<TimerId> m_queue;                              ///< expired timers without callback
+  mutable std::mutex m_mutex;                               ///< protects the wheel and the table
+  std::atomic<bool> m_stop{false};                          ///< ends the timer thread
+  std::thread m_thread;                                     ///< timer thread, started last
+};
+
+}   // namespace cppsl::time
+
+#endif /* INCLUDE_CPPSL_TIME_TIMER_WHEEL_HPP */
@@ -0,0 +1,194 @@
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * \brief   contains asynchronous file appender.
+ * \author  Alexander Sacharov
+ * \date    2024-06-03
+ * \ingroup
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <cppsl/file/fileAsyncAppender.hpp>
+
+#include <algorithm>
+
+#include "spdlog/spdlog.h"
+
+using namespace std;
+using namespace cppsl;
+using namespace cppsl::file;
+
+//----------------------------------------------------------------------------
+// Function Definitions
+//----------------------------------------------------------------------------
+
+FileAsyncAppender::FileAsyncAppender(std::shared_ptr<FileBaseAppender> target, const FileAsyncConfig& config)
+    : m_target(std::move(target)), m_config(config), m_queue(config.queueCapacity) {
+  m_block.reserve(m_config.blockSize);
+  m_writer = std::thread([this] { run(); });
+}
+
+FileAsyncAppender::~FileAsyncAppender() {
+  m_stop.store(true);
+  wakeWriter();
+  if (m_writer.joinable()) {
+    m_writer.join();
+  }
+}
+
+bool FileAsyncAppender::writeMessage(std::string_view message) {
+  if (m_stop.load(std::memory_order_relaxed)) {
+    m_rejected.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  Record record(message);
+  // the ticket is taken before the push, so a flush() after it waits for every message pushed before
+  m_queued.fetch_add(1);
+  bool waited = false;
+  while (!m_queue.try_push(std::move(record))) {
+    switch (m_config.policy) {
+      case container::OverflowPolicy::dropNewest:
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        returnTicket();
+        return false;
+      case container::OverflowPolicy::fail:
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        returnTicket();
+        return false;
+      case container::OverflowPolicy::dropOldest:
+        if (m_queue.try_pop()) {
+          m_dropped.fetch_add(1, std::memory_order_relaxed);
+          complete(1);
+        }
+        break;
+      case container::OverflowPolicy::block:
+        if (!waited) {
+          waited = true;
+          m_blocked.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (m_stop.load(std::memory_order_relaxed)) {
+          m_rejected.fetch_add(1, std::memory_order_relaxed);
+          returnTicket();
+          return false;
+        }
+        wakeWriter();
+        std::this_thread::yield();
+        break;
+    }
+  }
+
+  // pairs with the fence of the writer: either it sees the message or we see it sleeping
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (m_sleeping.load(std::memory_order_relaxed)) {
+    wakeWriter();
+  }
+  return true;
+}
+
+void FileAsyncAppender::flush() {
+  const auto target = m_queued.load();
+  auto requested = m_flushTarget.load();
+  while (requested < target && !m_flushTarget.compare_exchange_weak(requested, target)) {
+  }
+  wakeWriter();
+  for (;;) {
+    const auto progress = m_progress.load();
+    if (m_completed.load() >= flushTarget(target)) {
+      break;
+    }
+    m_progress.wait(progress);
+  }
+}
+
+size_t FileAsyncAppender::flushTarget(size_t target) const {
+  // a ticket counted in the target may be given back, the message never completes then
+  return std::min(target, m_queued.load());
+}
+
+void FileAsyncAppender::complete(size_t messages) {
+  m_completed.fetch_add(messages);
+  m_progress.fetch_add(1);
+  m_progress.notify_all();
+}
+
+void FileAsyncAppender::returnTicket() {
+  m_queued.fetch_sub(1);
+  m_progress.fetch_add(1);
+  m_progress.notify_all();
+}
+
+container::OverflowCounters FileAsyncAppender::counters() const {
+  return {m_dropped.load(std::memory_order_relaxed), m_blocked.load(std::memory_order_relaxed),
+          m_rejected.load(std::memory_order_relaxed)};
+}
+
+void FileAsyncAppender::wakeWriter() {
+  std::lock_guard<std::mutex> lk(m_mutex);
+  m_wakeup.notify_one();
+}
+
+bool FileAsyncAppender::flushPending() const {
+  return flushTarget(m_flushTarget.load()) > m_completed.load(std::memory_order_relaxed);
+}
+
+void FileAsyncAppender::writeBlock() {
+  if (!m_target->writeMessage(m_block) || !m_target->flush()) {
+    spdlog::warn("asynchronous write of {} messages to {} failed", m_blockRecords, m_target->getFilePath().string());
+  }
+  m_writes.fetch_add(1, std::memory_order_relaxed);
+  m_block.clear();
+  complete(m_blockRecords);
+  m_blockRecords = 0;
+}
+
+void FileAsyncAppender::run() {
+  auto lastWrite = std::chrono::steady_clock::now();
+  Record record;
+
+  for (;;) {
+    bool popped = false;
+    while (m_queue.try_pop(record)) {
+      popped = true;
+      // messages are never split, a block exceeds blockSize only for a single long message
+      if (!m_block.empty() && m_block.size() + record.size() > m_config.blockSize) {
+        writeBlock();
+        lastWrite = std::chrono::steady_clock::now();
+      }
+      m_block.append(record.data(), record.size());
+      ++m_blockRecords;
+    }
+
+    const bool stopping = m_stop.load();
+    const auto now = std::chrono::steady_clock::now();
+    if (flushPending() || stopping || now - lastWrite >= m_config.flushInterval) {
+      if (!m_block.empty()) {
+        writeBlock();
+      }
+      lastWrite = now;
+    }
+
+    if (stopping && m_queue.empty()) {
+      break;
+    }
+
+    if (!popped) {
+      std::unique_lock<std::mutex> lk(m_mutex);
+      m_sleeping.store(true, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      m_wakeup.wait_for(lk, m_config.flushInterval, [this] {
+        return !m_queue.empty() || m_stop.load() || flushPending();
+      });
+      m_sleeping.store(false, std::memory_order_relaxed);
+    }
+  }
+}
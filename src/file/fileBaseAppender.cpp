@@ -113,6 +113,14 @@ bool FileBaseAppender::writeMessage(std::string_view message) {
   return false;
 }
 
+/// flush buffered events
+bool FileBaseAppender::flush() {
+  if (m_fs.is_open()) {
+    return static_cast<bool>(m_fs.flush());
+  }
+  return false;
+}
+
 /// reopen file
 bool FileBaseAppender::reopenFile() {
   if (!m_filePath.empty()) {
@@ -0,0 +1,338 @@
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * \brief   contains rolling file appender writing into memory mapped segments.
+ * \author  Alexander Sacharov
+ * \date    2024-06-10
+ * \ingroup
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <cppsl/file/fileMappedAppender.hpp>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+#include <thread>
+
+#include "spdlog/spdlog.h"
+
+using namespace std;
+using namespace cppsl;
+using namespace cppsl::file;
+
+namespace {
+
+/// writes a finished segment back, releases its pages and cuts the preallocated tail
+void finishSegment(char* data, size_t capacity, int fd, size_t length) {
+  if (::msync(data, length, MS_SYNC) != 0) {
+    spdlog::warn("msync of segment failed: {}", std::strerror(errno));
+  }
+  ::madvise(data, capacity, MADV_DONTNEED);
+  ::munmap(data, capacity);
+  if (::ftruncate(fd, static_cast<off_t>(length)) != 0) {
+    spdlog::error("truncate segment failed: {}", std::strerror(errno));
+  }
+  ::close(fd);
+}
+
+}   // namespace
+
+//----------------------------------------------------------------------------
+// Function Definitions
+//----------------------------------------------------------------------------
+
+FileMappedAppender::FileMappedAppender(const std::filesystem::path& filePath, size_t maxFileSize,
+                                       uint maxBackupIndex, bool append)
+    : FileRollAppender(filePath, maxFileSize, maxBackupIndex, append) {
+  closeFile();
+  removeSpares();
+
+  std::error_code ec;
+  if (append && std::filesystem::file_size(m_filePath, ec) > 0 && !ec) {
+    auto staged = stageFile();
+    if (!staged.empty()) {
+      archiveStaged(std::move(staged));
+    } else {
+      m_pendingStage = true;
+    }
+  }
+  mapSegment(0, nextPath());
+  prepareSpare();
+}
+
+FileMappedAppender::~FileMappedAppender() {
+  {
+    std::lock_guard<std::mutex> lk(m_rollMutex);
+    auto& segment = m_segments[slotOf(m_cursor.load())];
+    if (auto* data = segment.m_data.load()) {
+      finishSegment(data, segment.m_capacity.load(), segment.m_fd, segment.m_committed.load());
+    }
+  }
+  // the spare in preparation refers to this object
+  waitRollOver();
+  discardMapping(m_spare);
+}
+
+FileMappedAppender::Mapping FileMappedAppender::mapFile(const std::filesystem::path& path, size_t capacity) {
+  Mapping mapping;
+  mapping.m_path = path;
+
+  // the path never holds data that is not archived, see nextPath()
+  const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    spdlog::error("open file {} failed: {}", path.string(), std::strerror(errno));
+    return mapping;
+  }
+  if (const int err = ::posix_fallocate(fd, 0, static_cast<off_t>(capacity)); capacity == 0 || err != 0) {
+    spdlog::error("preallocate {} bytes for {} failed: {}", capacity, path.string(), std::strerror(err));
+  } else {
+    void* p = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+      spdlog::error("map file {} failed: {}", path.string(), std::strerror(errno));
+    } else {
+      ::madvise(p, capacity, MADV_SEQUENTIAL);
+      mapping.m_data = static_cast<char*>(p);
+      mapping.m_capacity = capacity;
+      mapping.m_fd = fd;
+      return mapping;
+    }
+  }
+  // releases a partial preallocation, the file is empty
+  ::close(fd);
+  ::unlink(path.c_str());
+  return mapping;
+}
+
+void FileMappedAppender::discardMapping(Mapping& mapping) {
+  if (mapping.m_data != nullptr) {
+    ::munmap(mapping.m_data, mapping.m_capacity);
+    ::close(mapping.m_fd);
+    ::unlink(mapping.m_path.c_str());
+  }
+  mapping = {};
+}
+
+bool FileMappedAppender::mapSegment(uint64_t generation, const std::filesystem::path& path) {
+  Mapping mapping;
+  {
+    std::lock_guard<std::mutex> lk(m_spareMutex);
+    std::swap(mapping, m_spare);
+  }
+  if (mapping.m_data != nullptr && mapping.m_capacity != m_maxFileSize) {
+    // prepared before the maximum file size changed
+    submitHousekeeping([stale = std::move(mapping)]() mutable { discardMapping(stale); });
+    mapping = {};
+  }
+
+  if (mapping.m_data == nullptr) {
+    mapping = mapFile(path, m_maxFileSize);
+  } else if (std::error_code ec; std::filesystem::rename(mapping.m_path, path, ec), ec) {
+    // the segment is archived under the name of the spare
+    spdlog::warn("rename {} failed: {}", mapping.m_path.string(), ec.message());
+  } else {
+    mapping.m_path = path;
+  }
+
+  auto& segment = m_segments[generation & 1];
+  segment.m_fd = mapping.m_fd;
+  segment.m_path = mapping.m_path;
+  segment.m_committed.store(0, std::memory_order_relaxed);
+  segment.m_capacity.store(mapping.m_capacity, std::memory_order_relaxed);
+  segment.m_data.store(mapping.m_data, std::memory_order_relaxed);
+  segment.m_generation.store(generation, std::memory_order_release);
+  return mapping.m_data != nullptr;
+}
+
+void FileMappedAppender::prepareSpare() {
+  {
+    std::lock_guard<std::mutex> lk(m_spareMutex);
+    if (m_spare.m_data != nullptr || m_sparePending) {
+      return;
+    }
+    m_sparePending = true;
+  }
+  auto path = std::filesystem::path(m_filePath.string() + ".spare." + m_stageTag + "." + std::to_string(m_spareCount++));
+  submitHousekeeping([this, path = std::move(path), capacity = m_maxFileSize] {
+    auto mapping = mapFile(path, capacity);
+    std::lock_guard<std::mutex> lk(m_spareMutex);
+    m_spare = std::move(mapping);
+    m_sparePending = false;
+  });
+}
+
+void FileMappedAppender::removeSpares() const {
+  const auto prefix = m_filePath.filename().string() + ".spare.";
+  auto dir = m_filePath.parent_path();
+  if (dir.empty()) {
+    dir = ".";
+  }
+
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+    if (entry.is_regular_file(ec) && entry.path().filename().string().rfind(prefix, 0) == 0) {
+      std::filesystem::remove(entry.path(), ec);
+    }
+  }
+}
+
+bool FileMappedAppender::writeMessage(std::string_view message) {
+  const size_t n = message.size();
+  if (n == 0) {
+    return true;
+  }
+  if (n > m_maxFileSize) {
+    spdlog::warn("message of {} bytes exceeds the segment size", n);
+    return false;
+  }
+
+  for (;;) {
+    const auto cursor = m_cursor.fetch_add(n, std::memory_order_acq_rel);
+    const auto offset = static_cast<size_t>(cursor & offsetMask);
+    auto& segment = m_segments[slotOf(cursor)];
+    char* const data = segment.m_data.load(std::memory_order_relaxed);
+    const size_t capacity = segment.m_capacity.load(std::memory_order_relaxed);
+    if (segment.m_generation.load(std::memory_order_acquire) != (cursor >> offsetBits)) {
+      // the slot was remapped meanwhile, the reservation belongs to a finished segment
+      continue;
+    }
+    if (data == nullptr) {
+      if (!remap(cursor)) {
+        return false;
+      }
+      continue;
+    }
+
+    if (offset + n <= capacity) {
+      std::memcpy(data + offset, message.data(), n);
+      segment.m_committed.fetch_add(n, std::memory_order_release);
+      return true;
+    }
+    if (offset <= capacity) {
+      // this reservation crossed the end, the messages of the segment end at offset
+      roll(cursor, offset);
+    } else {
+      waitRoll(cursor);
+    }
+  }
+}
+
+void FileMappedAppender::waitRoll(uint64_t cursor) const {
+  while ((m_cursor.load(std::memory_order_acquire) >> offsetBits) == (cursor >> offsetBits)) {
+    std::this_thread::yield();
+  }
+}
+
+void FileMappedAppender::roll(uint64_t cursor, size_t length) {
+  std::lock_guard<std::mutex> lk(m_rollMutex);
+  auto& current = m_segments[slotOf(cursor)];
+  char* const data = current.m_data.load(std::memory_order_relaxed);
+  const size_t capacity = current.m_capacity.load(std::memory_order_relaxed);
+  const int fd = current.m_fd;
+
+  if (data != nullptr) {
+    while (current.m_committed.load(std::memory_order_acquire) < length) {
+      std::this_thread::yield();
+    }
+  }
+
+  // the new segment may reuse the path, so the full one is staged before
+  std::filesystem::path staged;
+  if (data != nullptr) {
+    if (current.m_path != m_filePath) {
+      staged = current.m_path;
+    } else if (staged = stageFile(); staged.empty()) {
+      // the data stays under the file name, it is staged by a later rollover
+      finishSegment(data, capacity, fd, length);
+      m_pendingStage = true;
+    }
+  }
+
+  const uint64_t generation = nextGeneration(cursor);
+  mapSegment(generation, nextPath());
+  m_cursor.store(generation << offsetBits, std::memory_order_release);
+
+  prepareSpare();
+  if (!staged.empty()) {
+    archiveStaged(std::move(staged), [data, capacity, fd, length] { finishSegment(data, capacity, fd, length); });
+  }
+}
+
+std::filesystem::path FileMappedAppender::nextPath() {
+  if (m_pendingStage) {
+    // the file is older than any segment under a staging name, so it is archived first
+    if (auto staged = stageFile(); !staged.empty()) {
+      archiveStaged(std::move(staged));
+      m_pendingStage = false;
+    }
+  }
+  return m_pendingStage ? stagingPath() : m_filePath;
+}
+
+bool FileMappedAppender::remap(uint64_t cursor) {
+  std::lock_guard<std::mutex> lk(m_rollMutex);
+  if ((m_cursor.load(std::memory_order_acquire) >> offsetBits) != (cursor >> offsetBits) ||
+      m_segments[slotOf(cursor)].m_data.load(std::memory_order_relaxed) != nullptr) {
+    // another writer mapped a segment meanwhile
+    return true;
+  }
+
+  const uint64_t generation = nextGeneration(cursor);
+  const bool mapped = mapSegment(generation, nextPath());
+  prepareSpare();
+  if (!mapped) {
+    return false;
+  }
+  m_cursor.store(generation << offsetBits, std::memory_order_release);
+  return true;
+}
+
+bool FileMappedAppender::flush() {
+  std::lock_guard<std::mutex> lk(m_rollMutex);
+  auto& segment = m_segments[slotOf(m_cursor.load())];
+  auto* data = segment.m_data.load();
+  return data != nullptr && ::msync(data, segment.m_committed.load(), MS_ASYNC) == 0;
+}
+
+void FileMappedAppender::rollOver() {
+  auto cursor = m_cursor.load();
+  for (;;) {
+    const auto offset = static_cast<size_t>(cursor & offsetMask);
+    const auto& segment = m_segments[slotOf(cursor)];
+    if (segment.m_data.load() == nullptr) {
+      // nothing to finish, the writers wait for no rollover
+      (void)remap(cursor);
+      return;
+    }
+    const size_t capacity = segment.m_capacity.load();
+    if (offset > capacity) {
+      // another writer rolls over already
+      waitRoll(cursor);
+      return;
+    }
+    // reserve the rest of the segment so the writers wait for the new one
+    if (m_cursor.compare_exchange_weak(cursor, cursor + capacity + 1)) {
+      roll(cursor, offset);
+      return;
+    }
+  }
+}
+
+size_t FileMappedAppender::getWrittenSize() const {
+  return m_segments[slotOf(m_cursor.load())].m_committed.load();
+}
+
+bool FileMappedAppender::reopenFile() {
+  rollOver();
+  return isMapped();
+}
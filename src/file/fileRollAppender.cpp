@@ -16,27 +16,119 @@
 
 #include "cppsl/file/fileRollAppender.hpp"
 #include <math.h>
-#include <iomanip>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
 #include <iostream>
+#include <vector>
 
+#include "cppsl/thread/workerPool.hpp"
 #include "spdlog/spdlog.h"
 
 using namespace std;
 using namespace cppsl;
 using namespace cppsl::file;
 
+namespace {
+
+/// everything the background thread needs to archive one staged file
+struct Archive {
+  std::filesystem::path staged;                   ///< the full file under its staging name
+  std::string base;                               ///< log file path, prefix of the backups
+  unsigned int maxBackupIndex;                    ///< number of backups kept
+  uint16_t width;                                 ///< digits of the backup index
+  FileRollAppender::Compressor compressor;        ///< may be empty
+  std::string suffix;                             ///< suffix of compressed backups
+};
+
+/// size of the file seen by the appender: the file size when appending, as tellp() is 0 right after
+/// the open, otherwise the position of the put pointer
+size_t streamSize(std::fstream& fs, const std::filesystem::path& path, std::ios_base::openmode mode) {
+  if (mode & std::ios_base::app) {
+    std::error_code ec;
+    const auto size = std::filesystem::file_size(path, ec);
+    return ec ? 0 : static_cast<size_t>(size);
+  }
+  const auto pos = fs.tellp();
+  return pos > 0 ? static_cast<size_t>(pos) : 0;
+}
+
+/// process id and start time, distinguishes the staging names of the runs
+std::string stageTag() {
+  const auto now = std::chrono::system_clock::now().time_since_epoch();
+  return std::to_string(::getpid()) + "-" +
+         std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
+}
+
+/// name of a backup, the index is zero padded so the files are listed in order
+std::filesystem::path backupPath(const Archive& job, unsigned int index) {
+  auto number = std::to_string(index);
+  if (number.size() < job.width) {
+    number.insert(0, job.width - number.size(), '0');
+  }
+  return job.base + "." + number + (job.compressor ? job.suffix : std::string());
+}
+
+/// shifts the backups by one, prunes the oldest and moves the staged file to index 1
+void archive(const Archive& job) {
+  std::error_code ec;
+  if (job.maxBackupIndex == 0) {
+    std::filesystem::remove(job.staged, ec);
+    return;
+  }
+
+  // remove the very last (oldest) file and rename each existing file to the consequent one
+  std::filesystem::remove(backupPath(job, job.maxBackupIndex), ec);
+  for (auto i = job.maxBackupIndex; i > 1; i--) {
+    const auto from = backupPath(job, i - 1);
+    if (std::filesystem::exists(from, ec)) {
+      std::filesystem::rename(from, backupPath(job, i), ec);
+    }
+  }
+
+  // new backup will be numbered 1
+  const auto first = backupPath(job, 1);
+  if (job.compressor) {
+    if (job.compressor(job.staged, first)) {
+      std::filesystem::remove(job.staged, ec);
+    } else {
+      spdlog::error("compress {} failed, kept uncompressed", job.staged.string());
+    }
+    return;
+  }
+  std::filesystem::rename(job.staged, first, ec);
+  if (ec) {
+    spdlog::error("rename {} failed: {}", job.staged.string(), ec.message());
+  }
+}
+
+}   // namespace
+
 FileRollAppender::FileRollAppender(const filesystem::path& filePath, bool append, ios_base::openmode mode)
     : FileBaseAppender(filePath, append, mode),
       m_maxBackupIndex(maxRollFileAppenderBackIndex > 0 ? maxRollFileAppenderBackIndex : 1),
       m_maxBackupIndexWidth((m_maxBackupIndex > 0) ? (unsigned short)log10((float)m_maxBackupIndex) + 1 : 1),
-      m_maxFileSize(maxRollFileAppenderSize) {}
+      m_maxFileSize(maxRollFileAppenderSize),
+      m_written(streamSize(m_fs, m_filePath, m_mode)),
+      m_stageTag(stageTag()) {
+  recoverStaged();
+}
 
 FileRollAppender::FileRollAppender(const std::filesystem::path& filePath, size_t maxFileSize, uint maxBackupIndex,
                                    bool append, std::ios_base::openmode mode)
     : FileBaseAppender(filePath, append, mode),
       m_maxBackupIndex(maxBackupIndex > 0 ? maxBackupIndex : 1),
       m_maxBackupIndexWidth((m_maxBackupIndex > 0) ? (unsigned short)log10((float)m_maxBackupIndex) + 1 : 1),
-      m_maxFileSize(maxFileSize) {}
+      m_maxFileSize(maxFileSize),
+      m_written(streamSize(m_fs, m_filePath, m_mode)),
+      m_stageTag(stageTag()) {
+  recoverStaged();
+}
+
+FileRollAppender::~FileRollAppender() {
+  // the pool drains the staged files before it joins
+  m_housekeeper.reset();
+}
 
 void FileRollAppender::setMaxBackupIndex(unsigned int maxBackups) {
   m_maxBackupIndex = maxBackups;
@@ -55,60 +147,103 @@ size_t FileRollAppender::getMaxFileSize() const {
   return m_maxFileSize;
 }
 
+void FileRollAppender::setCompressor(Compressor compressor, std::string suffix) {
+  m_compressor = std::move(compressor);
+  m_compressSuffix = std::move(suffix);
+}
+
 void FileRollAppender::rollOver() {
-  // close file
   closeFile();
 
-  if (m_maxBackupIndex > 0) {
-    // stream
-    std::ostringstream filename_stream;
-
-    filename_stream << m_filePath.string() << "." << std::setw(m_maxBackupIndexWidth) << std::setfill(char('0'))
-                    << m_maxBackupIndex << std::ends;
-
-    // remove the very last (oldest) file
-    std::string last_log_filename = filename_stream.str();
-    std::filesystem::remove(last_log_filename);
-
-    // rename each existing file to the consequent one
-    for (auto i = m_maxBackupIndex; i > 1; i--) {
-      filename_stream.str(std::string());
-      // set padding so the files are listed in order
-      filename_stream << m_filePath.string() << "." << std::setw(m_maxBackupIndexWidth) << std::setfill(char('0'))
-                      << i - 1 << std::ends;
-      // rename file
-      if (std::filesystem::exists(filename_stream.str())) {
-        std::filesystem::rename(filename_stream.str(), last_log_filename);
-      }
-      last_log_filename = filename_stream.str();
+  // stage the full file with a single rename, the new file is open before any backup is touched
+  auto staged = stageFile();
+  if (staged.empty()) {
+    m_fs.open(m_filePath.string(), m_mode);
+    m_written = streamSize(m_fs, m_filePath, m_mode);
+    return;
+  }
+
+  m_fs.open(m_filePath.string(), (m_mode & ~std::ios_base::app) | std::ios_base::out | std::ios_base::trunc);
+  if (!m_fs.is_open()) {
+    spdlog::error("open file {} failed", m_filePath.string());
+  }
+  m_written = 0;
+  archiveStaged(std::move(staged));
+}
+
+std::filesystem::path FileRollAppender::stagingPath() {
+  return m_filePath.string() + ".rolling." + m_stageTag + "." + std::to_string(m_rollCount.fetch_add(1));
+}
+
+void FileRollAppender::recoverStaged() {
+  const auto prefix = m_filePath.filename().string() + ".rolling.";
+  auto dir = m_filePath.parent_path();
+  if (dir.empty()) {
+    dir = ".";
+  }
+
+  std::error_code ec;
+  std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> leftovers;
+  for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+    if (entry.is_regular_file(ec) && entry.path().filename().string().rfind(prefix, 0) == 0) {
+      leftovers.emplace_back(entry.last_write_time(ec), entry.path());
     }
+  }
+  std::sort(leftovers.begin(), leftovers.end());
+  for (auto& [time, path] : leftovers) {
+    spdlog::warn("archive staged file {} of a former run", path.string());
+    archiveStaged(std::move(path));
+  }
+}
 
-    // new file will be numbered 1
-    std::filesystem::rename(m_filePath.string().c_str(), last_log_filename.c_str());
+std::filesystem::path FileRollAppender::stageFile() {
+  auto staged = stagingPath();
+  std::error_code ec;
+  std::filesystem::rename(m_filePath, staged, ec);
+  if (ec) {
+    spdlog::error("stage file {} failed: {}", m_filePath.string(), ec.message());
+    return {};
   }
+  return staged;
+}
 
-  if (!std::filesystem::exists(m_filePath.string())) {
-    try {
-      std::ofstream{m_filePath.string()};
-    } catch (...) {
-      spdlog::error("create file {} failed", m_filePath.string());
+void FileRollAppender::archiveStaged(std::filesystem::path staged, std::function<void()> prepare) {
+  submitHousekeeping([prepare = std::move(prepare),
+                         job = Archive{std::move(staged), m_filePath.string(), m_maxBackupIndex,
+                                       m_maxBackupIndexWidth, m_compressor, m_compressSuffix}] {
+    if (prepare) {
+      prepare();
     }
+    archive(job);
+  });
+}
+
+void FileRollAppender::submitHousekeeping(std::function<void()> task) {
+  if (!m_housekeeper) {
+    m_housekeeper = std::make_unique<thread::WorkerPool>(1);
   }
+  m_housekeeper->submit(std::move(task));
+}
 
-  m_fs.open(m_filePath.string(), m_mode);
+void FileRollAppender::waitRollOver() {
+  if (m_housekeeper) {
+    m_housekeeper->wait_idle();
+  }
+}
+
+bool FileRollAppender::reopenFile() {
+  const auto res = FileBaseAppender::reopenFile();
+  m_written = streamSize(m_fs, m_filePath, m_mode);
+  return res;
 }
 
 bool FileRollAppender::writeMessage(std::string_view message) {
   auto res = FileBaseAppender::writeMessage(message);
 
   if (res) {
-    off_t offset = m_fs.tellg();
-    if (offset < 0) {
-      spdlog::error("append new event to log failed");
-    } else {
-      if (static_cast<size_t>(offset) >= m_maxFileSize) {
-        rollOver();
-      }
+    m_written += message.size();
+    if (m_written >= m_maxFileSize) {
+      rollOver();
     }
   }
   return res;
@@ -1,6 +1,11 @@
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
 #include <cppsl/container/circularBuffer.hpp>
+#include <cppsl/container/circularBufferSpsc.hpp>
+#include <array>
+#include <numeric>
+#include <thread>
+#include <vector>
 
 TEST_CASE("CircularBuffer with int", "[CircularBuffer]") {
   cppsl::container::CircularBuffer<int> buffer(8);
@@ -114,4 +119,170 @@ TEST_CASE("CircularBuffer with custom struct preemptive", "[CircularBufferLFPree
   REQUIRE(item.id == 4);
   REQUIRE(item.name == "Sahra");
   REQUIRE(buffer.empty());
-}
\ No newline at end of file
+}
+
+TEST_CASE("CircularBufferSpsc with int", "[CircularBufferSpsc]") {
+  cppsl::container::CircularBufferSpsc<int> buffer(6);
+
+  REQUIRE(buffer.empty());
+  REQUIRE(buffer.capacity() == 8);
+
+  for (int i = 1; i <= 8; ++i) {
+    REQUIRE(buffer.push(i));
+  }
+  REQUIRE(buffer.full());
+  REQUIRE(!buffer.push(9));
+  REQUIRE(buffer.size() == 8);
+
+  int item;
+  REQUIRE(buffer.pop(item));
+  REQUIRE(item == 1);
+  REQUIRE(buffer.size() == 7);
+}
+
+TEST_CASE("CircularBufferSpsc block push and pop across the wrap", "[CircularBufferSpsc]") {
+  cppsl::container::CircularBufferSpsc<int> buffer(8);
+  std::array<int, 6> block{1, 2, 3, 4, 5, 6};
+  std::array<int, 6> out{};
+
+  REQUIRE(buffer.push_n(block) == 6);
+  REQUIRE(buffer.pop_n(std::span(out).first(4)) == 4);
+  REQUIRE(out[0] == 1);
+  REQUIRE(out[3] == 4);
+
+  // write index at 6, block wraps around the end of the storage
+  REQUIRE(buffer.push_n(block) == 6);
+  REQUIRE(buffer.push_n(block) == 0);
+  REQUIRE(buffer.size() == 8);
+
+  out.fill(0);
+  REQUIRE(buffer.pop_n(out) == 6);
+  REQUIRE(out == std::array<int, 6>{5, 6, 1, 2, 3, 4});
+  REQUIRE(buffer.pop_n(out) == 2);
+  REQUIRE(out[0] == 5);
+  REQUIRE(out[1] == 6);
+  REQUIRE(buffer.empty());
+}
+
+TEST_CASE("CircularBufferSpsc zero copy regions", "[CircularBufferSpsc]") {
+  cppsl::container::CircularBufferSpsc<int> buffer(8);
+
+  auto region = buffer.write_prepare(5);
+  REQUIRE(region.size() == 5);
+  std::iota(region.begin(), region.end(), 10);
+  REQUIRE(buffer.empty());
+  buffer.write_commit(region.size());
+  REQUIRE(buffer.size() == 5);
+
+  auto readable = buffer.read_peek();
+  REQUIRE(readable.size() == 5);
+  REQUIRE(readable[0] == 10);
+  REQUIRE(readable[4] == 14);
+  buffer.read_release(readable.size());
+
+  // only the part up to the end of storage is contiguous
+  region = buffer.write_prepare(8);
+  REQUIRE(region.size() == 3);
+  buffer.write_commit(region.size());
+  region = buffer.write_prepare(8);
+  REQUIRE(region.size() == 5);
+}
+
+TEST_CASE("CircularBufferSpsc producer and consumer threads", "[CircularBufferSpsc]") {
+  constexpr int count = 100000;
+  cppsl::container::CircularBufferSpsc<int> buffer(128);
+
+  std::thread producer([&buffer] {
+    std::array<int, 80> block;
+    int next = 0;
+    while (next < count) {
+      const int n = std::min<int>(block.size(), count - next);
+      std::iota(block.begin(), block.begin() + n, next);
+      auto pending = std::span<const int>(block.data(), n);
+      while (!pending.empty()) {
+        const auto pushed = buffer.push_n(pending);
+        if (pushed == 0) {
+          std::this_thread::yield();
+        }
+        pending = pending.subspan(pushed);
+      }
+      next += n;
+    }
+  });
+
+  std::vector<int> received;
+  received.reserve(count);
+  std::array<int, 64> out;
+  while (received.size() < count) {
+    const auto n = buffer.pop_n(out);
+    if (n == 0) {
+      std::this_thread::yield();
+    }
+    received.insert(received.end(), out.begin(), out.begin() + n);
+  }
+  producer.join();
+
+  std::vector<int> expected(count);
+  std::iota(expected.begin(), expected.end(), 0);
+  REQUIRE(received == expected);
+}
+
+TEST_CASE("CircularBuffer with compile-time capacity", "[CircularBufferFixed]") {
+  cppsl::container::CircularBuffer<int, 4> buffer;
+
+  static_assert(decltype(buffer)::capacity() == 4);
+  REQUIRE(buffer.empty());
+
+  REQUIRE(buffer.push(1));
+  REQUIRE(buffer.push(2));
+  REQUIRE(buffer.emplace(3));
+  REQUIRE(!buffer.push(4));
+  REQUIRE(buffer.full());
+  REQUIRE(buffer.size() == 3);
+
+  int item;
+  REQUIRE(buffer.pop(item));
+  REQUIRE(item == 1);
+  REQUIRE(buffer.push(4));
+  REQUIRE(buffer.pop(item));
+  REQUIRE(item == 2);
+  REQUIRE(buffer.pop(item));
+  REQUIRE(item == 3);
+  REQUIRE(buffer.pop(item));
+  REQUIRE(item == 4);
+  REQUIRE(buffer.empty());
+}
+
+TEST_CASE("CircularBuffer with compile-time capacity and not default constructible type", "[CircularBufferFixed]") {
+  struct Counted {
+    explicit Counted(int value, int& alive) : m_value(value), m_alive(&alive) { ++*m_alive; }
+    Counted(const Counted& other) : m_value(other.m_value), m_alive(other.m_alive) { ++*m_alive; }
+    Counted& operator=(const Counted& other) = default;
+    ~Counted() { --*m_alive; }
+    int m_value;
+    int* m_alive;
+  };
+
+  int alive = 0;
+  {
+    cppsl::container::CircularBuffer<Counted, 8> buffer;
+    REQUIRE(alive == 0);
+
+    REQUIRE(buffer.emplace(1, alive));
+    REQUIRE(buffer.emplace(2, alive));
+    REQUIRE(buffer.emplace(3, alive));
+    REQUIRE(alive == 3);
+
+    Counted item(0, alive);
+    REQUIRE(buffer.pop(item));
+    REQUIRE(item.m_value == 1);
+    REQUIRE(alive == 3);
+
+    buffer.clear();
+    REQUIRE(buffer.empty());
+    REQUIRE(alive == 1);
+
+    REQUIRE(buffer.emplace(4, alive));
+  }
+  REQUIRE(alive == 0);
+}
@@ -1,6 +1,11 @@
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <cppsl/byteSwap.hpp>
+#include <cppsl/endian.hpp>
+#include <vector>
 
 TEST_CASE("ByteSwapper SwapType::NX", "[ByteSwapper]") {
   uint16_t val = 0x1234;
@@ -57,4 +62,121 @@ TEST_CASE("ByteSwapper with different types", "[ByteSwapper]") {
     double swapped = cppsl::ByteSwapper::Swap(val, cppsl::ByteSwapper::SwapType::AX);
     REQUIRE(cppsl::ByteSwapper::Swap(swapped, cppsl::ByteSwapper::SwapType::AX) == val);
   }
-}
\ No newline at end of file
+}
+TEST_CASE("ByteSwapper compile time SwapType", "[ByteSwapper]") {
+  uint32_t val = 0x12345678;
+  REQUIRE(cppsl::ByteSwapper::Swap<cppsl::ByteSwapper::SwapType::AX>(val) == 0x78563412);
+  REQUIRE(cppsl::ByteSwapper::Swap<cppsl::ByteSwapper::SwapType::NX>(val) == val);
+  const bool little = std::endian::native == std::endian::little;
+  REQUIRE(cppsl::ByteSwapper::Swap<cppsl::ByteSwapper::SwapType::LE>(val) == (little ? 0x78563412u : val));
+  REQUIRE(cppsl::ByteSwapper::Swap<cppsl::ByteSwapper::SwapType::BE>(val) == (little ? val : 0x78563412u));
+  static_assert(cppsl::ByteSwapper::Swaps<cppsl::ByteSwapper::SwapType::AX>());
+  static_assert(!cppsl::ByteSwapper::Swaps<cppsl::ByteSwapper::SwapType::NX>());
+}
+
+template <typename T>
+void RequireBulkSwap() {
+  // odd length to cover the vector kernel and the scalar tail
+  std::vector<T> data(37);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<T>(0x0102030405060708ull * (i + 1));
+  }
+  std::vector<T> expected;
+  for (auto v : data) {
+    expected.push_back(cppsl::ByteSwapper::Swap(v, cppsl::ByteSwapper::SwapType::AX));
+  }
+
+  std::vector<T> copy(data.size() + 3);
+  REQUIRE(cppsl::ByteSwapper::CopySwap(std::span<const T>(data), std::span<T>(copy), cppsl::ByteSwapper::SwapType::AX) ==
+          data.size());
+  REQUIRE(std::equal(expected.begin(), expected.end(), copy.begin()));
+
+  auto inPlace = data;
+  cppsl::ByteSwapper::SwapBuffer<cppsl::ByteSwapper::SwapType::AX>(std::span<T>(inPlace));
+  REQUIRE(inPlace == expected);
+  cppsl::ByteSwapper::SwapBuffer(std::span<T>(inPlace), cppsl::ByteSwapper::SwapType::AX);
+  REQUIRE(inPlace == data);
+
+  std::vector<T> plain(data.size());
+  cppsl::ByteSwapper::CopySwap<cppsl::ByteSwapper::SwapType::NX>(std::span<const T>(data), std::span<T>(plain));
+  REQUIRE(plain == data);
+
+  // partially overlapping buffers, shifted in both directions
+  for (const size_t shift : {size_t{1}, size_t{5}}) {
+    std::vector<T> buffer(data.size() + shift);
+    std::copy(data.begin(), data.end(), buffer.begin());
+    const std::span<T> all(buffer);
+    cppsl::ByteSwapper::CopySwap(std::span<const T>(all.first(data.size())), all.subspan(shift),
+                                 cppsl::ByteSwapper::SwapType::AX);
+    REQUIRE(std::equal(expected.begin(), expected.end(), buffer.begin() + static_cast<std::ptrdiff_t>(shift)));
+
+    std::copy(data.begin(), data.end(), buffer.begin() + static_cast<std::ptrdiff_t>(shift));
+    cppsl::ByteSwapper::CopySwap<cppsl::ByteSwapper::SwapType::AX>(std::span<const T>(all.subspan(shift)),
+                                                                   all.first(data.size()));
+    REQUIRE(std::equal(expected.begin(), expected.end(), buffer.begin()));
+  }
+}
+
+TEST_CASE("ByteSwapper bulk buffers", "[ByteSwapper]") {
+  SECTION("uint16_t") { RequireBulkSwap<uint16_t>(); }
+  SECTION("int32_t") { RequireBulkSwap<int32_t>(); }
+  SECTION("uint64_t") { RequireBulkSwap<uint64_t>(); }
+  SECTION("uint8_t") { RequireBulkSwap<uint8_t>(); }
+}
+
+namespace {
+
+/// start of an SV APDU header in network byte order
+struct SvHeader {
+  cppsl::BigEndian<uint16_t> appId;
+  cppsl::BigEndian<uint16_t> length;
+  cppsl::BigEndian<uint16_t> reserved1;
+  cppsl::BigEndian<uint16_t> reserved2;
+};
+
+}   // namespace
+
+TEST_CASE("BigEndian and LittleEndian storage", "[Endian]") {
+  cppsl::BigEndian<uint32_t> be = 0x12345678u;
+  cppsl::LittleEndian<uint32_t> le = 0x12345678u;
+  std::array<std::byte, 4> raw{};
+  std::memcpy(raw.data(), &be, 4);
+  REQUIRE(raw[0] == std::byte{0x12});
+  REQUIRE(raw[3] == std::byte{0x78});
+  std::memcpy(raw.data(), &le, 4);
+  REQUIRE(raw[0] == std::byte{0x78});
+  REQUIRE(be == 0x12345678u);
+  REQUIRE(le.get() == 0x12345678u);
+
+  cppsl::BigEndian<float> f = 1.5f;
+  REQUIRE(f.get() == 1.5f);
+  static_assert(sizeof(SvHeader) == 8 && alignof(SvHeader) == 1);
+}
+
+TEST_CASE("PackedView reads fields of a packet", "[Endian]") {
+  const std::array<uint8_t, 15> packet{0x40, 0x00, 0x00, 0x5c, 0x00, 0x00, 0x00, 0x00,   // header
+                                       0xff, 0xff, 0xfc, 0x18,                           // int32 -1000
+                                       0x34, 0x12, 0x01};
+  const cppsl::PackedView view(std::as_bytes(std::span(packet)));
+
+  REQUIRE(view.Size() == packet.size());
+  const auto header = view.Read<SvHeader>(0);
+  REQUIRE(header.appId == 0x4000);
+  REQUIRE(header.length == 0x5c);
+  REQUIRE(view.Get<int32_t>(8) == -1000);
+  REQUIRE(view.Get<uint16_t, std::endian::little>(12) == 0x1234);
+  REQUIRE(view.Get<uint8_t>(14) == 1);
+
+  // unaligned field
+  REQUIRE(view.Get<uint16_t>(3) == 0x5c00);
+
+  REQUIRE_THROWS_AS(view.Get<uint32_t>(12), std::out_of_range);
+  REQUIRE(view.TryGet<uint32_t>(12).invalid());
+  REQUIRE(view.TryGet<uint16_t>(13).get() == 0x1201);
+
+  const auto value = view.Sub(8, 4);
+  REQUIRE(value.Size() == 4);
+  REQUIRE(value.Get<int32_t>(0) == -1000);
+  REQUIRE(view.Sub(12).Size() == 3);
+  REQUIRE_THROWS_AS(view.Sub(12, 4), std::out_of_range);
+}
@@ -1,8 +1,16 @@
 #define CATCH_CONFIG_MAIN
 #include <catch2/catch.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 #include "cppsl/container/dequeSafe.hpp"
+#include "cppsl/container/dequeWorkStealing.hpp"
+#include "cppsl/container/listReadMostly.hpp"
 #include "cppsl/container/listSafe.hpp"
 #include "cppsl/container/queueLockFree.hpp"
+#include "cppsl/container/queueLockFreeBounded.hpp"
 #include "cppsl/container/queueSafe.hpp"
 
 TEST_CASE("DequeSafe with int", "[DequeSafe]") {
@@ -196,3 +204,456 @@ TEST_CASE("QueueLockFree with custom struct", "[QueueLockFree]") {
   REQUIRE(ret->id == 3);
   REQUIRE(ret->name == "Charlie");
 }
+
+TEST_CASE("QueueLockFreeBounded with std::string", "[QueueLockFreeBounded]") {
+  cppsl::container::QueueLockFreeBounded<std::string> queue(3);
+
+  REQUIRE(queue.capacity() == 4);
+  REQUIRE(queue.empty());
+  REQUIRE(!queue.try_pop());
+
+  REQUIRE(queue.try_push("one"));
+  REQUIRE(queue.try_push("two"));
+  REQUIRE(queue.try_emplace(5, 'x'));
+  REQUIRE(queue.try_push("four"));
+  REQUIRE(!queue.try_push("five"));
+  REQUIRE(queue.size() == 4);
+
+  std::string item;
+  REQUIRE(queue.try_pop(item));
+  REQUIRE(item == "one");
+  REQUIRE(*queue.try_pop() == "two");
+  REQUIRE(*queue.try_pop() == "xxxxx");
+  REQUIRE(queue.try_push("five"));
+  REQUIRE(*queue.try_pop() == "four");
+  REQUIRE(*queue.try_pop() == "five");
+  REQUIRE(queue.empty());
+}
+
+TEST_CASE("QueueLockFreeBounded with movable only type", "[QueueLockFreeBounded]") {
+  cppsl::container::QueueLockFreeBounded<std::unique_ptr<int>> queue(4);
+
+  REQUIRE(queue.try_push(std::make_unique<int>(1)));
+  REQUIRE(queue.try_push(std::make_unique<int>(2)));
+
+  auto ret = queue.try_pop();
+  REQUIRE(ret.has_value());
+  REQUIRE(**ret == 1);
+  // remaining element is released by the destructor
+}
+
+TEST_CASE("QueueLockFreeBounded keeps working after a throwing constructor", "[QueueLockFreeBounded]") {
+  cppsl::container::QueueLockFreeBounded<std::string> queue(2);
+
+  REQUIRE_THROWS_AS(queue.try_emplace(std::string("abc"), 10), std::out_of_range);
+  REQUIRE(queue.empty());
+  REQUIRE(queue.try_push("one"));
+  REQUIRE(*queue.try_pop() == "one");
+  REQUIRE(queue.empty());
+}
+
+TEST_CASE("QueueLockFreeBounded with multiple producers and consumers", "[QueueLockFreeBounded]") {
+  constexpr int producers = 4;
+  constexpr int consumers = 4;
+  constexpr int itemsPerProducer = 10000;
+
+  cppsl::container::QueueLockFreeBounded<int> queue(64);
+  std::atomic<long long> sum{0};
+  std::atomic<int> popped{0};
+  std::vector<std::thread> threads;
+
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&queue, p] {
+      for (int i = 1; i <= itemsPerProducer; ++i) {
+        while (!queue.try_push(p * itemsPerProducer + i)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (int c = 0; c < consumers; ++c) {
+    threads.emplace_back([&] {
+      while (popped.load() < producers * itemsPerProducer) {
+        int value;
+        if (queue.try_pop(value)) {
+          sum += value;
+          ++popped;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  const long long n = producers * itemsPerProducer;
+  REQUIRE(popped.load() == n);
+  REQUIRE(sum.load() == n * (n + 1) / 2);
+  REQUIRE(queue.empty());
+}
+
+TEST_CASE("QueueSafe with movable only type", "[QueueSafe]") {
+  cppsl::container::QueueSafe<std::unique_ptr<int>> queue;
+
+  REQUIRE(queue.empty());
+  REQUIRE(!queue.try_pop_value());
+
+  queue.push(std::make_unique<int>(1));
+  queue.emplace(new int(2));
+  queue.push(std::make_unique<int>(3));
+  REQUIRE(queue.size() == 3);
+
+  auto first = queue.try_pop_value();
+  REQUIRE(first.has_value());
+  REQUIRE(**first == 1);
+  REQUIRE(*queue.wait_and_pop_value() == 2);
+
+  std::unique_ptr<int> item;
+  REQUIRE(queue.try_pop(item));
+  REQUIRE(*item == 3);
+  REQUIRE(queue.empty());
+}
+
+TEST_CASE("QueueSafe bulk drain", "[QueueSafe]") {
+  cppsl::container::QueueSafe<std::string> queue;
+
+  queue.push("one");
+  queue.push("two");
+  queue.push("three");
+
+  std::vector<std::string> drained;
+  REQUIRE(queue.pop_all(std::back_inserter(drained)) == 3);
+  REQUIRE(drained == std::vector<std::string>{"one", "two", "three"});
+  REQUIRE(queue.empty());
+
+  queue.push("four");
+  queue.push("five");
+  auto content = queue.swap_out();
+  REQUIRE(queue.empty());
+  REQUIRE(content.size() == 2);
+  REQUIRE(content.front() == "four");
+}
+
+TEST_CASE("DequeSafe with movable only type", "[DequeSafe]") {
+  cppsl::container::DequeSafe<std::unique_ptr<int>> deque;
+
+  REQUIRE(!deque.try_pop_front_value());
+  REQUIRE(!deque.try_pop_back_value());
+
+  deque.push_back(std::make_unique<int>(2));
+  deque.emplace_back(new int(3));
+  deque.push_front(std::make_unique<int>(1));
+  deque.emplace_front(new int(0));
+  REQUIRE(deque.size() == 4);
+
+  REQUIRE(**deque.try_pop_front_value() == 0);
+  REQUIRE(**deque.try_pop_back_value() == 3);
+  REQUIRE(*deque.wait_and_pop_back_value() == 2);
+  REQUIRE(*deque.wait_and_pop_front_value() == 1);
+  REQUIRE(deque.empty());
+}
+
+TEST_CASE("DequeSafe bulk drain", "[DequeSafe]") {
+  cppsl::container::DequeSafe<int> deque;
+
+  deque.push_back(2);
+  deque.push_back(3);
+  deque.push_front(1);
+
+  std::vector<int> drained;
+  REQUIRE(deque.pop_all(std::back_inserter(drained)) == 3);
+  REQUIRE(drained == std::vector<int>{1, 2, 3});
+  REQUIRE(deque.empty());
+
+  deque.push_back(4);
+  auto content = deque.swap_out();
+  REQUIRE(deque.empty());
+  REQUIRE(content.size() == 1);
+  REQUIRE(content.front() == 4);
+}
+
+TEST_CASE("QueueSafe timed and stoppable waits", "[QueueSafe]") {
+  using namespace std::chrono_literals;
+  cppsl::container::QueueSafe<int> queue;
+  int item = 0;
+
+  REQUIRE(!queue.wait_for_and_pop(item, 10ms));
+  REQUIRE(!queue.wait_until_and_pop(item, std::chrono::steady_clock::now() + 1ms));
+
+  queue.push(1);
+  REQUIRE(queue.wait_for_and_pop(item, 10ms));
+  REQUIRE(item == 1);
+
+  std::stop_source stop;
+  bool popped = true;
+  std::thread consumer([&] { popped = queue.wait_and_pop(item, stop.get_token()); });
+  std::this_thread::sleep_for(10ms);
+  stop.request_stop();
+  consumer.join();
+  REQUIRE(!popped);
+  REQUIRE(!queue.wait_for_and_pop(item, 1h, stop.get_token()));
+}
+
+TEST_CASE("QueueSafe batch wait", "[QueueSafe]") {
+  using namespace std::chrono_literals;
+  cppsl::container::QueueSafe<int> queue;
+  std::vector<int> batch;
+
+  queue.push(1);
+  REQUIRE(queue.wait_for_and_pop_batch(std::back_inserter(batch), 4, 8, 10ms) == 1);
+  REQUIRE(batch == std::vector<int>{1});
+
+  std::thread producer([&queue] {
+    for (int i = 0; i < 6; ++i) {
+      queue.push(i);
+    }
+  });
+  batch.clear();
+  while (batch.size() < 4) {
+    queue.wait_for_and_pop_batch(std::back_inserter(batch), 4 - batch.size(), 4 - batch.size(), 1s);
+  }
+  producer.join();
+  REQUIRE(batch == std::vector<int>{0, 1, 2, 3});
+  REQUIRE(queue.size() == 2);
+}
+
+TEST_CASE("DequeSafe timed and stoppable waits", "[DequeSafe]") {
+  using namespace std::chrono_literals;
+  cppsl::container::DequeSafe<int> deque;
+  int item = 0;
+
+  REQUIRE(!deque.wait_for_and_pop_front(item, 10ms));
+  REQUIRE(!deque.wait_until_and_pop_back(item, std::chrono::steady_clock::now() + 1ms));
+
+  deque.push_back(1);
+  deque.push_back(2);
+  deque.push_back(3);
+  REQUIRE(deque.wait_for_and_pop_back(item, 10ms));
+  REQUIRE(item == 3);
+  REQUIRE(deque.wait_until_and_pop_front(item, std::chrono::steady_clock::now() + 10ms));
+  REQUIRE(item == 1);
+
+  std::vector<int> batch;
+  REQUIRE(deque.wait_for_and_pop_front_batch(std::back_inserter(batch), 2, 2, 10ms) == 1);
+  REQUIRE(batch == std::vector<int>{2});
+
+  std::stop_source stop;
+  bool popped = true;
+  std::thread consumer([&] { popped = deque.wait_and_pop_front(item, stop.get_token()); });
+  std::this_thread::sleep_for(10ms);
+  stop.request_stop();
+  consumer.join();
+  REQUIRE(!popped);
+}
+
+TEST_CASE("QueueSafe overflow policies", "[QueueSafe]") {
+  using cppsl::container::OverflowPolicy;
+
+  SECTION("dropNewest") {
+    cppsl::container::QueueSafe<int> queue(2, OverflowPolicy::dropNewest);
+    REQUIRE(queue.push(1));
+    REQUIRE(queue.push(2));
+    REQUIRE(!queue.push(3));
+    REQUIRE(queue.size() == 2);
+    REQUIRE(*queue.try_pop_value() == 1);
+    REQUIRE(queue.overflow_counters().dropped == 1);
+  }
+
+  SECTION("dropOldest") {
+    cppsl::container::QueueSafe<int> queue(2, OverflowPolicy::dropOldest);
+    REQUIRE(queue.push(1));
+    REQUIRE(queue.push(2));
+    REQUIRE(queue.push(3));
+    REQUIRE(queue.size() == 2);
+    REQUIRE(*queue.try_pop_value() == 2);
+    REQUIRE(queue.overflow_counters().dropped == 1);
+  }
+
+  SECTION("fail") {
+    cppsl::container::QueueSafe<int> queue(1, OverflowPolicy::fail);
+    REQUIRE(queue.emplace(1));
+    REQUIRE(!queue.emplace(2));
+    REQUIRE(queue.overflow_counters().rejected == 1);
+  }
+
+  SECTION("block") {
+    using namespace std::chrono_literals;
+    cppsl::container::QueueSafe<int> queue(1);
+    REQUIRE(queue.capacity() == 1);
+    REQUIRE(queue.push(1));
+
+    bool pushed = false;
+    std::thread producer([&] { pushed = queue.push(2); });
+    while (queue.overflow_counters().blocked == 0) {
+      std::this_thread::sleep_for(1ms);
+    }
+    REQUIRE(*queue.try_pop_value() == 1);
+    producer.join();
+    REQUIRE(pushed);
+    REQUIRE(*queue.try_pop_value() == 2);
+
+    std::stop_source stop;
+    REQUIRE(queue.push(3));
+    std::thread stopped([&] { pushed = queue.push(4, stop.get_token()); });
+    while (queue.overflow_counters().blocked == 1) {
+      std::this_thread::sleep_for(1ms);
+    }
+    stop.request_stop();
+    stopped.join();
+    REQUIRE(!pushed);
+    REQUIRE(queue.overflow_counters().rejected == 1);
+  }
+}
+
+TEST_CASE("DequeSafe overflow policies", "[DequeSafe]") {
+  using cppsl::container::OverflowPolicy;
+
+  SECTION("dropOldest drops at the opposite end") {
+    cppsl::container::DequeSafe<int> deque(2, OverflowPolicy::dropOldest);
+    REQUIRE(deque.push_back(1));
+    REQUIRE(deque.push_back(2));
+    REQUIRE(deque.push_back(3));
+    REQUIRE(*deque.try_pop_front_value() == 2);
+    REQUIRE(deque.push_front(0));
+    REQUIRE(deque.push_front(-1));
+    REQUIRE(*deque.try_pop_back_value() == 0);
+    REQUIRE(deque.overflow_counters().dropped == 2);
+  }
+
+  SECTION("block") {
+    using namespace std::chrono_literals;
+    cppsl::container::DequeSafe<int> deque(2);
+    REQUIRE(deque.push_back(1));
+    REQUIRE(deque.push_back(2));
+
+    bool pushed = false;
+    std::thread producer([&] { pushed = deque.emplace_back(3); });
+    while (deque.overflow_counters().blocked == 0) {
+      std::this_thread::sleep_for(1ms);
+    }
+    std::vector<int> drained;
+    deque.pop_all(std::back_inserter(drained));
+    producer.join();
+    REQUIRE(pushed);
+    REQUIRE(drained == std::vector<int>{1, 2});
+    REQUIRE(*deque.try_pop_front_value() == 3);
+  }
+}
+
+TEST_CASE("DequeWorkStealing owner and thief ends", "[DequeWorkStealing]") {
+  cppsl::container::DequeWorkStealing<int> deque(2);
+  REQUIRE(deque.empty());
+  REQUIRE(!deque.pop());
+  REQUIRE(!deque.steal());
+
+  for (int i = 0; i < 10; ++i) {
+    deque.push(i);
+  }
+  REQUIRE(deque.size() == 10);
+  REQUIRE(deque.capacity() >= 10);
+
+  REQUIRE(*deque.pop() == 9);
+  REQUIRE(*deque.steal() == 0);
+  REQUIRE(*deque.steal() == 1);
+  REQUIRE(*deque.pop() == 8);
+  REQUIRE(deque.size() == 6);
+}
+
+TEST_CASE("DequeWorkStealing concurrent steal", "[DequeWorkStealing]") {
+  constexpr int count = 20000;
+  cppsl::container::DequeWorkStealing<int> deque(16);
+  std::vector<int> seen(count, 0);
+  std::atomic<bool> done{false};
+  std::atomic<int> taken{0};
+
+  auto thief = [&] {
+    while (!done.load() || !deque.empty()) {
+      if (auto value = deque.steal()) {
+        ++seen[*value];
+        ++taken;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  };
+  std::thread thief1(thief);
+  std::thread thief2(thief);
+
+  for (int i = 0; i < count; ++i) {
+    deque.push(i);
+    if (i % 3 == 0) {
+      if (auto value = deque.pop()) {
+        ++seen[*value];
+        ++taken;
+      }
+    }
+  }
+  while (auto value = deque.pop()) {
+    ++seen[*value];
+    ++taken;
+  }
+  done.store(true);
+  thief1.join();
+  thief2.join();
+
+  REQUIRE(taken.load() == count);
+  REQUIRE(std::all_of(seen.begin(), seen.end(), [](int n) { return n == 1; }));
+}
+
+TEST_CASE("ListReadMostly with std::string", "[ListReadMostly]") {
+  cppsl::container::ListReadMostly<std::string> list;
+  REQUIRE(list.empty());
+
+  list.push_front("one");
+  list.push_front("two");
+  list.emplace_front(3, 'x');
+  REQUIRE(!list.empty());
+
+  std::vector<std::string> items;
+  list.for_each([&items](const std::string& item) { items.push_back(item); });
+  REQUIRE(items == std::vector<std::string>{"xxx", "two", "one"});
+
+  auto found = list.find_first_if([](const std::string& item) { return item.size() == 3 && item[0] == 't'; });
+  REQUIRE(found);
+  REQUIRE(*found == "two");
+  REQUIRE(!list.find_first_if([](const std::string& item) { return item.empty(); }));
+
+  REQUIRE(list.remove_if([](const std::string& item) { return item[0] != 'x'; }) == 2);
+  items.clear();
+  list.for_each([&items](const std::string& item) { items.push_back(item); });
+  REQUIRE(items == std::vector<std::string>{"xxx"});
+
+  list.clean();
+  REQUIRE(list.empty());
+}
+
+TEST_CASE("ListReadMostly readers during removal", "[ListReadMostly]") {
+  cppsl::container::ListReadMostly<std::vector<int>> list;
+  std::atomic<bool> done{false};
+  std::atomic<bool> consistent{true};
+
+  auto reader = [&] {
+    while (!done.load()) {
+      list.for_each([&](const std::vector<int>& item) {
+        if (item.size() != 8 || item.front() != item.back()) {
+          consistent = false;
+        }
+      });
+    }
+  };
+  std::thread reader1(reader);
+  std::thread reader2(reader);
+
+  for (int round = 0; round < 200; ++round) {
+    for (int i = 0; i < 10; ++i) {
+      list.emplace_front(8, round * 10 + i);
+    }
+    list.remove_if([round](const std::vector<int>& item) { return item.front() % 2 == round % 2; });
+  }
+  done.store(true);
+  reader1.join();
+  reader2.join();
+  REQUIRE(consistent.load());
+}
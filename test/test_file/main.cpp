@@ -0,0 +1,488 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cppsl/file/fileAsyncAppender.hpp"
+#include "cppsl/file/fileMappedAppender.hpp"
+#include "cppsl/file/fileRollAppender.hpp"
+
+using namespace cppsl::file;
+
+namespace {
+
+/// temporary directory, removed at the end of the test
+class TempDir {
+ public:
+  TempDir() : m_path(std::filesystem::temp_directory_path() / ("cppsl_test_file_" + std::to_string(getpid()))) {
+    std::filesystem::remove_all(m_path);
+    std::filesystem::create_directories(m_path);
+  }
+  ~TempDir() { std::filesystem::remove_all(m_path); }
+
+  [[nodiscard]] std::filesystem::path file(const std::string& name) const { return m_path / name; }
+
+ private:
+  std::filesystem::path m_path;
+};
+
+/// reads all lines of a file
+std::vector<std::string> readLines(const std::filesystem::path& path) {
+  std::vector<std::string> lines;
+  std::ifstream in(path);
+  for (std::string line; std::getline(in, line);) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+/// appender whose first write waits until the gate opens
+class GatedAppender : public FileBaseAppender {
+ public:
+  using FileBaseAppender::FileBaseAppender;
+
+  bool writeMessage(std::string_view message) override {
+    if (!m_passed) {
+      m_passed = true;
+      m_entered.set_value();
+      m_gate.get_future().wait();
+    }
+    return FileBaseAppender::writeMessage(message);
+  }
+
+  std::promise<void> m_entered;
+  std::promise<void> m_gate;
+  bool m_passed{false};
+};
+
+/// appender keeping the written blocks in memory
+class RecordingAppender : public FileBaseAppender {
+ public:
+  using FileBaseAppender::FileBaseAppender;
+
+  bool writeMessage(std::string_view message) override {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_content.append(message);
+    return true;
+  }
+
+  bool contains(const std::string& message) {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_content.find(message) != std::string::npos;
+  }
+
+ private:
+  std::mutex m_mutex;
+  std::string m_content;
+};
+
+}   // namespace
+
+TEST_CASE("FileAsyncAppender drains all messages on destruction", "[FileAsyncAppender]") {
+  TempDir dir;
+  const auto path = dir.file("async.log");
+  constexpr int producers = 4;
+  constexpr int perProducer = 2000;
+
+  size_t writes = 0;
+  {
+    FileAsyncConfig config;
+    config.queueCapacity = 256;
+    config.blockSize = 16 * 1024;
+    FileAsyncAppender appender(std::make_shared<FileBaseAppender>(path, false), config);
+
+    std::atomic<int> accepted{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+      threads.emplace_back([&appender, &accepted, p] {
+        for (int i = 0; i < perProducer; ++i) {
+          if (appender.writeMessage("producer " + std::to_string(p) + " message " + std::to_string(i) + "\n")) {
+            ++accepted;
+          }
+        }
+      });
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    REQUIRE(accepted == producers * perProducer);
+    REQUIRE(appender.counters().dropped == 0);
+    writes = appender.writes();
+  }
+
+  const auto lines = readLines(path);
+  REQUIRE(lines.size() == producers * perProducer);
+  const std::set<std::string> unique(lines.begin(), lines.end());
+  REQUIRE(unique.size() == lines.size());
+  REQUIRE(writes < lines.size());
+}
+
+TEST_CASE("FileAsyncAppender coalesces and flushes", "[FileAsyncAppender]") {
+  TempDir dir;
+  const auto path = dir.file("flush.log");
+  FileAsyncConfig config;
+  config.flushInterval = std::chrono::hours(1);
+  FileAsyncAppender appender(std::make_shared<FileBaseAppender>(path, false), config);
+
+  for (int i = 0; i < 100; ++i) {
+    REQUIRE(appender.writeMessage("line " + std::to_string(i) + "\n"));
+  }
+  appender.flush();
+  const auto lines = readLines(path);
+  REQUIRE(lines.size() == 100);
+  REQUIRE(lines.front() == "line 0");
+  REQUIRE(lines.back() == "line 99");
+  REQUIRE(appender.writes() <= 100);
+
+  SECTION("flush without new messages returns at once") {
+    appender.flush();
+    REQUIRE(readLines(path).size() == 100);
+  }
+}
+
+TEST_CASE("FileAsyncAppender flush waits for the messages of concurrent producers", "[FileAsyncAppender]") {
+  using cppsl::container::OverflowPolicy;
+  TempDir dir;
+  auto target = std::make_shared<RecordingAppender>(dir.file("concurrent.log"), false);
+  constexpr int producers = 4;
+  constexpr int perProducer = 300;
+
+  FileAsyncConfig config;
+  config.queueCapacity = 8;
+  config.flushInterval = std::chrono::hours(1);
+  // rejected messages give their tickets back, flush() must not wait for them
+  config.policy = GENERATE(OverflowPolicy::block, OverflowPolicy::dropNewest);
+  FileAsyncAppender appender(target, config);
+
+  std::atomic<int> missing{0};
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p] {
+      for (int i = 0; i < perProducer; ++i) {
+        const auto message = "<" + std::to_string(p) + ":" + std::to_string(i) + ">";
+        if (appender.writeMessage(message)) {
+          appender.flush();
+          missing += target->contains(message) ? 0 : 1;
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  REQUIRE(missing == 0);
+}
+
+TEST_CASE("FileAsyncAppender applies the overflow policy", "[FileAsyncAppender]") {
+  using cppsl::container::OverflowPolicy;
+  TempDir dir;
+  const auto path = dir.file("policy.log");
+  auto target = std::make_shared<GatedAppender>(path, false);
+
+  FileAsyncConfig config;
+  config.queueCapacity = 4;
+  config.flushInterval = std::chrono::milliseconds(0);
+
+  SECTION("fail rejects while the writer is stuck") {
+    config.policy = OverflowPolicy::fail;
+    FileAsyncAppender appender(target, config);
+    REQUIRE(appender.writeMessage("first\n"));
+    target->m_entered.get_future().wait();
+
+    size_t accepted = 0;
+    for (int i = 0; i < 10; ++i) {
+      accepted += appender.writeMessage("queued\n") ? 1 : 0;
+    }
+    REQUIRE(accepted == 4);
+    REQUIRE(appender.counters().rejected == 6);
+    target->m_gate.set_value();
+    appender.flush();
+    REQUIRE(readLines(path).size() == 5);
+  }
+
+  SECTION("dropOldest keeps the newest messages") {
+    config.policy = OverflowPolicy::dropOldest;
+    FileAsyncAppender appender(target, config);
+    REQUIRE(appender.writeMessage("first\n"));
+    target->m_entered.get_future().wait();
+
+    for (int i = 0; i < 10; ++i) {
+      REQUIRE(appender.writeMessage("message " + std::to_string(i) + "\n"));
+    }
+    REQUIRE(appender.counters().dropped == 6);
+    target->m_gate.set_value();
+    appender.flush();
+    const auto lines = readLines(path);
+    REQUIRE(lines.size() == 5);
+    REQUIRE(lines[1] == "message 6");
+    REQUIRE(lines[4] == "message 9");
+  }
+
+  SECTION("block waits for room") {
+    config.policy = OverflowPolicy::block;
+    FileAsyncAppender appender(target, config);
+    REQUIRE(appender.writeMessage("first\n"));
+    target->m_entered.get_future().wait();
+
+    std::atomic<int> accepted{0};
+    std::thread producer([&appender, &accepted] {
+      for (int i = 0; i < 10; ++i) {
+        accepted += appender.writeMessage("message " + std::to_string(i) + "\n") ? 1 : 0;
+      }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    target->m_gate.set_value();
+    producer.join();
+    REQUIRE(accepted == 10);
+    appender.flush();
+    REQUIRE(appender.counters().blocked >= 1);
+    REQUIRE(readLines(path).size() == 11);
+  }
+}
+
+TEST_CASE("FileAsyncAppender rolls over between whole messages", "[FileAsyncAppender]") {
+  TempDir dir;
+  const auto path = dir.file("roll.log");
+  {
+    FileAsyncConfig config;
+    config.blockSize = 256;
+    FileAsyncAppender appender(std::make_shared<FileRollAppender>(path, 1024, 3, false), config);
+    for (int i = 0; i < 200; ++i) {
+      REQUIRE(appender.writeMessage("rolling message " + std::to_string(i) + "\n"));
+    }
+  }
+
+  size_t total = 0;
+  for (const auto& name : {"roll.log", "roll.log.1", "roll.log.2", "roll.log.3"}) {
+    for (const auto& line : readLines(dir.file(name))) {
+      REQUIRE(line.rfind("rolling message ", 0) == 0);
+      ++total;
+    }
+  }
+  REQUIRE(total > 0);
+  REQUIRE(std::filesystem::exists(dir.file("roll.log.1")));
+}
+
+TEST_CASE("FileRollAppender counts bytes and archives in the background", "[FileRollAppender]") {
+  TempDir dir;
+  const auto path = dir.file("count.log");
+  const std::string line = "0123456789abcdef\n";   // 17 bytes
+
+  FileRollAppender appender(path, 10 * line.size(), 3, false);
+  for (int i = 0; i < 25; ++i) {
+    REQUIRE(appender.writeMessage(line));
+  }
+  REQUIRE(appender.getWrittenSize() == 5 * line.size());
+  appender.waitRollOver();
+  REQUIRE(appender.flush());
+
+  REQUIRE(readLines(path).size() == 5);
+  REQUIRE(readLines(dir.file("count.log.1")).size() == 10);
+  REQUIRE(readLines(dir.file("count.log.2")).size() == 10);
+  REQUIRE_FALSE(std::filesystem::exists(dir.file("count.log.3")));
+
+  SECTION("the oldest backup is pruned") {
+    for (int i = 0; i < 25; ++i) {
+      REQUIRE(appender.writeMessage(line));
+    }
+    appender.waitRollOver();
+    REQUIRE(std::filesystem::exists(dir.file("count.log.3")));
+    REQUIRE_FALSE(std::filesystem::exists(dir.file("count.log.4")));
+    REQUIRE(appender.getWrittenSize() == 0);
+  }
+
+  SECTION("backups are compressed by the hook") {
+    appender.setCompressor(
+       [](const std::filesystem::path& src, const std::filesystem::path& dst) {
+         return std::filesystem::copy_file(src, dst);
+       },
+       ".z");
+    for (int i = 0; i < 5; ++i) {
+      REQUIRE(appender.writeMessage(line));
+    }
+    appender.waitRollOver();
+    REQUIRE(readLines(dir.file("count.log.1.z")).size() == 10);
+    for (const auto& entry : std::filesystem::directory_iterator(path.parent_path())) {
+      REQUIRE(entry.path().string().find(".rolling.") == std::string::npos);
+    }
+  }
+}
+
+TEST_CASE("FileRollAppender counts the size of an existing file", "[FileRollAppender]") {
+  TempDir dir;
+  const auto path = dir.file("a.log");
+  const auto mode = std::ios_base::in | std::ios_base::out | std::ios_base::app;
+  std::ofstream(path) << std::string(99, 'x') << '\n';
+  REQUIRE(std::filesystem::file_size(path) == 100);
+
+  FileRollAppender appender(path, 150, 3, true, mode);
+  REQUIRE(appender.getWrittenSize() == 100);
+  REQUIRE(appender.writeMessage(std::string(59, 'y') + '\n'));
+  appender.waitRollOver();
+  REQUIRE(appender.getRollCount() == 1);
+  REQUIRE(appender.getWrittenSize() == 0);
+  REQUIRE(std::filesystem::file_size(dir.file("a.log.1")) == 160);
+
+  SECTION("after a reopen") {
+    REQUIRE(appender.writeMessage(std::string(99, 'z') + '\n'));
+    REQUIRE(appender.flush());
+    REQUIRE(appender.reopenFile());
+    REQUIRE(appender.getWrittenSize() == 100);
+    REQUIRE(appender.writeMessage(std::string(59, 'y') + '\n'));
+    appender.waitRollOver();
+    REQUIRE(appender.getRollCount() == 2);
+  }
+}
+
+TEST_CASE("FileRollAppender archives the staged files of a former run", "[FileRollAppender]") {
+  TempDir dir;
+  const auto path = dir.file("crash.log");
+  {
+    // a former run used the same counter values, its staging names must not clash
+    std::ofstream(dir.file("crash.log.rolling.0")) << "older\n";
+    std::ofstream(dir.file("crash.log.rolling.1")) << "newer\n";
+    std::filesystem::last_write_time(dir.file("crash.log.rolling.0"),
+                                     std::filesystem::file_time_type::clock::now() - std::chrono::seconds(10));
+  }
+
+  FileRollAppender appender(path, 10, 3, false);
+  appender.waitRollOver();
+  REQUIRE(readLines(dir.file("crash.log.1")) == std::vector<std::string>{"newer"});
+  REQUIRE(readLines(dir.file("crash.log.2")) == std::vector<std::string>{"older"});
+
+  REQUIRE(appender.writeMessage("0123456789abcdef\n"));
+  appender.waitRollOver();
+  REQUIRE(readLines(dir.file("crash.log.1")).size() == 1);
+  REQUIRE(readLines(dir.file("crash.log.2")) == std::vector<std::string>{"newer"});
+  REQUIRE(readLines(dir.file("crash.log.3")) == std::vector<std::string>{"older"});
+  for (const auto& entry : std::filesystem::directory_iterator(path.parent_path())) {
+    REQUIRE(entry.path().string().find(".rolling.") == std::string::npos);
+  }
+}
+
+TEST_CASE("FileMappedAppender writes into mapped segments", "[FileMappedAppender]") {
+  TempDir dir;
+  const auto path = dir.file("mapped.log");
+  const std::string line = "0123456789abcdef\n";   // 17 bytes
+
+  SECTION("segments are truncated to their messages") {
+    {
+      FileMappedAppender appender(path, 10 * line.size() + 5, 3, false);
+      REQUIRE(appender.isMapped());
+      REQUIRE(std::filesystem::file_size(path) == 10 * line.size() + 5);
+      for (int i = 0; i < 25; ++i) {
+        REQUIRE(appender.writeMessage(line));
+      }
+      REQUIRE(appender.flush());
+      REQUIRE(appender.getWrittenSize() == 5 * line.size());
+      REQUIRE_FALSE(appender.writeMessage(std::string(1000, 'x')));
+    }
+    REQUIRE(std::filesystem::file_size(path) == 5 * line.size());
+    REQUIRE(std::filesystem::file_size(dir.file("mapped.log.1")) == 10 * line.size());
+    REQUIRE(readLines(dir.file("mapped.log.2")).size() == 10);
+    REQUIRE(readLines(path).front() == "0123456789abcdef");
+  }
+
+  SECTION("concurrent writers lose no message") {
+    constexpr int producers = 4;
+    constexpr int perProducer = 5000;
+    std::atomic<int> accepted{0};
+    {
+      FileMappedAppender appender(path, 64 * 1024, 20, false);
+      std::vector<std::thread> threads;
+      for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&appender, &accepted, p] {
+          for (int i = 0; i < perProducer; ++i) {
+            if (appender.writeMessage("producer " + std::to_string(p) + " message " + std::to_string(i) + "\n")) {
+              ++accepted;
+            }
+          }
+        });
+      }
+      for (auto& t : threads) {
+        t.join();
+      }
+    }
+    REQUIRE(accepted == producers * perProducer);
+
+    std::set<std::string> unique;
+    size_t total = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(path.parent_path())) {
+      for (const auto& l : readLines(entry.path())) {
+        REQUIRE(l.rfind("producer ", 0) == 0);
+        unique.insert(l);
+        ++total;
+      }
+    }
+    REQUIRE(total == producers * perProducer);
+    REQUIRE(unique.size() == total);
+  }
+
+  SECTION("a failed mapping is retried by the next write") {
+    {
+      // the preallocation exceeds the file size limit of the file system
+      FileMappedAppender appender(path, size_t{1} << 50, 3, false);
+      REQUIRE_FALSE(appender.isMapped());
+      REQUIRE_FALSE(std::filesystem::exists(path));
+      REQUIRE_FALSE(appender.writeMessage(line));
+      appender.rollOver();
+      REQUIRE_FALSE(appender.reopenFile());
+
+      appender.setMaximumFileSize(1024);
+      REQUIRE(appender.writeMessage(line));
+      REQUIRE(appender.isMapped());
+      REQUIRE(appender.getWrittenSize() == line.size());
+    }
+    REQUIRE(readLines(path) == std::vector<std::string>{"0123456789abcdef"});
+    REQUIRE_FALSE(std::filesystem::exists(dir.file("mapped.log.1")));
+  }
+
+  SECTION("the next segment is prepared in the background") {
+    const auto spares = [&dir] {
+      std::vector<std::filesystem::path> found;
+      for (const auto& entry : std::filesystem::directory_iterator(dir.file(""))) {
+        if (entry.path().filename().string().rfind("mapped.log.spare.", 0) == 0) {
+          found.push_back(entry.path());
+        }
+      }
+      return found;
+    };
+    { std::ofstream(dir.file("mapped.log.spare.1-2.0")) << "left by a crash\n"; }
+    {
+      FileMappedAppender appender(path, 1024, 3, false);
+      appender.waitRollOver();
+      auto spare = spares();
+      REQUIRE(spare.size() == 1);
+      REQUIRE(std::filesystem::file_size(spare.front()) == 1024);
+
+      REQUIRE(appender.writeMessage(line));
+      appender.rollOver();
+      REQUIRE_FALSE(std::filesystem::exists(spare.front()));
+      REQUIRE(appender.writeMessage(line));
+      appender.waitRollOver();
+      REQUIRE(spares().size() == 1);
+    }
+    REQUIRE(spares().empty());
+    REQUIRE(readLines(path) == std::vector<std::string>{"0123456789abcdef"});
+    REQUIRE(readLines(dir.file("mapped.log.1")) == std::vector<std::string>{"0123456789abcdef"});
+  }
+
+  SECTION("an existing file is kept as backup") {
+    { std::ofstream(path) << "old content\n"; }
+    {
+      FileMappedAppender appender(path, 1024, 3, true);
+      REQUIRE(appender.writeMessage(line));
+    }
+    REQUIRE(readLines(dir.file("mapped.log.1")) == std::vector<std::string>{"old content"});
+    REQUIRE(readLines(path) == std::vector<std::string>{"0123456789abcdef"});
+  }
+}
@@ -0,0 +1,389 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <spdlog/logger.h>
+#include "cppsl/log/details/fallback_sink.hpp"
+#include "cppsl/log/details/rsyslog_sink.hpp"
+#include "cppsl/file/fileMappedAppender.hpp"
+#include "cppsl/log/traceLog.hpp"
+
+namespace {
+
+/// UDP server on the loopback interface standing in for rsyslog
+class UdpReceiver {
+ public:
+  UdpReceiver() {
+    m_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(m_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(m_fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    m_port = ntohs(addr.sin_port);
+    timeval timeout{1, 0};
+    setsockopt(m_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  }
+  ~UdpReceiver() { close(m_fd); }
+
+  [[nodiscard]] uint16_t port() const { return m_port; }
+
+  /// receives one datagram, empty on timeout
+  std::string receive() {
+    char buf[2048];
+    const auto n = recv(m_fd, buf, sizeof(buf), 0);
+    return n > 0 ? std::string(buf, static_cast<size_t>(n)) : std::string();
+  }
+
+ private:
+  int m_fd{-1};
+  uint16_t m_port{0};
+};
+
+/// sink recording its messages that throws while it is broken, like many sinks its flush never fails
+class TierSink : public spdlog::sinks::base_sink<std::mutex> {
+ public:
+  std::atomic<bool> broken{false};
+  std::atomic<int> messages{0};
+
+ protected:
+  void sink_it_(const spdlog::details::log_msg&) override {
+    if (broken) {
+      throw std::runtime_error("sink broken");
+    }
+    ++messages;
+  }
+  void flush_() override {}
+};
+
+}   // namespace
+
+TEST_CASE("rsyslog_sink sends one datagram per message", "[rsyslog_sink]") {
+  UdpReceiver server;
+  auto sink = std::make_shared<spdlog::sinks::rsyslog_sink_st>("app", "127.0.0.1", LOG_USER, 1024, server.port(), false);
+  spdlog::logger logger("test", sink);
+  logger.set_level(spdlog::level::trace);
+
+  logger.info("hello");
+  logger.error("failed {}", 42);
+  logger.trace("details");
+  REQUIRE(server.receive() == "<14>app: hello");
+  REQUIRE(server.receive() == "<11>app: failed 42");
+  REQUIRE(server.receive() == "<15>app: details");
+  REQUIRE(sink->counters().sent == 3);
+
+  SECTION("long messages are truncated to the buffer size") {
+    logger.warn(std::string(2000, 'x'));
+    REQUIRE(server.receive().size() == 1024);
+  }
+
+  SECTION("messages are capped at the UDP datagram size") {
+    auto large = std::make_shared<spdlog::sinks::rsyslog_sink_st>("app", "127.0.0.1", LOG_USER, 16 * 1024 * 1024,
+                                                                  server.port(), false);
+    spdlog::logger other("large", large);
+    other.info(std::string(100000, 'x'));
+    REQUIRE(large->counters().sent == 1);
+    REQUIRE(large->counters().dropped == 0);
+  }
+}
+
+TEST_CASE("rsyslog_sink batches messages", "[rsyslog_sink]") {
+  UdpReceiver server;
+  spdlog::sinks::rsyslog_batch_config batch;
+  batch.max_messages = 4;
+  batch.max_delay = std::chrono::hours(1);
+  auto sink =
+     std::make_shared<spdlog::sinks::rsyslog_sink_st>("app", "127.0.0.1", LOG_USER, 1024, server.port(), false, batch);
+  spdlog::logger logger("test", sink);
+
+  for (int i = 0; i < 10; ++i) {
+    logger.info("message {}", i);
+  }
+  // two full batches are sent, two messages wait
+  REQUIRE(sink->counters().sent == 8);
+  logger.flush();
+  REQUIRE(sink->counters().sent == 10);
+  for (int i = 0; i < 10; ++i) {
+    REQUIRE(server.receive() == "<14>app: message " + std::to_string(i));
+  }
+
+  SECTION("size threshold") {
+    batch.max_messages = 100;
+    batch.max_bytes = 64;
+    auto small =
+       std::make_shared<spdlog::sinks::rsyslog_sink_st>("app", "127.0.0.1", LOG_USER, 1024, server.port(), false, batch);
+    spdlog::logger other("small", small);
+    for (int i = 0; i < 6; ++i) {
+      other.info("0123456789012345");
+    }
+    // 25 bytes per message, a third one would exceed 64 bytes
+    REQUIRE(small->counters().sent == 4);
+  }
+
+  SECTION("age threshold") {
+    batch.max_messages = 100;
+    batch.max_delay = std::chrono::milliseconds(20);
+    auto aged =
+       std::make_shared<spdlog::sinks::rsyslog_sink_st>("app", "127.0.0.1", LOG_USER, 1024, server.port(), false, batch);
+    spdlog::logger other("aged", aged);
+    other.info("first");
+    REQUIRE(aged->counters().sent == 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    other.info("second");
+    REQUIRE(aged->counters().sent == 2);
+  }
+}
+
+TEST_CASE("trace log writes binary events and renders them offline", "[traceLog]") {
+  using namespace cppsl::log;
+  const auto dir = std::filesystem::temp_directory_path() / ("cppsl_trace_" + std::to_string(getpid()));
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  const auto path = dir / "trace.log";
+
+  static const TraceFormat<int, double, const char*> sample{"sample {} value {:.2f} from {}"};
+  static const TraceFormat<uint16_t, bool, char> flags{"flags {:#06x} {} {}"};
+  static const TraceFormat<> tick{"tick"};
+  {
+    cppsl::file::FileRollAppender appender(path, 1024, 5, false);
+    TraceWriter writer(appender);
+    REQUIRE(writer.write(sample, 1, 0.5, "sv"));
+    REQUIRE(writer.write(flags, 0x2a, true, 'x'));
+    for (int i = 0; i < 100; ++i) {
+      REQUIRE(writer.write(sample, i, i * 0.25, std::string("merging unit")));
+      REQUIRE(writer.write(tick));
+    }
+    REQUIRE(appender.getRollCount() > 0);
+  }
+
+  std::vector<std::string> texts;
+  std::vector<int64_t> stamps;
+  TraceReader reader;
+  for (const auto& name : {"trace.log.5", "trace.log.4", "trace.log.3", "trace.log.2", "trace.log.1", "trace.log"}) {
+    std::ifstream in(dir / name, std::ios::binary);
+    const std::vector<char> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const auto bytes = std::as_bytes(std::span(content));
+    REQUIRE(reader.decode(bytes, [&](const TraceEvent& event) {
+      texts.push_back(event.text);
+      stamps.push_back(event.steady);
+    }) == bytes.size());
+  }
+  REQUIRE(reader.errors() == 0);
+  REQUIRE(std::is_sorted(stamps.begin(), stamps.end()));
+  REQUIRE(texts.back() == "tick");
+  REQUIRE(std::find(texts.begin(), texts.end(), "sample 99 value 24.75 from merging unit") != texts.end());
+
+  SECTION("every file carries its definitions") {
+    TraceReader fresh;
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<char> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    fresh.decode(std::as_bytes(std::span(content)), [](const TraceEvent&) {});
+    REQUIRE(fresh.errors() == 0);
+  }
+
+  SECTION("the zero tail of a mapped segment ends the data") {
+    std::vector<std::byte> data(64, std::byte{0});
+    REQUIRE(reader.decode(data, [](const TraceEvent&) {}) == 0);
+  }
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("trace log decodes any byte of a bool", "[traceLog]") {
+  using namespace cppsl::log;
+  const auto dir = std::filesystem::temp_directory_path() / ("cppsl_trace_bool_" + std::to_string(getpid()));
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+  const auto path = dir / "trace.log";
+
+  static const TraceFormat<bool, char> flag{"flag {} {}"};
+  {
+    cppsl::file::FileRollAppender appender(path, 1024, 1, false);
+    TraceWriter writer(appender);
+    REQUIRE(writer.write(flag, false, 'x'));
+  }
+
+  std::ifstream in(path, std::ios::binary);
+  std::vector<char> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  // the event is last in the file, its bool is the byte before the char
+  const std::array<char, 2> encoded{0, 'x'};
+  const auto it = std::find_end(content.begin(), content.end(), encoded.begin(), encoded.end());
+  REQUIRE(it != content.end());
+  *it = 0x7f;
+
+  std::vector<std::string> texts;
+  TraceReader reader;
+  const auto bytes = std::as_bytes(std::span(content));
+  REQUIRE(reader.decode(bytes, [&](const TraceEvent& event) { texts.push_back(event.text); }) == bytes.size());
+  REQUIRE(reader.errors() == 0);
+  REQUIRE(texts == std::vector<std::string>{"flag true x"});
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("trace log decodes every segment of a FileMappedAppender", "[traceLog]") {
+  using namespace cppsl::log;
+  const auto dir = std::filesystem::temp_directory_path() / ("cppsl_trace_mapped_" + std::to_string(getpid()));
+  std::filesystem::remove_all(dir);
+  std::filesystem::create_directories(dir);
+
+  static const TraceFormat<int, const char*> sample{"sample {} from {}"};
+  static const TraceFormat<> tick{"tick"};
+  constexpr int events = 200;
+  {
+    // the segment rolls over before the record that does not fit lands
+    cppsl::file::FileMappedAppender appender(dir / "trace.log", 256, 99, false);
+    TraceWriter writer(appender);
+    for (int i = 0; i < events / 2; ++i) {
+      REQUIRE(writer.write(sample, i, "merging unit"));
+      REQUIRE(writer.write(tick));
+    }
+    REQUIRE(appender.getRollCount() > 10);
+  }
+
+  // every segment carries the definitions of its events
+  size_t decoded = 0;
+  std::vector<char> last;
+  for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+    std::ifstream in(entry.path(), std::ios::binary);
+    last.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    const auto bytes = std::as_bytes(std::span(last));
+    TraceReader fresh;
+    REQUIRE(fresh.decode(bytes, [&](const TraceEvent&) { ++decoded; }) == bytes.size());
+    REQUIRE(fresh.errors() == 0);
+  }
+  REQUIRE(decoded == events);
+
+  // an event of unknown format is skipped by its length
+  std::vector<std::byte> data{std::byte{3}, std::byte{12}, std::byte{0}, std::byte{0}, std::byte{0}};
+  data.resize(data.size() + 12, std::byte{0xff});
+  const auto bytes = std::as_bytes(std::span(last));
+  data.insert(data.end(), bytes.begin(), bytes.end());
+  TraceReader reader;
+  size_t rendered = 0;
+  REQUIRE(reader.decode(data, [&](const TraceEvent&) { ++rendered; }) == data.size());
+  REQUIRE(reader.errors() == 1);
+  REQUIRE(rendered > 0);
+  std::filesystem::remove_all(dir);
+}
+
+TEST_CASE("fallback_sink fails over and back", "[fallback_sink]") {
+  auto primary = std::make_shared<TierSink>();
+  auto secondary = std::make_shared<TierSink>();
+  auto sink = std::make_shared<spdlog::sinks::fallback_sink>(std::chrono::milliseconds(10));
+  sink->add_sink(primary);
+  sink->add_sink(secondary);
+  spdlog::logger logger("fallback", sink);
+
+  logger.info("one");
+  REQUIRE(primary->messages == 1);
+  REQUIRE(sink->healthy_index() == 0);
+
+  primary->broken = true;
+  logger.info("two");
+  logger.info("three");
+  REQUIRE(secondary->messages == 2);
+  REQUIRE(sink->healthy_index() == 1);
+  // the healthy index skips the broken sink, only the first message failed over
+  REQUIRE(sink->failovers() == 1);
+
+  // the probe does not fail back to a broken sink whose flush succeeds
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  REQUIRE(sink->healthy_index() == 1);
+
+  // only a message the recovered sink accepts fails back
+  primary->broken = false;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  REQUIRE(sink->healthy_index() == 1);
+  logger.info("four");
+  REQUIRE(primary->messages == 2);
+  REQUIRE(sink->healthy_index() == 0);
+
+  SECTION("removing a missing sink is harmless") {
+    sink->remove_sink(std::make_shared<TierSink>());
+    sink->remove_sink(primary);
+    logger.info("five");
+    REQUIRE(secondary->messages == 3);
+  }
+
+  SECTION("reconfiguration while logging") {
+    std::atomic<bool> done{false};
+    std::atomic<int> logged{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+      threads.emplace_back([&] {
+        while (!done) {
+          logger.info("concurrent");
+          ++logged;
+        }
+      });
+    }
+    for (int i = 0; i < 200; ++i) {
+      auto extra = std::make_shared<TierSink>();
+      sink->add_sink(extra);
+      sink->remove_sink(extra);
+    }
+    done = true;
+    for (auto& t : threads) {
+      t.join();
+    }
+    REQUIRE(primary->messages == 2 + logged);
+  }
+}
+
+TEST_CASE("fallback_sink wraps around to the preferred sinks", "[fallback_sink]") {
+  auto primary = std::make_shared<TierSink>();
+  auto secondary = std::make_shared<TierSink>();
+  auto sink = std::make_shared<spdlog::sinks::fallback_sink>(std::chrono::milliseconds(0));
+  sink->add_sink(primary);
+  sink->add_sink(secondary);
+  spdlog::logger logger("fallback", sink);
+
+  primary->broken = true;
+  logger.info("one");
+  REQUIRE(sink->healthy_index() == 1);
+
+  // the last tier fails after the first one recovered
+  primary->broken = false;
+  secondary->broken = true;
+  logger.info("two");
+  REQUIRE(primary->messages == 1);
+  REQUIRE(sink->healthy_index() == 0);
+  REQUIRE(sink->failovers() == 2);
+}
+
+TEST_CASE("fallback_sink fails back on a probe callback", "[fallback_sink]") {
+  auto primary = std::make_shared<TierSink>();
+  auto secondary = std::make_shared<TierSink>();
+  auto sink = std::make_shared<spdlog::sinks::fallback_sink>(
+     std::chrono::milliseconds(10),
+     [&primary](spdlog::sinks::sink& s) { return &s == primary.get() && !primary->broken; });
+  sink->add_sink(primary);
+  sink->add_sink(secondary);
+  spdlog::logger logger("fallback", sink);
+
+  primary->broken = true;
+  logger.info("one");
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  REQUIRE(sink->healthy_index() == 1);
+
+  primary->broken = false;
+  for (int i = 0; i < 100 && sink->healthy_index() != 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  REQUIRE(sink->healthy_index() == 0);
+  logger.info("two");
+  REQUIRE(primary->messages == 1);
+  REQUIRE(sink->failovers() == 1);
+}
@@ -0,0 +1,622 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include "cppsl/math/constants.hpp"
+#include "cppsl/math/functions.hpp"
+#include "cppsl/math/samplRateConvFIR.hpp"
+#include "cppsl/math/samplRateConvLagrange.hpp"
+#include "cppsl/math/samplRateConvLinear.hpp"
+#include "cppsl/math/samplRateConvMultiChannel.hpp"
+#include "cppsl/math/samplRateConvPolyphase.hpp"
+#include "cppsl/math/samplRateConvRational.hpp"
+#include "cppsl/math/slidingDft.hpp"
+
+namespace {
+
+/// sine of 50 Hz with the given amplitude sampled at rate, in blocks of the given size
+template <typename T>
+std::vector<std::vector<T>> SineBlocks(int rate, size_t blocks, size_t blockSize, double amplitude = 1000.0) {
+  std::vector<std::vector<T>> res(blocks);
+  size_t n = 0;
+  for (auto& block : res) {
+    for (size_t i = 0; i < blockSize; ++i, ++n) {
+      block.push_back(static_cast<T>(amplitude * std::sin(cppsl::math::DSP_2PI * 50.0 * n / rate)));
+    }
+  }
+  return res;
+}
+
+template <typename TConv, typename T>
+std::vector<T> Run(TConv& conv, const std::vector<std::vector<T>>& blocks) {
+  std::vector<T> out;
+  for (auto block : blocks) {
+    conv.Convert(block, out);
+  }
+  return out;
+}
+
+}   // namespace
+
+TEST_CASE("SmpRateConvPolyphase matches SmpRateConvFIR", "[SmpRateConvPolyphase]") {
+  const auto blocks = SineBlocks<double>(4800, 20, 80);
+
+  cppsl::math::SmpRateConvFIR<double> reference(4800, 10000, 64, 16);
+  const auto expected = Run(reference, blocks);
+
+  SECTION("double coefficients") {
+    cppsl::math::SmpRateConvPolyphase<double, double> conv(4800, 10000, 64, 16);
+    const auto out = Run(conv, blocks);
+    REQUIRE(out.size() == expected.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+      REQUIRE(out[i] == Approx(expected[i]).margin(1e-9));
+    }
+  }
+
+  SECTION("float coefficients") {
+    cppsl::math::SmpRateConvPolyphase<double> conv(4800, 10000, 64, 16);
+    const auto out = Run(conv, blocks);
+    REQUIRE(out.size() == expected.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+      REQUIRE(out[i] == Approx(expected[i]).margin(1e-2));
+    }
+  }
+
+  SECTION("odd tap count") {
+    cppsl::math::SmpRateConvFIR<double> reference7(4800, 4000, 32, 7);
+    cppsl::math::SmpRateConvPolyphase<double, double> conv(4800, 4000, 32, 7);
+    const auto ref = Run(reference7, blocks);
+    const auto out = Run(conv, blocks);
+    REQUIRE(out.size() == ref.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+      REQUIRE(out[i] == Approx(ref[i]).margin(1e-9));
+    }
+  }
+}
+
+TEST_CASE("SmpRateConvPolyphase initialization", "[SmpRateConvPolyphase]") {
+  cppsl::math::SmpRateConvPolyphase<int> conv;
+  REQUIRE(!conv.Initialize(4800, 10000, 33, 7));
+  REQUIRE(conv.Initialize(4800, 10000, 32, 7));
+  std::vector<int> empty, out;
+  REQUIRE(conv.Convert(empty, out) == 0);
+}
+
+namespace {
+
+/// feeds the blocks through the span API with a small output span, so conversion stops and resumes
+template <cppsl::math::SampleRateConverter TConv, typename T>
+std::vector<T> RunSpans(TConv& conv, const std::vector<std::vector<T>>& blocks, size_t outChunk) {
+  std::vector<T> out;
+  std::vector<T> chunk(outChunk);
+  for (const auto& block : blocks) {
+    std::span<const T> in(block);
+    const auto bound = conv.maxOutputFor(in.size());
+    size_t produced = 0;
+    while (!in.empty()) {
+      const auto res = conv.Convert(in, std::span<T>(chunk));
+      in = in.subspan(res.consumed);
+      out.insert(out.end(), chunk.begin(), chunk.begin() + res.produced);
+      produced += res.produced;
+    }
+    // flush the outputs that are due without new input
+    const auto res = conv.Convert(std::span<const T>(), std::span<T>(chunk));
+    out.insert(out.end(), chunk.begin(), chunk.begin() + res.produced);
+    produced += res.produced;
+    REQUIRE(produced <= bound);
+  }
+  return out;
+}
+
+/// every baselineStride-th output of the vector API before the span API, on SineBlocks<int>(4800, 10, 96)
+struct BaselineStream {
+  size_t size;                 ///< outputs of the whole stream
+  std::vector<int> samples;    ///< outputs 0, baselineStride, 2 * baselineStride, ...
+};
+
+constexpr size_t baselineStride = 23;
+
+/// SmpRateConvFIR(4800, 10000, 64, 16)
+const BaselineStream baselineFir{1998, {
+      0, 198, 796, 996, 699, 51, -620, -983, -855, -298, 406, 908, 956, 525, -167, -776, -998, -720, -82, 596,
+      977, 870, 328, -377, -894, -964, -552, 135, 756, 999, 741, 114, -570, -970, -885, -357, 348, 881, 972, 578,
+      -104, -735, -999, -762, -144, 544, 962, 899, 386, -318, -866, -979, -603, 73, 714, 997, 783, 176, -517,
+      -953, -912, -415, 289, 849, 985, 628, -42, -692, -995, -801, -207, 491, 943, 924, 444, -258, -832, -990,
+      -652, 10, 669, 992, 820, 237, -463, -933, -936
+}};
+
+/// SmpRateConvFIR(4800, 4000, 64, 16), the polyphase converter did not exist
+const BaselineStream baselinePolyphase{800, {
+      0, 957, 51, -982, 406, 792, -776, -429, 977, -26, -964, 476, 741, -823, -357, 990, -104, -941, 544, 687,
+      -866, -283, 997, -182, -912, 608, 628, -901, -207, 999, -258, -878, 669, 565, -933
+}};
+
+/// SmpRateConvLagrange(4800, 10000, 3)
+const BaselineStream baselineLagrange{1998, {
+      0, 557, 966, 892, 372, -333, -873, -976, -591, 88, 724, 998, 773, 161, -531, -957, -906, -401, 303, 857,
+      982, 616, -57, -703, -996, -792, -192, 503, 948, 918, 430, -273, -841, -987, -640, 26, 680, 994, 811, 222,
+      -477, -938, -930, -458, 242, 823, 992, 664, 5, -657, -991, -829, -252, 449, 926, 941, 486, -212, -805, -995,
+      -688, -36, 632, 986, 846, 283, -420, -914, -951, -512, 182, 786, 997, 710, 67, -608, -980, -863, -313, 391,
+      901, 960, 539, -150, -766, -999, -732
+}};
+
+/// SmpRateConvLinear(4800, 1000)
+const BaselineStream baselineLinear{200, {
+      0, 808, 949, 308, -587, -1000, -587, 308, 949
+}};
+
+template <typename TConv, typename T>
+void RequireSameStream(TConv vectorConv, TConv spanConv, const std::vector<std::vector<T>>& blocks,
+                       const BaselineStream& baseline) {
+  const auto expected = Run(vectorConv, blocks);
+  const auto out = RunSpans(spanConv, blocks, 7);
+  REQUIRE(out.size() == expected.size());
+  REQUIRE(out == expected);
+
+  // the baseline deferred the outputs due after the last sample of a block to the next call,
+  // integer streams now use Q31 arithmetic and may differ by one
+  REQUIRE(expected.size() >= baseline.size);
+  REQUIRE(expected.size() <= baseline.size + 2);
+  for (size_t i = 0; i < baseline.samples.size(); ++i) {
+    REQUIRE(std::abs(expected[i * baselineStride] - baseline.samples[i]) <= 1);
+  }
+}
+
+}   // namespace
+
+TEST_CASE("Span Convert of all converters", "[SmpRateConv]") {
+  const auto blocks = SineBlocks<int>(4800, 10, 96);
+
+  SECTION("FIR") {
+    RequireSameStream(cppsl::math::SmpRateConvFIR<int>(4800, 10000, 64, 16),
+                      cppsl::math::SmpRateConvFIR<int>(4800, 10000, 64, 16), blocks, baselineFir);
+  }
+  SECTION("Polyphase") {
+    RequireSameStream(cppsl::math::SmpRateConvPolyphase<int>(4800, 4000, 64, 16),
+                      cppsl::math::SmpRateConvPolyphase<int>(4800, 4000, 64, 16), blocks, baselinePolyphase);
+  }
+  SECTION("Lagrange") {
+    RequireSameStream(cppsl::math::SmpRateConvLagrange<int>(4800, 10000, 3),
+                      cppsl::math::SmpRateConvLagrange<int>(4800, 10000, 3), blocks, baselineLagrange);
+  }
+  SECTION("Linear") {
+    RequireSameStream(cppsl::math::SmpRateConvLinear<int>(4800, 1000), cppsl::math::SmpRateConvLinear<int>(4800, 1000),
+                      blocks, baselineLinear);
+  }
+}
+
+TEST_CASE("Span Convert stops at the end of the output", "[SmpRateConv]") {
+  cppsl::math::SmpRateConvLagrange<double> conv(1000, 2000, 1);
+  std::vector<double> in(100, 1.0);
+  std::vector<double> out(10);
+  const auto res = conv.Convert(std::span<const double>(in), std::span<double>(out));
+  REQUIRE(res.produced == out.size());
+  REQUIRE(res.consumed < in.size());
+  REQUIRE(conv.maxOutputFor(in.size() - res.consumed) >= 2 * (in.size() - res.consumed));
+}
+
+TEST_CASE("SmpRateConvMultiChannel matches one converter per channel", "[SmpRateConvMultiChannel]") {
+  constexpr size_t channels = 8;
+  std::vector<std::vector<std::vector<double>>> planar;
+  for (size_t c = 0; c < channels; ++c) {
+    auto blocks = SineBlocks<double>(4800, 10, 80);
+    for (auto& block : blocks) {
+      for (auto& v : block) {
+        v = v * (c + 1) / channels;
+      }
+    }
+    planar.push_back(blocks);
+  }
+
+  std::vector<std::vector<double>> expected;
+  for (size_t c = 0; c < channels; ++c) {
+    cppsl::math::SmpRateConvPolyphase<double, double> single(4800, 10000, 64, 16);
+    expected.push_back(Run(single, planar[c]));
+  }
+
+  SECTION("interleaved") {
+    cppsl::math::SmpRateConvMultiChannel<double, double> conv(4800, 10000, 64, 16, channels);
+    REQUIRE(conv.channels() == channels);
+    std::vector<double> out;
+    for (size_t b = 0; b < planar[0].size(); ++b) {
+      std::vector<double> frames;
+      for (size_t i = 0; i < planar[0][b].size(); ++i) {
+        for (size_t c = 0; c < channels; ++c) {
+          frames.push_back(planar[c][b][i]);
+        }
+      }
+      conv.Convert(frames, out);
+    }
+    REQUIRE(out.size() == expected[0].size() * channels);
+    for (size_t i = 0; i < out.size(); ++i) {
+      REQUIRE(out[i] == Approx(expected[i % channels][i / channels]).margin(1e-9));
+    }
+  }
+
+  SECTION("planar") {
+    cppsl::math::SmpRateConvMultiChannel<double, double> conv(4800, 10000, 64, 16, channels);
+    std::vector<std::vector<double>> out(channels, std::vector<double>(2000));
+    std::vector<std::span<double>> outSpans(out.begin(), out.end());
+    size_t produced = 0;
+    for (size_t b = 0; b < planar[0].size(); ++b) {
+      std::vector<std::span<const double>> in;
+      for (size_t c = 0; c < channels; ++c) {
+        in.emplace_back(planar[c][b]);
+      }
+      std::vector<std::span<double>> dest;
+      for (auto& s : outSpans) {
+        dest.push_back(s.subspan(produced));
+      }
+      const auto res = conv.ConvertPlanar(in, dest);
+      REQUIRE(res.consumed == planar[0][b].size());
+      produced += res.produced;
+    }
+    REQUIRE(produced >= expected[0].size());
+    for (size_t c = 0; c < channels; ++c) {
+      for (size_t i = 0; i < expected[c].size(); ++i) {
+        REQUIRE(out[c][i] == Approx(expected[c][i]).margin(1e-9));
+      }
+    }
+
+    // fewer planes than channels
+    std::vector<std::span<const double>> in(channels - 1, std::span<const double>(planar[0][0]));
+    REQUIRE_THROWS_AS(conv.ConvertPlanar(in, outSpans), std::invalid_argument);
+    in.emplace_back(planar[0][0]);
+    REQUIRE_THROWS_AS(conv.ConvertPlanar(in, std::span<const std::span<double>>(outSpans).first(1)),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("SmpRateConvLagrange weight tables match the direct basis", "[SmpRateConvLagrange]") {
+  using cppsl::math::LagrangeWeights;
+  const auto blocks = SineBlocks<double>(4800, 20, 80);
+
+  SECTION("rational phase cycle") {
+    cppsl::math::SmpRateConvLagrange<double> reference(4800, 10000, 7);
+    cppsl::math::SmpRateConvLagrange<double> conv(4800, 10000, 7, LagrangeWeights::table);
+    const auto expected = Run(reference, blocks);
+    const auto out = Run(conv, blocks);
+    REQUIRE(out.size() == expected.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+      REQUIRE(out[i] == Approx(expected[i]).margin(1e-9));
+    }
+  }
+
+  SECTION("Farrow structure") {
+    cppsl::math::SmpRateConvLagrange<double> reference(4800, 4411, 15);
+    cppsl::math::SmpRateConvLagrange<double> conv(4800, 4411, 15, LagrangeWeights::farrow);
+    const auto expected = Run(reference, blocks);
+    const auto out = Run(conv, blocks);
+    REQUIRE(out.size() == expected.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+      REQUIRE(out[i] == Approx(expected[i]).margin(1e-6));
+    }
+  }
+
+  SECTION("quantized phase") {
+    cppsl::math::SmpRateConvLagrange<double> reference(4800, 4411, 3);
+    cppsl::math::SmpRateConvLagrange<double> conv(4800, 4411, 3, LagrangeWeights::table, 256);
+    const auto expected = Run(reference, blocks);
+    const auto out = Run(conv, blocks);
+    REQUIRE(out.size() == expected.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+      // slope 2*pi*50*1000/4800 per sample, phase error 1/512 sample
+      REQUIRE(out[i] == Approx(expected[i]).margin(0.2));
+    }
+  }
+}
+
+template <typename T>
+std::vector<std::vector<double>> ToDouble(const std::vector<std::vector<T>>& blocks) {
+  std::vector<std::vector<double>> res;
+  for (const auto& block : blocks) {
+    res.emplace_back(block.begin(), block.end());
+  }
+  return res;
+}
+
+TEST_CASE("Fixed-point converters follow the double reference", "[SmpRateConvFIR][SmpRateConvLagrange]") {
+  SECTION("FIR Q15") {
+    const auto blocks = SineBlocks<int16_t>(4800, 20, 80, 20000.0);
+    cppsl::math::SmpRateConvFIR<int16_t> conv(4800, 10000, 64, 16);
+    cppsl::math::SmpRateConvFIR<double> reference(4800, 10000, 64, 16);
+    const auto out = Run(conv, blocks);
+    const auto expected = Run(reference, ToDouble(blocks));
+    REQUIRE(out.size() == expected.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+      REQUIRE(out[i] == Approx(expected[i]).margin(8.0));
+    }
+  }
+
+  SECTION("FIR Q31") {
+    const auto blocks = SineBlocks<int32_t>(4800, 20, 80, 1.5e9);
+    cppsl::math::SmpRateConvFIR<int32_t> conv(4800, 1000, 64, 16);
+    cppsl::math::SmpRateConvFIR<double> reference(4800, 1000, 64, 16);
+    const auto out = Run(conv, blocks);
+    const auto expected = Run(reference, ToDouble(blocks));
+    REQUIRE(out.size() == expected.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+      REQUIRE(out[i] == Approx(expected[i]).margin(16.0));
+    }
+  }
+
+  SECTION("Lagrange Q31") {
+    using cppsl::math::LagrangeWeights;
+    const auto blocks = SineBlocks<int32_t>(4000, 20, 80, 1.5e9);
+    for (auto weights : {LagrangeWeights::direct, LagrangeWeights::table, LagrangeWeights::farrow}) {
+      cppsl::math::SmpRateConvLagrange<int32_t> conv(4000, 4800, 5, weights);
+      cppsl::math::SmpRateConvLagrange<double> reference(4000, 4800, 5, weights);
+      const auto out = Run(conv, blocks);
+      const auto expected = Run(reference, ToDouble(blocks));
+      REQUIRE(out.size() == expected.size());
+      for (size_t i = 0; i < out.size(); ++i) {
+        REQUIRE(out[i] == Approx(expected[i]).margin(16.0));
+      }
+    }
+  }
+
+  SECTION("overshoot saturates") {
+    std::vector<int16_t> in(400);
+    for (size_t i = 0; i < in.size(); ++i) {
+      in[i] = (i / 40) % 2 ? std::numeric_limits<int16_t>::lowest() : std::numeric_limits<int16_t>::max();
+    }
+    cppsl::math::SmpRateConvFIR<int16_t> conv(4800, 10000, 64, 16);
+    std::vector<int16_t> out;
+    conv.Convert(in, out);
+    cppsl::math::SmpRateConvFIR<double> reference(4800, 10000, 64, 16);
+    std::vector<double> inDouble(in.begin(), in.end());
+    std::vector<double> expected;
+    reference.Convert(inDouble, expected);
+    REQUIRE(out.size() == expected.size());
+    for (size_t i = 0; i < out.size(); ++i) {
+      // the double reference overshoots the range, the fixed-point path clips
+      const double clipped = std::clamp(expected[i], -32768.0, 32767.0);
+      REQUIRE(out[i] == Approx(clipped).margin(8.0));
+    }
+  }
+}
+
+TEST_CASE("SmpRateConvRational tracks the phase exactly", "[SmpRateConvRational]") {
+  SECTION("matches the polyphase converter with L phases") {
+    for (auto [in, out] : {std::pair{4000, 4800}, std::pair{4800, 1000}, std::pair{4800, 4410}}) {
+      const auto blocks = SineBlocks<double>(in, 20, 77);
+      cppsl::math::SmpRateConvRational<double, double> conv(in, out, 16);
+      const int L = (int)conv.interpolation();
+      REQUIRE((size_t)(in / std::gcd(in, out)) == conv.decimation());
+      cppsl::math::SmpRateConvPolyphase<double, double> reference(in, out, L, 16);
+      const auto expected = Run(reference, blocks);
+      const auto result = Run(conv, blocks);
+      // the floating point clock of the reference may emit one output early at a period end
+      REQUIRE(expected.size() - result.size() <= 1);
+      for (size_t i = 0; i < result.size(); ++i) {
+        REQUIRE(result[i] == Approx(expected[i]).margin(1e-9));
+      }
+    }
+  }
+
+  SECTION("produces exactly L outputs per M inputs") {
+    cppsl::math::SmpRateConvRational<int> conv(4800, 4410, 8);
+    REQUIRE(conv.interpolation() == 147);
+    REQUIRE(conv.decimation() == 160);
+    std::vector<int> in(160 * 25, 1);
+    std::vector<int> out(4000);
+    size_t produced = 0;
+    for (int period = 0; period < 1000; ++period) {
+      // the bound is exact
+      const auto expect = conv.maxOutputFor(in.size());
+      const auto res = conv.Convert(std::span<const int>(in), std::span<int>(out));
+      REQUIRE(res.consumed == in.size());
+      REQUIRE(res.produced == expect);
+      produced += res.produced;
+    }
+    REQUIRE(produced == 147u * 25u * 1000u);
+  }
+
+  SECTION("the output span limits the conversion") {
+    cppsl::math::SmpRateConvRational<double> conv(1000, 3000, 4);
+    std::vector<double> in(100, 1.0);
+    std::vector<double> out(10);
+    const auto res = conv.Convert(std::span<const double>(in), std::span<double>(out));
+    REQUIRE(res.produced == out.size());
+    REQUIRE(res.consumed == 4);
+    REQUIRE(conv.maxOutputFor(in.size() - res.consumed) == 3 * in.size() - out.size());
+  }
+}
+
+namespace {
+
+/// exposes the clamp of the converters
+struct LimitProbe : cppsl::math::SmpRateConvPolyphase<int32_t> {
+  using SmpRateConvPolyphase::Limit;
+};
+
+/// the settled output of a full-scale DC input stays at the positive full scale
+template <typename TConv>
+void RequireFullScale(TConv& conv, size_t channels = 1) {
+  std::vector<int32_t> in(960 * channels, std::numeric_limits<int32_t>::max());
+  std::vector<int32_t> out;
+  for (int i = 0; i < 4; ++i) {
+    conv.Convert(in, out);
+  }
+  REQUIRE(out.size() > 200 * channels);
+  for (size_t i = out.size() - 100 * channels; i < out.size(); ++i) {
+    REQUIRE(out[i] > std::numeric_limits<int32_t>::max() / 100 * 99);
+  }
+}
+
+}   // namespace
+
+TEST_CASE("int32 converters clamp a float accumulator at 2^31", "[SmpRateConv]") {
+  constexpr int32_t max = std::numeric_limits<int32_t>::max();
+  constexpr int32_t min = std::numeric_limits<int32_t>::lowest();
+  REQUIRE(static_cast<float>(max) == 2147483648.0f);
+  REQUIRE(LimitProbe::Limit(2147483648.0f) == max);
+  REQUIRE(LimitProbe::Limit(2147483648.0) == max);
+  REQUIRE(LimitProbe::Limit(2147483647.0) == max);
+  REQUIRE(LimitProbe::Limit(2147483520.0f) == 2147483520);
+  REQUIRE(LimitProbe::Limit(-2147483648.0f) == min);
+  REQUIRE(LimitProbe::Limit(-4294967296.0f) == min);
+
+  SECTION("Polyphase") {
+    cppsl::math::SmpRateConvPolyphase<int32_t> conv(4800, 4000, 64, 16);
+    RequireFullScale(conv);
+  }
+  SECTION("Rational") {
+    cppsl::math::SmpRateConvRational<int32_t> conv(4800, 4410, 16);
+    RequireFullScale(conv);
+  }
+  SECTION("MultiChannel") {
+    cppsl::math::SmpRateConvMultiChannel<int32_t> conv(4800, 4000, 64, 16, 2);
+    RequireFullScale(conv, 2);
+  }
+}
+
+TEST_CASE("statistics computes all moments in one pass", "[functions]") {
+  std::vector<double> data;
+  for (int i = 0; i < 1003; ++i) {
+    data.push_back(1000.0 * std::sin(cppsl::math::DSP_2PI * i / 80.0) + 10.0);
+  }
+  const auto st = cppsl::math::statistics(data);
+  REQUIRE(st.count == data.size());
+  REQUIRE(st.rms == Approx(cppsl::math::rms(data)));
+  REQUIRE(st.peak == Approx(cppsl::math::max(data)));
+  REQUIRE(st.mean == Approx(std::accumulate(data.begin(), data.end(), 0.0) / data.size()));
+  REQUIRE(st.min == *std::min_element(data.begin(), data.end()));
+  REQUIRE(st.max == *std::max_element(data.begin(), data.end()));
+
+  SECTION("float and int32 samples") {
+    std::vector<float> floats(data.begin(), data.end());
+    std::vector<int32_t> ints(data.begin(), data.end());
+    const auto stf = cppsl::math::statistics(floats);
+    REQUIRE(stf.rms == Approx(st.rms).epsilon(1e-6));
+    REQUIRE(stf.min == *std::min_element(floats.begin(), floats.end()));
+    REQUIRE(stf.max == *std::max_element(floats.begin(), floats.end()));
+    const auto sti = cppsl::math::statistics(ints);
+    REQUIRE(sti.rms == Approx(cppsl::math::rms(ints)));
+    REQUIRE(sti.min == *std::min_element(ints.begin(), ints.end()));
+    REQUIRE(sti.peak == cppsl::math::max(ints));
+    REQUIRE(sti.mean == Approx(std::accumulate(ints.begin(), ints.end(), 0.0) / ints.size()));
+  }
+
+  SECTION("complex magnitude") {
+    std::vector<std::complex<double>> phasors;
+    for (int i = 0; i < 101; ++i) {
+      phasors.push_back(std::polar(1.0 + i, 0.1 * i));
+    }
+    const auto sm = cppsl::math::statisticsMagnitude(phasors);
+    REQUIRE(sm.min == Approx(1.0));
+    REQUIRE(sm.max == Approx(101.0));
+    REQUIRE(sm.mean == Approx(51.0));
+    REQUIRE(cppsl::math::statistics(std::vector<double>()).count == 0);
+  }
+
+  SECTION("range overloads") {
+    std::vector<std::complex<double>> values{{1, 0}, {-7, 1}, {3, 0}, {-9, 0}};
+    REQUIRE(cppsl::math::maxReal(values, 0, 3) == 7.0);
+    REQUIRE(cppsl::math::maxReal(values, 0, values.size()) == 9.0);
+    REQUIRE(cppsl::math::rmsReal(values, 1, 3) == Approx(std::sqrt(29.0)));
+    REQUIRE(cppsl::math::rmsReal(values) == Approx(std::sqrt(140.0 / 4)));
+    REQUIRE_THROWS_AS(cppsl::math::rms(data, 10, 10), std::range_error);
+    REQUIRE_THROWS_AS(cppsl::math::rms(data, 0, data.size() + 1), std::range_error);
+  }
+}
+
+TEST_CASE("SlidingRms follows the window", "[functions]") {
+  std::vector<double> data;
+  for (int i = 0; i < 1000; ++i) {
+    data.push_back(1000.0 * std::sin(cppsl::math::DSP_2PI * i / 80.0) + (i > 500 ? 300.0 : 0.0));
+  }
+  cppsl::math::SlidingRms<double> sliding(80);
+  cppsl::math::SlidingRms<int16_t> slidingInt(80);
+  for (size_t i = 0; i < data.size(); ++i) {
+    const double value = sliding.push(data[i]);
+    const double valueInt = slidingInt.push(static_cast<int16_t>(data[i]));
+    const size_t first = i + 1 >= 80 ? i + 1 - 80 : 0;
+    std::vector<double> window(data.begin() + first, data.begin() + i + 1);
+    REQUIRE(value == Approx(cppsl::math::rms(window)));
+    std::vector<int16_t> windowInt(window.begin(), window.end());
+    REQUIRE(valueInt == Approx(cppsl::math::rms(windowInt)));
+  }
+  REQUIRE(sliding.full());
+  sliding.reset();
+  REQUIRE(sliding.size() == 0);
+  REQUIRE(sliding.rms() == 0.0);
+}
+
+TEST_CASE("SlidingDft tracks the harmonic phasors", "[SlidingDft]") {
+  constexpr size_t channels = 3;
+  auto signal = [](size_t c, size_t n) {
+    const double t = cppsl::math::DSP_2PI * (double)n / 80.0;
+    return 100.0 * (c + 1) * std::cos(t + 0.3 * c) + 20.0 * std::cos(3 * t - 0.5) + 5.0 * c;
+  };
+
+  // direct DFT of the last 80 samples referenced to sample index 0
+  auto direct = [&](size_t c, size_t last, unsigned k) {
+    std::complex<double> sum;
+    for (size_t n = last + 1 - 80; n <= last; ++n) {
+      sum += signal(c, n) * std::polar(1.0, -cppsl::math::DSP_2PI * k * (double)(n % 80) / 80.0);
+    }
+    return sum;
+  };
+
+  SECTION("double") {
+    cppsl::math::SlidingDft<80, 1> dft({1, 3, 0}, channels);
+    REQUIRE(dft.Channels() == channels);
+    for (size_t n = 0; n < 1000; ++n) {
+      std::array<double, channels> frame{};
+      for (size_t c = 0; c < channels; ++c) {
+        frame[c] = signal(c, n);
+      }
+      dft.Update(std::span<const double>(frame));
+      REQUIRE(dft.Ready() == (n >= 79));
+      if (n >= 79 && n % 37 == 0) {
+        for (size_t c = 0; c < channels; ++c) {
+          const auto ref = direct(c, n, 1) * cppsl::math::DSP_SQRT2 / 80.0;
+          REQUIRE(std::abs(dft.Phasor(0, c) - ref) < 1e-9);
+        }
+      }
+    }
+    for (size_t c = 0; c < channels; ++c) {
+      const auto fundamental = dft.Phasor(0, c);
+      REQUIRE(std::abs(fundamental) == Approx(100.0 * (c + 1) / cppsl::math::DSP_SQRT2));
+      REQUIRE(std::arg(fundamental) == Approx(0.3 * c).margin(1e-9));
+      REQUIRE(std::abs(dft.Phasor(1, c)) == Approx(20.0 / cppsl::math::DSP_SQRT2));
+      REQUIRE(std::arg(dft.Phasor(1, c)) == Approx(-0.5));
+      REQUIRE(dft.Phasor(2, c).real() == Approx(5.0 * c).margin(1e-9));
+    }
+  }
+
+  SECTION("float over a long stream") {
+    cppsl::math::SlidingDft<80, 2, float> dft({1});
+    for (size_t n = 0; n < 200000; ++n) {
+      dft.Update(static_cast<float>(signal(0, n)));
+    }
+    REQUIRE(std::abs(dft.Phasor(0)) == Approx(100.0 / cppsl::math::DSP_SQRT2).epsilon(1e-5));
+    REQUIRE(std::arg(dft.Phasor(0)) == Approx(0.0).margin(1e-5));
+  }
+
+  SECTION("Goertzel") {
+    std::vector<double> block;
+    for (size_t n = 0; n < 80; ++n) {
+      block.push_back(signal(1, n));
+    }
+    const auto bin = cppsl::math::goertzel(std::span<const double>(block), 3.0);
+    REQUIRE(std::abs(bin - direct(1, 79, 3)) < 1e-9);
+  }
+
+  REQUIRE_THROWS_AS((cppsl::math::SlidingDft<80, 1>({40})), std::invalid_argument);
+
+  cppsl::math::SlidingDft<80, 1> stereo({1}, 2);
+  const double frame[] = {1.0, 2.0};
+  REQUIRE_THROWS_AS(stereo.Update(std::span<const double>(frame, 1)), std::invalid_argument);
+  REQUIRE_THROWS_AS(stereo.Update(1.0), std::invalid_argument);
+  REQUIRE_NOTHROW(stereo.Update(std::span<const double>(frame)));
+}
@@ -0,0 +1,120 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cppsl/container/dequeSafe.hpp"
+#include "cppsl/container/listSafe.hpp"
+#include "cppsl/container/queueLockFree.hpp"
+#include "cppsl/memory/poolAllocator.hpp"
+#include "cppsl/memory/poolFixed.hpp"
+
+// count global heap allocations to check the steady state of the pooled containers
+static std::atomic<size_t> heapAllocations{0};
+
+void* operator new(std::size_t size) {
+  ++heapAllocations;
+  if (void* p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+TEST_CASE("PoolFixed reuses blocks", "[PoolFixed]") {
+  using Pool = cppsl::memory::PoolFixed<64>;
+  Pool::reserve(100);
+  const auto reserved = Pool::reserved();
+  REQUIRE(reserved >= 100);
+
+  std::vector<void*> blocks;
+  for (int i = 0; i < 100; ++i) {
+    blocks.push_back(Pool::allocate());
+  }
+  REQUIRE(std::set<void*>(blocks.begin(), blocks.end()).size() == blocks.size());
+  for (auto* b : blocks) {
+    REQUIRE(reinterpret_cast<std::uintptr_t>(b) % 16 == 0);
+    Pool::deallocate(b);
+  }
+  REQUIRE(Pool::reserved() == reserved);
+}
+
+TEST_CASE("PoolFixed blocks freed by another thread", "[PoolFixed]") {
+  using Pool = cppsl::memory::PoolFixed<32>;
+  std::vector<void*> blocks;
+  for (int i = 0; i < 1000; ++i) {
+    blocks.push_back(Pool::allocate());
+  }
+  std::thread other([&blocks] {
+    for (auto* b : blocks) {
+      Pool::deallocate(b);
+    }
+  });
+  other.join();
+  const auto reserved = Pool::reserved();
+  for (auto& b : blocks) {
+    b = Pool::allocate();
+  }
+  for (auto* b : blocks) {
+    Pool::deallocate(b);
+  }
+  REQUIRE(Pool::reserved() == reserved);
+}
+
+TEST_CASE("PoolAllocator size classes", "[PoolAllocator]") {
+  using cppsl::memory::details::sizeClass;
+  REQUIRE(sizeClass(1) == 0);
+  REQUIRE(sizeClass(16) == 0);
+  REQUIRE(sizeClass(17) == 1);
+  REQUIRE(sizeClass(4096) == cppsl::memory::details::sizeClassCount - 1);
+
+  cppsl::memory::PoolAllocator<std::string> alloc;
+  auto* small = alloc.allocate(2);
+  auto* large = alloc.allocate(1000);
+  alloc.deallocate(small, 2);
+  alloc.deallocate(large, 1000);
+  REQUIRE(alloc == cppsl::memory::PoolAllocator<int>());
+}
+
+TEST_CASE("Pooled containers do not use the heap in steady state", "[PoolAllocator]") {
+  cppsl::container::DequeSafe<int, cppsl::memory::PoolAllocator<int>> deque;
+  cppsl::container::QueueLockFree<int, cppsl::memory::PoolAllocator<int>> queue;
+  cppsl::container::ListSafe<int, cppsl::memory::PoolAllocator<int>> list;
+
+  auto round = [&](int n) {
+    for (int i = 0; i < n; ++i) {
+      deque.push_back(i);
+      queue.push(i);
+      list.push_front(i);
+    }
+    int sum = 0;
+    for (int i = 0; i < n; ++i) {
+      sum += *deque.try_pop_front_value();
+      sum -= *queue.try_pop();
+    }
+    list.remove_if([](int) { return true; });
+    return sum;
+  };
+
+  // warm up the pools and the deque map
+  REQUIRE(round(2000) == 0);
+  const auto before = heapAllocations.load();
+  int sum = 0;
+  for (int i = 0; i < 20; ++i) {
+    sum += round(2000);
+  }
+  const auto after = heapAllocations.load();
+  REQUIRE(sum == 0);
+  REQUIRE(after == before);
+}
@@ -0,0 +1,135 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "cppsl/thread/event.hpp"
+#include "cppsl/thread/latch.hpp"
+#include "cppsl/thread/semaphore.hpp"
+#include "cppsl/thread/workerPool.hpp"
+
+TEST_CASE("WorkerPool runs external tasks", "[WorkerPool]") {
+  cppsl::thread::WorkerPool pool(4, 8);
+  REQUIRE(pool.size() == 4);
+  REQUIRE(pool.current_index() == pool.size());
+
+  std::atomic<int> sum{0};
+  for (int i = 1; i <= 1000; ++i) {
+    pool.submit([&sum, i] { sum += i; });
+  }
+  pool.wait_idle();
+  REQUIRE(sum.load() == 500500);
+}
+
+TEST_CASE("WorkerPool runs nested tasks", "[WorkerPool]") {
+  std::atomic<int> leaves{0};
+  std::atomic<bool> onWorker{true};
+  {
+    cppsl::thread::WorkerPool pool(4);
+    std::function<void(int)> split = [&](int depth) {
+      if (pool.current_index() >= pool.size()) {
+        onWorker = false;
+      }
+      if (depth == 0) {
+        ++leaves;
+        return;
+      }
+      pool.submit([&split, depth] { split(depth - 1); });
+      pool.submit([&split, depth] { split(depth - 1); });
+    };
+    pool.submit([&split] { split(10); });
+    pool.wait_idle();
+    REQUIRE(leaves.load() == 1024);
+
+    // the destructor drains what is still queued
+    for (int i = 0; i < 100; ++i) {
+      pool.submit([&leaves] { ++leaves; });
+    }
+  }
+  REQUIRE(leaves.load() == 1124);
+  REQUIRE(onWorker.load());
+}
+
+TEST_CASE("Event wakes a group and honours stop", "[Event]") {
+  cppsl::thread::Event event;
+  REQUIRE(!event.is_set());
+
+  std::atomic<int> woken{0};
+  std::vector<std::thread> group;
+  for (int i = 0; i < 4; ++i) {
+    group.emplace_back([&] {
+      if (event.wait()) {
+        ++woken;
+      }
+    });
+  }
+  event.set();
+  for (auto& t : group) {
+    t.join();
+  }
+  REQUIRE(woken.load() == 4);
+  REQUIRE(event.wait());
+  REQUIRE(event.wait_and_reset());
+  REQUIRE(!event.is_set());
+
+  bool res = true;
+  std::jthread stopped([&](std::stop_token stoken) { res = event.wait(stoken); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  stopped.request_stop();
+  stopped.join();
+  REQUIRE(!res);
+}
+
+TEST_CASE("Semaphore hands out permits", "[Semaphore]") {
+  cppsl::thread::Semaphore semaphore(1);
+  REQUIRE(semaphore.try_acquire());
+  REQUIRE(!semaphore.try_acquire());
+
+  constexpr int count = 1000;
+  std::atomic<int> acquired{0};
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < 2; ++i) {
+    consumers.emplace_back([&] {
+      for (int n = 0; n < count / 2; ++n) {
+        semaphore.acquire();
+        ++acquired;
+      }
+    });
+  }
+  for (int n = 0; n < count; ++n) {
+    semaphore.release();
+  }
+  for (auto& t : consumers) {
+    t.join();
+  }
+  REQUIRE(acquired.load() == count);
+  REQUIRE(semaphore.available() == 0);
+
+  std::stop_source source;
+  source.request_stop();
+  REQUIRE(!semaphore.acquire(source.get_token()));
+}
+
+TEST_CASE("Latch releases all waiters", "[Latch]") {
+  cppsl::thread::Latch latch(3);
+  REQUIRE(!latch.try_wait());
+
+  std::atomic<int> passed{0};
+  std::vector<std::thread> workers;
+  for (int i = 0; i < 2; ++i) {
+    workers.emplace_back([&] {
+      if (latch.arrive_and_wait()) {
+        ++passed;
+      }
+    });
+  }
+  latch.count_down();
+  for (auto& t : workers) {
+    t.join();
+  }
+  REQUIRE(passed.load() == 2);
+  REQUIRE(latch.try_wait());
+  REQUIRE(latch.wait());
+}
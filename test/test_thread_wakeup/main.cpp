@@ -11,23 +11,12 @@
 // includes
 //-----------------------------------------------------------------------------
 #include <array>
-#include <chrono>
-#include <condition_variable>
 #include <iostream>
-#include <mutex>
 #include <stop_token>
 #include <string>
 #include <thread>
 
-using namespace std::chrono_literals;
-
-//-----------------------------------------------------------------------------
-// local Defines and Macros
-//-----------------------------------------------------------------------------
-struct Event {
-  std::condition_variable event_condition;
-  std::mutex event_mutex;
-};
+#include <cppsl/thread/event.hpp>
 
 /**
 * @brief   initializes and run stuff.
@@ -37,7 +26,8 @@ int main(int argc, char** argv) {
   // configuration
   std::stop_source stop_src;   // Create a stop source
   std::array<std::thread, 16> task_workers;
-  std::array<Event, 16> task_events;
+  cppsl::thread::Event start_event;   // one event wakes the whole group
+  cppsl::thread::Event idle_event;    // never set, workers park on it until stopped
 
   //----------------------------------------------------------
   // go to idle in main
@@ -50,37 +40,21 @@ int main(int argc, char** argv) {
        [&](int number, std::stop_token token) {
          std::cout << "Task " << std::to_string(number) << std::endl;
 
-         // Register a stop callback
-         std::stop_callback stop_cb(token, [&]() {
-           // Wake thread on stop request
-           task_events[number].event_condition.notify_all();
-         });
+         if (start_event.wait(token)) {
+           std::cout << "Task " << std::to_string(number) << " started" << std::endl;
+         }
 
-         while (true) {
-           {
-             // Start of locked block
-             std::unique_lock lck(task_events[number].event_mutex);
-             task_events[number].event_condition.wait_for(lck, 2s);
-           }
-           // Stop if requested to stop
-           if (token.stop_requested()) {
-             break;
-           }
-         }   // End of while loop
+         // the wait returns false when the stop is requested
+         idle_event.wait(token);
        },
        i, stop_src.get_token()));
-
-    std::this_thread::sleep_for(10ms);
   }
 
-  // set token to stop all worker
-  stop_src.request_stop();
+  // wakeup all tasks in one call
+  start_event.set();
 
-  // wakeup all tasks
-  for (uint i = 0; i < task_events.size(); ++i) {
-    std::unique_lock lck(task_events[i].event_mutex);
-    task_events[i].event_condition.notify_all();
-  }
+  // set token to stop all worker, wakes the parked ones
+  stop_src.request_stop();
 
   for (uint i = 0; i < task_workers.size(); ++i) {
     // Join threads
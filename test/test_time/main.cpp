@@ -0,0 +1,367 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <ctime>
+#include <random>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "cppsl/time/functions.hpp"
+#include "cppsl/time/latency.hpp"
+#include "cppsl/time/timerWheel.hpp"
+
+using namespace cppsl::time;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Wheel = TimerWheel<std::chrono::milliseconds>;
+
+/// advances a manually driven wheel to a tick
+size_t advanceTo(Wheel& wheel, uint64_t tick) {
+  return wheel.Advance(wheel.Origin() + tick * wheel.Tick());
+}
+
+/// central European time with daylight saving, needs no time zone database
+void useBerlinTime() {
+  setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+  tzset();
+}
+
+std::string format6(std::chrono::system_clock::time_point tp) {
+  char buffer[timestampBufferSize];
+  return {buffer, formatTimestamp<6>(buffer, tp)};
+}
+
+}   // namespace
+
+TEST_CASE("TimerWheel fires timers on their tick", "[TimerWheel]") {
+  Wheel wheel(1ms, false);
+  std::vector<int> fired;
+
+  wheel.Start(5ms, [&fired](TimerId) { fired.push_back(5); });
+  wheel.Start(300ms, [&fired](TimerId) { fired.push_back(300); });
+  wheel.Start(70000ms, [&fired](TimerId) { fired.push_back(70000); });
+
+  REQUIRE(advanceTo(wheel, 5) == 0);
+  REQUIRE(advanceTo(wheel, 6) == 1);
+  REQUIRE(fired == std::vector<int>{5});
+
+  REQUIRE(advanceTo(wheel, 300) == 0);
+  REQUIRE(advanceTo(wheel, 301) == 1);
+  REQUIRE(advanceTo(wheel, 70000) == 0);
+  REQUIRE(advanceTo(wheel, 70001) == 1);
+  REQUIRE(fired == std::vector<int>{5, 300, 70000});
+}
+
+TEST_CASE("TimerWheel cancels and restarts timers", "[TimerWheel]") {
+  Wheel wheel(1ms, false);
+  int fired = 0;
+
+  const auto a = wheel.Start(10ms, [&fired](TimerId) { ++fired; });
+  const auto b = wheel.Start(10ms, [&fired](TimerId) { ++fired; });
+  REQUIRE(wheel.IsActive(a));
+
+  REQUIRE(wheel.Cancel(a));
+  REQUIRE_FALSE(wheel.IsActive(a));
+  REQUIRE_FALSE(wheel.Cancel(a));
+
+  advanceTo(wheel, 5);
+  REQUIRE(wheel.Restart(b, 10ms));
+  REQUIRE(advanceTo(wheel, 15) == 0);
+  REQUIRE(advanceTo(wheel, 16) == 1);
+  REQUIRE(fired == 1);
+
+  SECTION("ids of freed timers stay invalid when the slot is reused") {
+    const auto c = wheel.Start(1ms, [](TimerId) {});
+    REQUIRE(c.index == b.index);
+    REQUIRE_FALSE(wheel.Restart(b, 1ms));
+    REQUIRE(wheel.IsActive(c));
+  }
+}
+
+TEST_CASE("TimerWheel skips timers cancelled or restarted by a callback of the same tick", "[TimerWheel]") {
+  Wheel wheel(1ms, false);
+  std::vector<int> fired;
+  TimerId a;
+  TimerId b;
+  bool cancelled = false;
+
+  SECTION("cancel") {
+    // whichever callback runs first cancels the other one
+    a = wheel.Start(5ms, [&](TimerId) {
+      fired.push_back(1);
+      cancelled = wheel.Cancel(b);
+    });
+    b = wheel.Start(5ms, [&](TimerId) {
+      fired.push_back(2);
+      cancelled = wheel.Cancel(a);
+    });
+    REQUIRE(advanceTo(wheel, 6) == 1);
+    REQUIRE(cancelled);
+    REQUIRE(fired.size() == 1);
+    REQUIRE(advanceTo(wheel, 100) == 0);
+    REQUIRE(fired.size() == 1);
+  }
+
+  SECTION("restart") {
+    a = wheel.Start(5ms, [&](TimerId) {
+      fired.push_back(1);
+      wheel.Restart(b, 10ms);
+    });
+    b = wheel.Start(5ms, [&](TimerId) {
+      fired.push_back(2);
+      wheel.Restart(a, 10ms);
+    });
+    REQUIRE(advanceTo(wheel, 6) == 1);
+    REQUIRE(fired.size() == 1);
+    // the restarted timer fires once on its new expiry and restarts the other one
+    REQUIRE(advanceTo(wheel, 16) == 0);
+    REQUIRE(advanceTo(wheel, 17) == 1);
+    REQUIRE(fired.size() == 2);
+    REQUIRE(fired[0] != fired[1]);
+  }
+}
+
+TEST_CASE("TimerWheel re-arms periodic timers and callbacks restart themselves", "[TimerWheel]") {
+  Wheel wheel(1ms, false);
+  uint64_t tick = 0;
+  std::vector<uint64_t> periodic;
+  std::vector<uint64_t> backoff;
+  std::chrono::milliseconds next = 2ms;
+
+  wheel.Start(
+     10ms, [&](TimerId) { periodic.push_back(tick); }, 10ms);
+  wheel.Start(2ms, [&](TimerId id) {
+    backoff.push_back(tick);
+    next *= 2;
+    wheel.Restart(id, next);
+  });
+
+  for (tick = 1; tick <= 100; ++tick) {
+    advanceTo(wheel, tick);
+  }
+  REQUIRE(periodic == std::vector<uint64_t>{11, 21, 31, 41, 51, 61, 71, 81, 91});
+  // doubling timeouts, each restart is one tick later than its timeout
+  REQUIRE(backoff == std::vector<uint64_t>{3, 8, 17, 34, 67});
+}
+
+TEST_CASE("TimerWheel fires cascaded timers on the wheel boundary", "[TimerWheel]") {
+  Wheel wheel(1ms, false);
+  uint64_t tick = 0;
+  std::vector<uint64_t> fired;
+
+  for (const auto timeout : {255ms, 511ms, 65535ms}) {
+    wheel.Start(timeout, [&](TimerId) { fired.push_back(tick); });
+  }
+  for (tick = 1; tick <= 65537; ++tick) {
+    advanceTo(wheel, tick);
+  }
+  REQUIRE(fired == std::vector<uint64_t>{256, 512, 65536});
+}
+
+TEST_CASE("TimerWheel queues timers without callback", "[TimerWheel]") {
+  Wheel wheel(1ms, false);
+  const auto a = wheel.Start(1ms);
+  const auto b = wheel.Start(2ms);
+
+  REQUIRE_FALSE(wheel.PopExpired());
+  advanceTo(wheel, 10);
+  REQUIRE(wheel.PopExpired() == a);
+  REQUIRE(wheel.PopExpired() == b);
+  REQUIRE_FALSE(wheel.PopExpired());
+
+  // expired timers stay restartable until released
+  REQUIRE(wheel.Restart(a, 1ms));
+  advanceTo(wheel, 20);
+  REQUIRE(wheel.PopExpired() == a);
+  wheel.Release(a);
+  REQUIRE_FALSE(wheel.Restart(a, 1ms));
+
+  // cancelling an expired timer frees it but reports that it was not active
+  REQUIRE_FALSE(wheel.Cancel(b));
+  REQUIRE_FALSE(wheel.Restart(b, 1ms));
+}
+
+TEST_CASE("TimerWheel thread serves many timers", "[TimerWheel]") {
+  constexpr int timers = 2000;
+  std::atomic<int> fired{0};
+  std::atomic<int> early{0};
+  {
+    Wheel wheel(1ms);
+    const auto start = Wheel::Clock::now();
+    for (int i = 0; i < timers; ++i) {
+      const auto timeout = std::chrono::milliseconds(1 + i % 50);
+      wheel.Start(timeout, [&fired, &early, start, timeout](TimerId) {
+        if (Wheel::Clock::now() - start < timeout) {
+          ++early;
+        }
+        ++fired;
+      });
+    }
+
+    StopTimerMs stop(20ms);
+    std::atomic<bool> stopped{false};
+    wheel.Start(stop, [&stopped](TimerId) { stopped = true; });
+
+    const auto deadline = start + 5s;
+    while ((fired < timers || !stopped) && Wheel::Clock::now() < deadline) {
+      std::this_thread::sleep_for(1ms);
+    }
+    REQUIRE(stopped);
+    REQUIRE(stop.IsElapsed().value_or(false));
+  }
+  REQUIRE(fired == timers);
+  REQUIRE(early == 0);
+}
+
+TEST_CASE("LatencyHistogram buckets are log-linear", "[LatencyHistogram]") {
+  for (uint64_t v : {0ull, 1ull, 31ull, 32ull, 33ull, 1000ull, 123456789ull, ~0ull}) {
+    const auto index = LatencyHistogram::IndexOf(v);
+    REQUIRE(index < LatencyHistogram::bucketCount);
+    REQUIRE(LatencyHistogram::ValueOf(index) >= v);
+    REQUIRE(LatencyHistogram::ValueOf(index) - v <= v / LatencyHistogram::subBuckets);
+  }
+  REQUIRE(LatencyHistogram::IndexOf(64) == LatencyHistogram::IndexOf(65));
+  REQUIRE(LatencyHistogram::IndexOf(65) != LatencyHistogram::IndexOf(66));
+}
+
+TEST_CASE("LatencyHistogram exports percentiles", "[LatencyHistogram]") {
+  LatencyHistogram histogram;
+  REQUIRE(histogram.Summary().count == 0);
+  REQUIRE(histogram.Percentile(50.0) == 0);
+
+  for (uint64_t v = 1; v <= 1000; ++v) {
+    histogram.Record(v * 1000);
+  }
+  const auto summary = histogram.Summary();
+  REQUIRE(summary.count == 1000);
+  REQUIRE(summary.min == 1000);
+  REQUIRE(summary.max == 1000000);
+  REQUIRE(summary.p50 >= 500000);
+  REQUIRE(summary.p50 <= 500000 * 33 / 32);
+  REQUIRE(summary.p99 >= 990000);
+  REQUIRE(summary.p999 >= 999000);
+  REQUIRE(summary.p999 <= summary.max);
+  REQUIRE(summary.mean == Approx(500500.0));
+  REQUIRE(summary.ToString().rfind("count=1000 min=1000ns", 0) == 0);
+}
+
+TEST_CASE("LatencyRecorder merges the histograms of all threads", "[LatencyRecorder]") {
+  constexpr int threads = 4;
+  constexpr int perThread = 10000;
+  LatencyRecorder recorder;
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([&recorder, t] {
+      for (int i = 0; i < perThread; ++i) {
+        recorder.Record(static_cast<uint64_t>((t + 1) * 100));
+      }
+    });
+  }
+  // snapshots while recording see a consistent prefix
+  while (recorder.Snapshot().Count() < threads * perThread) {
+    REQUIRE(recorder.Snapshot().Max() <= threads * 100);
+    std::this_thread::yield();
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+
+  const auto summary = recorder.Summary();
+  REQUIRE(summary.count == threads * perThread);
+  REQUIRE(summary.min == 100);
+  REQUIRE(summary.max == threads * 100);
+
+  recorder.Reset();
+  REQUIRE(recorder.Summary().count == 0);
+}
+
+TEST_CASE("LatencyRecorder reuses the ids of destroyed recorders", "[LatencyRecorder]") {
+  for (int i = 0; i < 1000; ++i) {
+    // a recorder with a reused id never writes into the histogram of its predecessor
+    LatencyRecorder recorder;
+    recorder.Record(static_cast<uint64_t>(i + 1));
+    recorder.Local().Record(static_cast<uint64_t>(i + 1));
+    const auto summary = recorder.Summary();
+    REQUIRE(summary.count == 2);
+    REQUIRE(summary.max == static_cast<uint64_t>(i + 1));
+  }
+}
+
+TEST_CASE("ScopedLatency records the scope", "[ScopedLatency]") {
+  LatencyRecorder steady;
+  LatencyRecorder cycles;
+  CycleClockSource::Calibrate();
+  for (int i = 0; i < 10; ++i) {
+    ScopedLatency<> a(steady);
+    ScopedLatency<CycleClockSource> b(cycles);
+    std::this_thread::sleep_for(1ms);
+  }
+  for (const auto& summary : {steady.Summary(), cycles.Summary()}) {
+    REQUIRE(summary.count == 10);
+    REQUIRE(summary.min >= 900000);
+    REQUIRE(summary.max < 1000000000);
+  }
+}
+
+TEST_CASE("formatTimestamp writes the layout of toString", "[timestamp]") {
+  using std::chrono::system_clock;
+  useBerlinTime();
+
+  // 2017-05-01 00:10:15.25 CEST, 2017-01-01 00:00:00 CET, 1969-12-31 19:00:00.5 CET
+  for (const int64_t ms : {1493590215250ll, 1483225200000ll, -18000000ll + 500, 0ll}) {
+    const system_clock::time_point tp{std::chrono::milliseconds(ms)};
+    REQUIRE(format6(tp) == toString<double, 6>(tp));
+  }
+  REQUIRE(format6(system_clock::time_point{std::chrono::milliseconds(1493590215250ll)}) ==
+          "2017-May-01 00:10:15.250000");
+
+  char buffer[timestampBufferSize];
+  const system_clock::time_point tp{std::chrono::nanoseconds(1493590215123456789ll)};
+  REQUIRE(std::string(buffer, formatTimestamp<0>(buffer, tp)) == "2017-May-01 00:10:15");
+  REQUIRE(std::string(buffer, formatTimestamp<9>(buffer, tp)) == "2017-May-01 00:10:15.123456789");
+
+  std::string out = "at ";
+  appendTimestamp<3>(out, tp);
+  REQUIRE(out == "at 2017-May-01 00:10:15.123");
+}
+
+TEST_CASE("parseTimestamp reads what formatTimestamp writes", "[timestamp]") {
+  using std::chrono::system_clock;
+  using Micro = std::chrono::time_point<system_clock, std::chrono::microseconds>;
+  useBerlinTime();
+
+  std::mt19937_64 random(7);
+  // 2000 to 2040, across daylight saving changes
+  std::uniform_int_distribution<int64_t> range(946684800000000ll, 2208988800000000ll);
+  for (int i = 0; i < 10000; ++i) {
+    const Micro tp{std::chrono::microseconds(range(random))};
+    const auto text = format6(tp);
+    const auto parsed = parseTimestamp<Micro>(text);
+    REQUIRE(parsed.has_value());
+    if (*parsed != tp) {
+      // the hour repeated at the end of daylight saving time is ambiguous
+      REQUIRE(std::chrono::abs(*parsed - tp) == std::chrono::hours(1));
+    }
+  }
+
+  REQUIRE(parseTimestamp<Micro>("2017-may-01 00:10:15.25") ==
+          Micro{std::chrono::microseconds(1493590215250000ll)});
+  REQUIRE(parseTimestamp<Micro>("2017-Mar-01") == Micro{std::chrono::seconds(1488322800)});
+  REQUIRE(parseTimestamp<Micro>("2017-Mar-1 1:2:3") == Micro{std::chrono::seconds(1488322800 + 3723)});
+  REQUIRE(parseTimestamp<system_clock::time_point>("2017-May-01 00:10:15.1234567891") ==
+          system_clock::time_point{std::chrono::nanoseconds(1493590215123456789ll)});
+}
+
+TEST_CASE("parseTimestamp rejects malformed text", "[timestamp]") {
+  using std::chrono::system_clock;
+  for (const char* text : {"", "not a date", "2018", "2017-Foo-01", "2017-Feb-29", "2017-May-01 24:00:00",
+                           "2017-May-01 00:10", "2017-May-01 00:10:15.", "2017-May-01 00:10:15x",
+                           "2017-May-01T00:10:15"}) {
+    REQUIRE_FALSE(parseTimestamp<system_clock::time_point>(text).has_value());
+  }
+}
@@ -0,0 +1,96 @@
+//
+// Copyright (c) 2024 Alexander Sacharov <a.sacharov@gmx.de>
+//               All rights reserved.
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+//
+
+/*************************************************************************/ /**
+ * @file
+ * \brief   renders binary trace log files as text.
+ * \details Usage: traceDecode [--steady] file...
+ * The files of a run are given oldest first, e.g. trace.log.3 trace.log.2
+ * trace.log.1 trace.log. Every event is printed as UTC time, or as steady
+ * clock in ns with --steady, followed by the rendered message.
+ * \author  Alexander Sacharov
+ * \date    2024-06-17
+ * \ingroup
+ *****************************************************************************/
+
+//-----------------------------------------------------------------------------
+// includes <...>
+//-----------------------------------------------------------------------------
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <cppsl/log/traceLog.hpp>
+
+using namespace cppsl::log;
+
+namespace {
+
+/// prints the event with its wall clock time
+void printTime(const TraceEvent& event) {
+  const auto since = event.time.time_since_epoch();
+  const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(since);
+  const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(since - seconds).count();
+  const std::time_t t = seconds.count();
+  std::tm tm{};
+  gmtime_r(&t, &tm);
+  fmt::print("{:04}-{:02}-{:02} {:02}:{:02}:{:02}.{:06} {}\n", tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+             tm.tm_hour, tm.tm_min, tm.tm_sec, micros, event.text);
+}
+
+}   // namespace
+
+int main(int argc, char* argv[]) {
+  bool steady = false;
+  std::vector<const char*> files;
+  for (int i = 1; i < argc; ++i) {
+    if (std::string_view(argv[i]) == "--steady") {
+      steady = true;
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+  if (files.empty()) {
+    fmt::print(stderr, "usage: {} [--steady] file...\n", argv[0]);
+    return 2;
+  }
+
+  TraceReader reader;
+  int result = 0;
+  for (const auto* file : files) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+      fmt::print(stderr, "cannot open {}\n", file);
+      result = 1;
+      continue;
+    }
+    const std::vector<char> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const auto bytes = std::as_bytes(std::span(content));
+    const auto used = reader.decode(bytes, [steady](const TraceEvent& event) {
+      if (steady) {
+        fmt::print("{} {}\n", event.steady, event.text);
+      } else {
+        printTime(event);
+      }
+    });
+    if (used < bytes.size() && std::to_integer<int>(bytes[used]) != 0) {
+      fmt::print(stderr, "{}: undecodable data at offset {}\n", file, used);
+      result = 1;
+    }
+  }
+  if (reader.errors() != 0) {
+    fmt::print(stderr, "{} malformed records or events with unknown format\n", reader.errors());
+    result = 1;
+  }
+  return result;
+}